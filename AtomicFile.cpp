@@ -0,0 +1,71 @@
+#include "AtomicFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include "Utf8.h"
+#endif
+
+#ifdef _WIN32
+
+bool AtomicFile::Write(const std::wstring& path, const void* data, size_t size) {
+    std::wstring tempPath = path + L".tmp";
+
+    HANDLE file = CreateFileW(tempPath.c_str(), GENERIC_WRITE, 0, nullptr,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    const char* bytes = (const char*)data;
+    bool ok = true;
+    while (ok && size > 0) {
+        DWORD chunk = size > 0x40000000 ? 0x40000000 : (DWORD)size;
+        DWORD written = 0;
+        ok = WriteFile(file, bytes, chunk, &written, nullptr) && written > 0;
+        bytes += written;
+        size -= written;
+    }
+
+    // Le contenu doit être sur disque avant que le renommage ne soit visible
+    ok = ok && FlushFileBuffers(file);
+    CloseHandle(file);
+
+    if (ok) {
+        ok = MoveFileExW(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+    }
+    if (!ok) DeleteFileW(tempPath.c_str());
+    return ok;
+}
+
+#else
+
+bool AtomicFile::Write(const std::wstring& path, const void* data, size_t size) {
+    std::string target = Utf8::FromWide(path);
+    std::string tempPath = target + ".tmp";
+
+    int fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+
+    const char* bytes = (const char*)data;
+    bool ok = true;
+    while (ok && size > 0) {
+        ssize_t written = write(fd, bytes, size);
+        ok = written > 0;
+        if (ok) {
+            bytes += written;
+            size -= (size_t)written;
+        }
+    }
+
+    // Le contenu doit être sur disque avant que le renommage ne soit visible
+    ok = ok && fsync(fd) == 0;
+    close(fd);
+
+    if (ok) ok = rename(tempPath.c_str(), target.c_str()) == 0;
+    if (!ok) unlink(tempPath.c_str());
+    return ok;
+}
+
+#endif
@@ -0,0 +1,14 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// Remplacement atomique d'un fichier : écriture dans path + ".tmp", vidage
+// sur disque, puis renommage par-dessus l'original. Un arrêt brutal laisse
+// soit l'ancien fichier complet, soit le nouveau.
+class AtomicFile {
+public:
+    static bool Write(const std::wstring& path, const void* data, size_t size);
+    static bool Write(const std::wstring& path, const std::string& data) {
+        return Write(path, data.data(), data.size());
+    }
+};
@@ -0,0 +1,20 @@
+#include "CancellationToken.h"
+
+CancellationToken::CancellationToken()
+    : m_cancelled(false)
+{
+}
+
+void CancellationToken::Cancel() {
+    {
+        // Le verrou évite de perdre le réveil d'un thread entre son test et son wait
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cancelled.store(true, std::memory_order_release);
+    }
+    m_wake.notify_all();
+}
+
+bool CancellationToken::WaitUntil(Clock::time_point deadline) const {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_wake.wait_until(lock, deadline, [this]() { return IsCancelled(); });
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+// Jeton d'annulation coopérative.
+// Cancel() réveille immédiatement toute attente en cours sur le jeton.
+class CancellationToken {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    CancellationToken();
+
+    CancellationToken(const CancellationToken&) = delete;
+    CancellationToken& operator=(const CancellationToken&) = delete;
+
+    void Cancel();
+    bool IsCancelled() const { return m_cancelled.load(std::memory_order_acquire); }
+
+    // Attendre jusqu'à l'échéance ; retourne true si le jeton a été annulé entre-temps
+    bool WaitUntil(Clock::time_point deadline) const;
+
+private:
+    std::atomic<bool> m_cancelled;
+    mutable std::mutex m_mutex;
+    mutable std::condition_variable m_wake;
+};
@@ -0,0 +1,199 @@
+#include "DirtyTiles.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TILES_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Mots de 4 octets par ligne de tuile
+const int LANES = DirtyTiles::TileSize / 4;
+
+// Multiplicateur impair (bijectif modulo 2^32) et repli FNV-1a 64 bits
+const uint32_t MIX = 0x9E3779B1u;
+const uint64_t FOLD_BASIS = 0xCBF29CE484222325ULL;
+const uint64_t FOLD_PRIME = 0x100000001B3ULL;
+
+void MixScalar(const uint8_t* row, int tiles, uint32_t* lanes) {
+    for (int i = 0; i < tiles * LANES; i++) {
+        uint32_t word;
+        std::memcpy(&word, row + 4 * i, 4);
+        lanes[i] = (lanes[i] ^ word) * MIX;
+    }
+}
+
+// Tuile incomplète du bord droit : complétée par des zéros
+void MixPartial(const uint8_t* row, int count, uint32_t* lanes) {
+    uint8_t padded[DirtyTiles::TileSize] = {};
+    std::memcpy(padded, row, (size_t)count);
+    MixScalar(padded, 1, lanes);
+}
+
+uint64_t Fold(const uint32_t* lanes) {
+    uint64_t hash = FOLD_BASIS;
+    for (int l = 0; l < LANES; l++) hash = (hash ^ lanes[l]) * FOLD_PRIME;
+    return hash;
+}
+
+#ifdef TILES_X86
+
+// Produit 32 x 32 bits (bits bas) sans SSE4.1 : voies paires et impaires séparément
+__attribute__((target("sse2")))
+inline __m128i MulLo32Sse2(__m128i a, __m128i b) {
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+__attribute__((target("sse2")))
+void MixSse2(const uint8_t* row, int tiles, uint32_t* lanes) {
+    const __m128i mix = _mm_set1_epi32((int)MIX);
+    for (int i = 0; i < tiles * LANES; i += 4) {
+        __m128i words = _mm_loadu_si128((const __m128i*)(row + 4 * i));
+        __m128i state = _mm_loadu_si128((const __m128i*)(lanes + i));
+        _mm_storeu_si128((__m128i*)(lanes + i), MulLo32Sse2(_mm_xor_si128(state, words), mix));
+    }
+}
+
+__attribute__((target("avx2")))
+void MixAvx2(const uint8_t* row, int tiles, uint32_t* lanes) {
+    const __m256i mix = _mm256_set1_epi32((int)MIX);
+    for (int i = 0; i < tiles * LANES; i += 8) {
+        __m256i words = _mm256_loadu_si256((const __m256i*)(row + 4 * i));
+        __m256i state = _mm256_loadu_si256((const __m256i*)(lanes + i));
+        _mm256_storeu_si256((__m256i*)(lanes + i), _mm256_mullo_epi32(_mm256_xor_si256(state, words), mix));
+    }
+}
+
+#endif
+
+} // namespace
+
+const int DirtyTiles::TileSize;
+
+DirtyTiles::DirtyTiles()
+    : m_kernel(TemplateMatcher::BestKernel())
+    , m_mix(MixFor(m_kernel))
+    , m_width(0)
+    , m_height(0)
+    , m_columns(0)
+    , m_rows(0)
+    , m_valid(false)
+    , m_changedCount(0)
+{
+}
+
+DirtyTiles::MixFunction DirtyTiles::MixFor(TemplateMatcher::Kernel kernel) {
+    switch (kernel) {
+#ifdef TILES_X86
+        case TemplateMatcher::Kernel::Sse2: return MixSse2;
+        case TemplateMatcher::Kernel::Avx2: return MixAvx2;
+#endif
+        default: return MixScalar;
+    }
+}
+
+bool DirtyTiles::SetKernel(TemplateMatcher::Kernel kernel) {
+    if (!TemplateMatcher::IsSupported(kernel)) return false;
+    m_kernel = kernel;
+    m_mix = MixFor(kernel);
+    return true;
+}
+
+void DirtyTiles::Reset() {
+    m_valid = false;
+}
+
+size_t DirtyTiles::Update(const GrayImage& image) {
+    const bool sameSize = m_valid && image.width == m_width && image.height == m_height;
+    if (!sameSize) {
+        m_width = std::max(image.width, 0);
+        m_height = std::max(image.height, 0);
+        m_columns = (m_width + TileSize - 1) / TileSize;
+        m_rows = (m_height + TileSize - 1) / TileSize;
+        m_hashes.assign(TileCount(), 0);
+        m_changed.assign(TileCount(), 1);
+        m_changedSums.assign((size_t)(m_rows + 1) * (m_columns + 1), 0);
+        m_lanes.assign((size_t)m_columns * LANES, 0);
+    }
+
+    const int fullTiles = m_width / TileSize;
+    const int rest = m_width - fullTiles * TileSize;
+    m_changedCount = 0;
+    for (int row = 0; row < m_rows; row++) {
+        std::fill(m_lanes.begin(), m_lanes.end(), 0);
+        const int last = std::min((row + 1) * TileSize, m_height);
+        for (int y = row * TileSize; y < last; y++) {
+            const uint8_t* pixels = image.Row(y);
+            m_mix(pixels, fullTiles, m_lanes.data());
+            if (rest > 0) MixPartial(pixels + fullTiles * TileSize, rest, &m_lanes[(size_t)fullTiles * LANES]);
+        }
+
+        uint32_t rowChanged = 0;
+        for (int column = 0; column < m_columns; column++) {
+            const size_t index = (size_t)row * m_columns + column;
+            const uint64_t hash = Fold(&m_lanes[(size_t)column * LANES]);
+            const bool changed = !sameSize || hash != m_hashes[index];
+            m_hashes[index] = hash;
+            m_changed[index] = changed ? 1 : 0;
+            m_changedCount += changed ? 1 : 0;
+
+            // Somme des tuiles modifiées au-dessus et à gauche (coin exclu)
+            rowChanged += changed ? 1 : 0;
+            const size_t stride = (size_t)m_columns + 1;
+            m_changedSums[(row + 1) * stride + column + 1] = m_changedSums[row * stride + column + 1] + rowChanged;
+        }
+    }
+    m_valid = true;
+    return m_changedCount;
+}
+
+bool DirtyTiles::AnyChanged(int x, int y, int w, int h) const {
+    if (!m_valid) return true;
+
+    const int c0 = std::max(x, 0) / TileSize;
+    const int r0 = std::max(y, 0) / TileSize;
+    const int c1 = std::min((std::min(x + w, m_width) + TileSize - 1) / TileSize, m_columns);
+    const int r1 = std::min((std::min(y + h, m_height) + TileSize - 1) / TileSize, m_rows);
+    if (c0 >= c1 || r0 >= r1) return false;
+
+    const size_t stride = (size_t)m_columns + 1;
+    return m_changedSums[r1 * stride + c1] - m_changedSums[r0 * stride + c1] -
+           m_changedSums[r1 * stride + c0] + m_changedSums[r0 * stride + c0] != 0;
+}
+
+void DirtyTiles::ChangedRects(std::vector<MatchRect>& rects) const {
+    rects.clear();
+    for (int row = 0; row < m_rows; row++) {
+        const size_t rowStart = rects.size();
+        const int y = row * TileSize;
+        const int height = std::min(y + TileSize, m_height) - y;
+
+        for (int column = 0; column < m_columns;) {
+            if (!m_changed[(size_t)row * m_columns + column]) {
+                column++;
+                continue;
+            }
+            int end = column;
+            while (end < m_columns && m_changed[(size_t)row * m_columns + end]) end++;
+
+            const int x = column * TileSize;
+            const int width = std::min(end * TileSize, m_width) - x;
+            bool extended = false;
+            // Seuls les rectangles finissant à cette rangée peuvent se prolonger
+            for (size_t i = 0; i < rowStart; i++) {
+                if (rects[i].x == x && rects[i].width == width && rects[i].y + rects[i].height == y) {
+                    rects[i].height += height;
+                    extended = true;
+                    break;
+                }
+            }
+            if (!extended) rects.push_back(MatchRect{ x, y, width, height });
+            column = end;
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "GrayImage.h"
+#include "TemplateMatcher.h"
+
+// Tuiles modifiées d'une capture à la suivante. L'image est découpée en tuiles
+// de TileSize x TileSize pixels (moins sur les bords droit et bas), chacune
+// résumée par une empreinte de 64 bits comparée à celle de l'image précédente.
+//
+// Empreinte : pour chaque mot de 4 octets d'une ligne de tuile, h = (h ^ mot) x K
+// sur 32 bits, ligne après ligne, puis les 8 valeurs sont repliées sur 64 bits.
+// Chaque étape est bijective : une tuile dont une seule ligne a changé change
+// toujours d'empreinte. Les lignes sont traitées pour toute une rangée de tuiles
+// à la fois (SSE2 ou AVX2 selon le processeur), avec les mêmes résultats que le
+// code scalaire.
+class DirtyTiles {
+public:
+    static const int TileSize = 32;
+
+    DirtyTiles();
+
+    // Pour les mesures ; false (et noyau inchangé) si non pris en charge
+    bool SetKernel(TemplateMatcher::Kernel kernel);
+    TemplateMatcher::Kernel GetKernel() const { return m_kernel; }
+
+    // Empreintes de image comparées à celles de l'image précédente. Toutes les
+    // tuiles sont modifiées à la première image, après Reset() ou si la taille
+    // change. Retourne le nombre de tuiles modifiées.
+    size_t Update(const GrayImage& image);
+    void Reset();
+
+    int Columns() const { return m_columns; }
+    int Rows() const { return m_rows; }
+    size_t TileCount() const { return (size_t)m_columns * (size_t)m_rows; }
+    size_t ChangedCount() const { return m_changedCount; }
+
+    // Au moins une tuile modifiée sous les pixels [x, x + w) x [y, y + h)
+    bool AnyChanged(int x, int y, int w, int h) const;
+
+    // Rectangles de pixels couvrant exactement les tuiles modifiées : suites de
+    // tuiles d'une rangée, prolongées sur les rangées suivantes identiques
+    void ChangedRects(std::vector<MatchRect>& rects) const;
+
+private:
+    typedef void (*MixFunction)(const uint8_t* row, int tiles, uint32_t* lanes);
+
+    static MixFunction MixFor(TemplateMatcher::Kernel kernel);
+
+    TemplateMatcher::Kernel m_kernel;
+    MixFunction m_mix;
+
+    int m_width;
+    int m_height;
+    int m_columns;
+    int m_rows;
+    bool m_valid;                           // m_hashes décrit l'image précédente
+
+    std::vector<uint64_t> m_hashes;         // Par tuile, rangée après rangée
+    std::vector<uint8_t> m_changed;
+    std::vector<uint32_t> m_changedSums;    // Tables de sommes de m_changed ((rangées + 1) x (colonnes + 1))
+    std::vector<uint32_t> m_lanes;          // Empreintes partielles d'une rangée, 8 par tuile
+    size_t m_changedCount;
+};
@@ -0,0 +1,101 @@
+#include "EvdevKeySource.h"
+#include "LinuxKeyMap.h"
+#include <fcntl.h>
+#include <linux/input.h>
+#include <poll.h>
+#include <unistd.h>
+
+EvdevKeySource::EvdevKeySource(const std::string& devicePath)
+    : m_devicePath(devicePath)
+    , m_fd(-1)
+{
+    m_wakeFd[0] = m_wakeFd[1] = -1;
+}
+
+EvdevKeySource::~EvdevKeySource() {
+    Stop();
+}
+
+bool EvdevKeySource::Start(Callback callback) {
+    if (m_thread.joinable()) return false;
+
+    m_fd = open(m_devicePath.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (m_fd < 0) return false;
+    if (pipe(m_wakeFd) != 0) {
+        close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+
+    m_callback = std::move(callback);
+    m_down.reset();
+    m_thread = std::thread(&EvdevKeySource::ReadThread, this);
+    return true;
+}
+
+void EvdevKeySource::Stop() {
+    if (!m_thread.joinable()) return;
+
+    char wake = 1;
+    ssize_t written = write(m_wakeFd[1], &wake, 1);
+    (void)written;
+    m_thread.join();
+
+    close(m_fd);
+    close(m_wakeFd[0]);
+    close(m_wakeFd[1]);
+    m_fd = -1;
+    m_wakeFd[0] = m_wakeFd[1] = -1;
+}
+
+void EvdevKeySource::ReadThread() {
+    struct pollfd fds[2];
+    fds[0].fd = m_fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = m_wakeFd[0];
+    fds[1].events = POLLIN;
+
+    struct input_event events[64];
+    while (true) {
+        if (poll(fds, 2, -1) < 0) continue;             // EINTR
+        if (fds[1].revents & POLLIN) break;             // Stop()
+        if (fds[0].revents & (POLLERR | POLLHUP)) break; // Périphérique débranché
+
+        ssize_t bytes = read(m_fd, events, sizeof(events));
+        if (bytes <= 0) continue;
+
+        size_t count = (size_t)bytes / sizeof(events[0]);
+        for (size_t i = 0; i < count; i++) {
+            // value : 0 relâchement, 1 appui, 2 auto-répétition (ignorée)
+            const struct input_event& e = events[i];
+            if (e.type != EV_KEY || e.value == 2) continue;
+
+            bool down = (e.value == 1);
+            uint16_t vk = LinuxKeyMap::FromLinux(e.code);
+            if (vk == 0) continue;
+            Emit(vk, down);
+
+            // Les hotkeys utilisent les codes génériques (SHIFT, CTRL, ALT)
+            switch (vk) {
+                case 0xA0: case 0xA1: Emit(0x10, down); break;  // VK_LSHIFT/VK_RSHIFT -> VK_SHIFT
+                case 0xA2: case 0xA3: Emit(0x11, down); break;  // VK_LCONTROL/VK_RCONTROL -> VK_CONTROL
+                case 0xA4: case 0xA5: Emit(0x12, down); break;  // VK_LMENU/VK_RMENU -> VK_MENU
+            }
+        }
+    }
+}
+
+void EvdevKeySource::Emit(uint16_t vk, bool down) {
+    if (vk >= m_down.size()) return;
+
+    // Ne remonter que les changements d'état
+    if (m_down.test(vk) == down) return;
+    m_down.set(vk, down);
+
+    if (m_callback) {
+        KeyEdge edge;
+        edge.vk = vk;
+        edge.down = down;
+        m_callback(edge);
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "KeyEventSource.h"
+#include <bitset>
+#include <string>
+#include <thread>
+
+// Source basée sur un périphérique evdev (/dev/input/eventN), sous Linux.
+// Le thread de lecture dort dans poll() : aucun travail tant qu'aucune touche
+// ne change d'état. Seuls les fronts sont remontés (pas l'auto-répétition) ;
+// nos propres entrées partent par un autre périphérique (uinput) et ne sont
+// donc jamais relues. Demande un accès en lecture au périphérique.
+class EvdevKeySource : public KeyEventSource {
+public:
+    explicit EvdevKeySource(const std::string& devicePath);
+    ~EvdevKeySource();
+
+    bool Start(Callback callback) override;
+    void Stop() override;
+
+private:
+    void ReadThread();
+    void Emit(uint16_t vk, bool down);
+
+    std::string m_devicePath;
+    Callback m_callback;
+    std::thread m_thread;
+    int m_fd;
+    int m_wakeFd[2];            // Tube de réveil pour Stop()
+    std::bitset<256> m_down;    // Accédé uniquement depuis le thread de lecture
+};
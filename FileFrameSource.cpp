@@ -0,0 +1,33 @@
+#include "FileFrameSource.h"
+#include "ImageFile.h"
+#include <algorithm>
+
+FileFrameSource::FileFrameSource()
+    : m_next(0)
+{
+}
+
+bool FileFrameSource::Open(const std::vector<std::wstring>& paths, std::wstring* failedPath) {
+    m_frames.clear();
+    m_next = 0;
+
+    std::vector<GrayImage> frames(paths.size());
+    for (size_t i = 0; i < paths.size(); i++) {
+        if (!ImageFile::LoadGray(paths[i], frames[i])) {
+            if (failedPath) *failedPath = paths[i];
+            return false;
+        }
+    }
+    m_frames.swap(frames);
+    return !m_frames.empty();
+}
+
+bool FileFrameSource::Capture(GrayImage& frame) {
+    if (m_frames.empty()) return false;
+
+    const GrayImage& source = m_frames[m_next];
+    m_next = (m_next + 1) % m_frames.size();
+    frame.Resize(source.width, source.height);
+    std::copy(source.pixels.begin(), source.pixels.end(), frame.pixels.begin());
+    return true;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "FrameSource.h"
+
+// Images lues depuis des fichiers (formats d'ImageFile), rendues tour à tour
+// puis en boucle : un écran enregistré tient lieu de bureau, sur toutes les
+// plateformes. Les fichiers sont décodés une fois, à Open().
+class FileFrameSource : public FrameSource {
+public:
+    FileFrameSource();
+
+    // false (et source vide) si l'un des fichiers est illisible ; failedPath le désigne
+    bool Open(const std::vector<std::wstring>& paths, std::wstring* failedPath = nullptr);
+
+    size_t FrameCount() const { return m_frames.size(); }
+
+    // Image suivante (la première après la dernière) ; false si aucune
+    bool Capture(GrayImage& frame) override;
+
+private:
+    std::vector<GrayImage> m_frames;
+    size_t m_next;
+};
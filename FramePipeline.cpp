@@ -0,0 +1,114 @@
+#include "FramePipeline.h"
+
+namespace {
+
+// Source indisponible (écran verrouillé...) : nouvel essai après ce délai
+const int RETRY_MS = 250;
+
+} // namespace
+
+FramePipeline::FramePipeline()
+    : m_source(nullptr)
+    , m_intervalMs(0)
+    , m_running(false)
+    , m_captured(0)
+    , m_failed(0)
+    , m_skipped(0)
+    , m_processed(0)
+{
+}
+
+FramePipeline::~FramePipeline() {
+    Stop();
+}
+
+bool FramePipeline::Start(FrameSource& source, int intervalMs, FrameCallback onFrame) {
+    if (m_running || !onFrame) return false;
+
+    m_source = &source;
+    m_intervalMs = intervalMs > 0 ? intervalMs : 0;
+    m_onFrame = std::move(onFrame);
+    m_stop.reset(new CancellationToken());
+    m_running = true;
+    m_processThread = std::thread(&FramePipeline::ProcessLoop, this);
+    m_captureThread = std::thread(&FramePipeline::CaptureLoop, this);
+    return true;
+}
+
+void FramePipeline::Stop() {
+    if (!m_running) return;
+
+    m_stop->Cancel();
+    m_captureThread.join();
+
+    // Plus aucune publication : un dernier réveil pour que la recherche voie l'arrêt
+    m_frameReady.Post();
+    m_processThread.join();
+
+    // Image publiée juste avant l'arrêt et jamais prise : elle ne doit pas être
+    // cherchée au prochain Start(), l'écran a changé depuis. Son réveil part avec.
+    if (m_frames.Update()) m_skipped++;
+    while (m_frameReady.TryWait()) {}
+
+    m_running = false;
+    m_onFrame = nullptr;
+}
+
+FramePipeline::Stats FramePipeline::GetStats() const {
+    Stats stats;
+    stats.captured = m_captured.load(std::memory_order_relaxed);
+    stats.failed = m_failed.load(std::memory_order_relaxed);
+    stats.skipped = m_skipped.load(std::memory_order_relaxed);
+    stats.processed = m_processed.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void FramePipeline::CaptureLoop() {
+    uint64_t sequence = 0;
+    Clock::time_point next = Clock::now();
+
+    while (!m_stop->IsCancelled()) {
+        CapturedFrame& frame = m_frames.Back();
+        bool captured = m_source->Capture(frame.image);
+        if (captured) {
+            frame.sequence = ++sequence;
+            frame.capturedAt = Clock::now();
+            m_captured++;
+
+            // Une image déjà en attente a son réveil : seul le passage à
+            // "disponible" en demande un
+            if (m_frames.Publish()) {
+                m_skipped++;
+            } else {
+                m_frameReady.Post();
+            }
+        } else {
+            m_failed++;
+        }
+
+        if (!captured) {
+            if (m_stop->WaitUntil(Clock::now() + std::chrono::milliseconds(RETRY_MS))) break;
+            next = Clock::now();
+        } else if (m_intervalMs > 0) {
+            next += std::chrono::milliseconds(m_intervalMs);
+            // En retard (capture lente) : repartir de maintenant plutôt qu'enchaîner
+            Clock::time_point now = Clock::now();
+            if (next < now) next = now;
+            if (m_stop->WaitUntil(next)) break;
+        }
+    }
+}
+
+void FramePipeline::ProcessLoop() {
+    while (true) {
+        m_frameReady.Wait();
+        if (m_stop->IsCancelled()) break;
+        if (!m_frames.Update()) continue; // Par sécurité : chaque réveil suit une publication
+
+        const CapturedFrame& frame = m_frames.Front();
+        m_frameAge.Record(std::chrono::duration_cast<std::chrono::microseconds>(
+            Clock::now() - frame.capturedAt).count());
+        m_onFrame(frame);
+        m_processed++;
+    }
+}
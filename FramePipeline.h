@@ -0,0 +1,81 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include "CancellationToken.h"
+#include "FrameSource.h"
+#include "GrayImage.h"
+#include "PreciseTimer.h"
+#include "Semaphore.h"
+#include "TripleBuffer.h"
+
+// Image capturée, passée de la capture à la recherche
+struct CapturedFrame {
+    GrayImage image;
+    uint64_t sequence;                              // Numéro de capture, à partir de 1
+    std::chrono::steady_clock::time_point capturedAt;
+};
+
+// Capture et recherche sur deux threads, reliés par un TripleBuffer.
+// Le thread de capture remplit l'image libre et la publie sans jamais attendre
+// la recherche ; le thread de recherche prend toujours la plus récente, celles
+// remplacées entre-temps sont sautées. Les trois images sont réutilisées d'une
+// capture à l'autre : rien n'est alloué par image tant que la taille de l'écran
+// ne change pas.
+class FramePipeline {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    // Appelé sur le thread de recherche ; l'image reste valide jusqu'au retour
+    typedef std::function<void(const CapturedFrame&)> FrameCallback;
+
+    struct Stats {
+        uint64_t captured;      // Images publiées
+        uint64_t failed;        // Captures en échec (source indisponible)
+        uint64_t skipped;       // Remplacées avant d'être prises par la recherche
+        uint64_t processed;     // Passées au callback
+    };
+
+    FramePipeline();
+    ~FramePipeline();
+
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+
+    // intervalMs : période de capture (0 = aussi vite que la source le permet).
+    // La source doit rester valide jusqu'à Stop().
+    bool Start(FrameSource& source, int intervalMs, FrameCallback onFrame);
+    void Stop();    // Attend la fin du callback en cours
+
+    bool IsRunning() const { return m_running; }
+
+    Stats GetStats() const;
+
+    // Âge de l'image au début du callback (capture -> recherche), en µs
+    TimingStats::Report GetFrameAgeReport() const { return m_frameAge.GetReport(); }
+
+private:
+    void CaptureLoop();
+    void ProcessLoop();
+
+    FrameSource* m_source;
+    int m_intervalMs;
+    FrameCallback m_onFrame;
+    bool m_running;
+
+    TripleBuffer<CapturedFrame> m_frames;
+    Semaphore m_frameReady;                         // Une fois par image devenue disponible
+    std::unique_ptr<CancellationToken> m_stop;      // Neuf à chaque Start()
+
+    std::atomic<uint64_t> m_captured;
+    std::atomic<uint64_t> m_failed;
+    std::atomic<uint64_t> m_skipped;
+    std::atomic<uint64_t> m_processed;
+    TimingStats m_frameAge;
+
+    std::thread m_captureThread;
+    std::thread m_processThread;
+};
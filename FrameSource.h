@@ -0,0 +1,14 @@
+#pragma once
+#include "GrayImage.h"
+
+// Source d'images pour la détection : écran, fichiers, écran synthétique.
+// Capture() réécrit frame en place : son tampon est réutilisé d'une image à
+// l'autre et rien n'est alloué tant que la taille ne change pas.
+// Appelée par un seul thread à la fois (celui de la capture).
+class FrameSource {
+public:
+    virtual ~FrameSource() {}
+
+    // false si aucune image n'est disponible (écran verrouillé, fichier illisible...)
+    virtual bool Capture(GrayImage& frame) = 0;
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Image en niveaux de gris, un octet par pixel, lignes contiguës (pas = largeur).
+// Format de travail de la détection d'image : captures d'écran et modèles.
+struct GrayImage {
+    int width;
+    int height;
+    std::vector<uint8_t> pixels;
+
+    GrayImage() : width(0), height(0) {}
+
+    // Redimensionner sans effacer : le contenu est entièrement réécrit ensuite
+    void Resize(int w, int h) {
+        width = w;
+        height = h;
+        pixels.resize((size_t)w * (size_t)h);
+    }
+
+    bool IsEmpty() const { return width <= 0 || height <= 0; }
+
+    uint8_t* Row(int y) { return pixels.data() + (size_t)y * (size_t)width; }
+    const uint8_t* Row(int y) const { return pixels.data() + (size_t)y * (size_t)width; }
+
+    // Luminance (BT.601, entiers) d'un pixel RVB
+    static uint8_t Luma(uint8_t r, uint8_t g, uint8_t b) {
+        return (uint8_t)((r * 77 + g * 150 + b * 29 + 128) >> 8);
+    }
+};
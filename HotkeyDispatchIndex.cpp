@@ -0,0 +1,69 @@
+#include "HotkeyDispatchIndex.h"
+#include "MacroStore.h"
+#include <cstring>
+
+HotkeyDispatchIndex::HotkeyDispatchIndex() {
+    Clear();
+}
+
+void HotkeyDispatchIndex::Clear() {
+    std::memset(m_offsets, 0, sizeof(m_offsets));
+    m_bindings.clear();
+}
+
+void HotkeyDispatchIndex::Build(const MacroStore& store) {
+    Clear();
+
+    // Seuls les tableaux chauds du store sont parcourus : hotkeys déjà résolus
+    const uint8_t* flags = store.FlagsData();
+    const uint16_t* keys = store.TriggerVkData();
+    const MacroKind kinds[] = { MacroKind::Basic, MacroKind::Combo };
+    uint32_t counts[KeyCount] = {};
+
+    for (MacroKind kind : kinds) {
+        uint32_t first = store.FirstRow(kind);
+        uint32_t last = first + (uint32_t)store.Count(kind);
+        for (uint32_t row = first; row < last; row++) {
+            if (!(flags[row] & MacroStore::FLAG_ENABLED)) continue;
+            if (keys[row] == 0 || keys[row] >= KeyCount) continue;
+            counts[keys[row]]++;
+        }
+    }
+
+    // Offsets cumulés puis placement des liaisons
+    for (int vk = 0; vk < KeyCount; vk++) {
+        m_offsets[vk + 1] = m_offsets[vk] + counts[vk];
+    }
+    m_bindings.resize(m_offsets[KeyCount]);
+
+    uint32_t next[KeyCount];
+    std::memcpy(next, m_offsets, sizeof(next));
+
+    for (MacroKind kind : kinds) {
+        uint32_t first = store.FirstRow(kind);
+        uint32_t last = first + (uint32_t)store.Count(kind);
+        for (uint32_t row = first; row < last; row++) {
+            if (!(flags[row] & MacroStore::FLAG_ENABLED)) continue;
+            if (keys[row] == 0 || keys[row] >= KeyCount) continue;
+            HotkeyBinding& b = m_bindings[next[keys[row]]++];
+            b.macroId = store.IdData()[row];
+            b.holdMode = kind == MacroKind::Basic && (flags[row] & MacroStore::FLAG_HOLD_MODE) != 0;
+        }
+    }
+}
+
+const HotkeyBinding* HotkeyDispatchIndex::Find(uint16_t vk, size_t& count) const {
+    if (vk >= KeyCount) {
+        count = 0;
+        return nullptr;
+    }
+    count = m_offsets[vk + 1] - m_offsets[vk];
+    return count ? &m_bindings[m_offsets[vk]] : nullptr;
+}
+
+bool KeyStateTable::ApplyEdge(const KeyEdge& edge) {
+    if (edge.vk >= HotkeyDispatchIndex::KeyCount) return false;
+    if (m_keyDown.test(edge.vk) == edge.down) return false;
+    m_keyDown.set(edge.vk, edge.down);
+    return true;
+}
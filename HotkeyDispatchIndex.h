@@ -0,0 +1,51 @@
+#pragma once
+#include <bitset>
+#include <cstdint>
+#include <vector>
+#include "KeyEventSource.h"
+#include "MacroManager.h"
+
+class MacroStore;
+
+// Liaison hotkey -> macro
+struct HotkeyBinding {
+    MacroId macroId;
+    bool holdMode;
+};
+
+// Index de dispatch, construit avec chaque MacroStore puis jamais modifié.
+// Tableau plat indexé par virtual key : les liaisons d'une touche sont
+// contiguës (offsets de type CSR), la recherche est O(1) quel que soit
+// le nombre de macros chargées.
+class HotkeyDispatchIndex {
+public:
+    static const int KeyCount = 256;
+
+    HotkeyDispatchIndex();
+
+    // Reconstruire à partir des macros activées
+    void Build(const MacroStore& store);
+    void Clear();
+
+    // Liaisons de la touche vk (count = 0 si aucune)
+    const HotkeyBinding* Find(uint16_t vk, size_t& count) const;
+
+    size_t BindingCount() const { return m_bindings.size(); }
+
+private:
+    uint32_t m_offsets[KeyCount + 1];       // Liaisons de vk : [m_offsets[vk], m_offsets[vk + 1])
+    std::vector<HotkeyBinding> m_bindings;
+};
+
+// État des touches vu par le thread des hooks ; indépendant de l'index,
+// il survit à la publication de nouvelles macros
+class KeyStateTable {
+public:
+    // Mettre à jour l'état de la touche ; retourne false si le front ne change rien
+    bool ApplyEdge(const KeyEdge& edge);
+    bool IsDown(uint16_t vk) const { return vk < HotkeyDispatchIndex::KeyCount && m_keyDown.test(vk); }
+    void Reset() { m_keyDown.reset(); }
+
+private:
+    std::bitset<HotkeyDispatchIndex::KeyCount> m_keyDown;
+};
@@ -15,16 +15,20 @@ public:
     // Dsenregistrer un hotkey
     void UnregisterHotkey(int id);
 
+    // Aligner les hotkeys enregistrs sur ceux voulus (identifiant -> virtual key) :
+    // seuls les hotkeys retirs ou modifis sont dsenregistrs/renregistrs
+    void SyncHotkeys(const std::map<int, UINT>& wanted);
+
+    // Dsenregistrer tous les hotkeys
+    void UnregisterAll();
+
     // Vrifier si une touche est presse/maintenue
     bool IsKeyPressed(const std::wstring& key);
     bool IsKeyHeld(const std::wstring& key);
 
-    // Convertir une string en virtual key code
-    int GetVirtualKeyCode(const std::wstring& key);
+    // Convertir une string en virtual key code (voir KeyTable)
+    static int GetVirtualKeyCode(const std::wstring& key);
 
 private:
     std::map<int, UINT> m_registeredHotkeys;
-    std::map<std::wstring, int> m_keyMapping;
-
-    void InitializeKeyMapping();
 };
@@ -0,0 +1,486 @@
+#include "ImageFile.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Côté maximal accepté : borne les allocations d'un fichier corrompu
+const int MAX_DIMENSION = 16384;
+
+uint32_t ReadBE32(const unsigned char* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+uint32_t ReadLE32(const unsigned char* p) {
+    return p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+uint16_t ReadLE16(const unsigned char* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+// Décompression d'un flux zlib (RFC 1950/1951), celui des blocs IDAT d'un PNG.
+// Décodage de Huffman canonique bit à bit : les modèles sont petits, la
+// simplicité prime sur le débit.
+class Inflater {
+public:
+    Inflater(const unsigned char* data, size_t size, size_t limit, std::vector<unsigned char>& out)
+        : m_data(data), m_size(size), m_limit(limit), m_pos(0), m_bitBuffer(0), m_bitCount(0),
+          m_error(false), m_out(out) {}
+
+    bool Run() {
+        if (m_size < 2) return false;
+        unsigned cmf = m_data[0];
+        unsigned flg = m_data[1];
+        if ((cmf & 0x0F) != 8 || (cmf * 256 + flg) % 31 != 0 || (flg & 0x20)) return false;
+        m_pos = 2;
+
+        bool last;
+        do {
+            last = Bits(1) != 0;
+            int type = Bits(2);
+            bool ok;
+            switch (type) {
+                case 0: ok = Stored(); break;
+                case 1: ok = Fixed(); break;
+                case 2: ok = Dynamic(); break;
+                default: ok = false; break;
+            }
+            if (!ok || m_error) return false;
+        } while (!last);
+        return true;
+    }
+
+private:
+    struct Huffman {
+        uint16_t counts[16];    // Nombre de codes par longueur
+        uint16_t symbols[288];  // Symboles dans l'ordre des codes
+    };
+
+    int Bits(int n) {
+        while (m_bitCount < n) {
+            if (m_pos >= m_size) {
+                m_error = true;
+                return 0;
+            }
+            m_bitBuffer |= (uint32_t)m_data[m_pos++] << m_bitCount;
+            m_bitCount += 8;
+        }
+        int value = (int)(m_bitBuffer & ((1u << n) - 1));
+        m_bitBuffer >>= n;
+        m_bitCount -= n;
+        return value;
+    }
+
+    static bool Build(Huffman& h, const uint8_t* lengths, int n) {
+        memset(h.counts, 0, sizeof(h.counts));
+        for (int s = 0; s < n; s++) h.counts[lengths[s]]++;
+
+        // Code sur-souscrit : flux invalide
+        int left = 1;
+        for (int len = 1; len < 16; len++) {
+            left <<= 1;
+            left -= h.counts[len];
+            if (left < 0) return false;
+        }
+
+        uint16_t offsets[16];
+        offsets[1] = 0;
+        for (int len = 1; len < 15; len++) offsets[len + 1] = offsets[len] + h.counts[len];
+        for (int s = 0; s < n; s++) {
+            if (lengths[s] != 0) h.symbols[offsets[lengths[s]]++] = (uint16_t)s;
+        }
+        return true;
+    }
+
+    int Decode(const Huffman& h) {
+        int code = 0;
+        int first = 0;
+        int index = 0;
+        for (int len = 1; len < 16; len++) {
+            code |= Bits(1);
+            int count = h.counts[len];
+            if (code - count < first) return h.symbols[index + (code - first)];
+            index += count;
+            first = (first + count) << 1;
+            code <<= 1;
+        }
+        return -1;
+    }
+
+    bool Stored() {
+        m_bitBuffer = 0;
+        m_bitCount = 0;
+        if (m_pos + 4 > m_size) return false;
+        unsigned len = m_data[m_pos] | (m_data[m_pos + 1] << 8);
+        unsigned nlen = m_data[m_pos + 2] | (m_data[m_pos + 3] << 8);
+        m_pos += 4;
+        if (len != (~nlen & 0xFFFF) || m_pos + len > m_size || m_out.size() + len > m_limit) return false;
+        m_out.insert(m_out.end(), m_data + m_pos, m_data + m_pos + len);
+        m_pos += len;
+        return true;
+    }
+
+    bool Codes(const Huffman& literals, const Huffman& distances) {
+        static const uint16_t LENGTH_BASE[29] = {
+            3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+            35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+        static const uint8_t LENGTH_EXTRA[29] = {
+            0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+        static const uint16_t DISTANCE_BASE[30] = {
+            1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+            257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+        static const uint8_t DISTANCE_EXTRA[30] = {
+            0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+        for (;;) {
+            int symbol = Decode(literals);
+            if (symbol < 0 || m_error) return false;
+            if (symbol < 256) {
+                if (m_out.size() >= m_limit) return false;
+                m_out.push_back((unsigned char)symbol);
+            } else if (symbol == 256) {
+                return true;
+            } else {
+                symbol -= 257;
+                if (symbol >= 29) return false;
+                size_t length = LENGTH_BASE[symbol] + Bits(LENGTH_EXTRA[symbol]);
+                int d = Decode(distances);
+                if (d < 0 || d >= 30) return false;
+                size_t distance = DISTANCE_BASE[d] + Bits(DISTANCE_EXTRA[d]);
+                if (m_error || distance > m_out.size() || m_out.size() + length > m_limit) return false;
+
+                // Copie octet par octet : la source peut chevaucher la destination
+                size_t from = m_out.size() - distance;
+                for (size_t i = 0; i < length; i++) {
+                    unsigned char byte = m_out[from + i];
+                    m_out.push_back(byte);
+                }
+            }
+        }
+    }
+
+    bool Fixed() {
+        uint8_t lengths[288 + 30];
+        int s = 0;
+        for (; s < 144; s++) lengths[s] = 8;
+        for (; s < 256; s++) lengths[s] = 9;
+        for (; s < 280; s++) lengths[s] = 7;
+        for (; s < 288; s++) lengths[s] = 8;
+        for (; s < 288 + 30; s++) lengths[s] = 5;
+
+        Huffman literals, distances;
+        Build(literals, lengths, 288);
+        Build(distances, lengths + 288, 30);
+        return Codes(literals, distances);
+    }
+
+    bool Dynamic() {
+        static const uint8_t ORDER[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+        int literalCount = Bits(5) + 257;
+        int distanceCount = Bits(5) + 1;
+        int codeCount = Bits(4) + 4;
+        if (literalCount > 286 || distanceCount > 30 || m_error) return false;
+
+        uint8_t lengths[320];
+        memset(lengths, 0, sizeof(lengths));
+        for (int i = 0; i < codeCount; i++) lengths[ORDER[i]] = (uint8_t)Bits(3);
+
+        Huffman lengthCodes;
+        if (!Build(lengthCodes, lengths, 19)) return false;
+
+        int index = 0;
+        int total = literalCount + distanceCount;
+        while (index < total) {
+            int symbol = Decode(lengthCodes);
+            if (symbol < 0 || m_error) return false;
+            if (symbol < 16) {
+                lengths[index++] = (uint8_t)symbol;
+                continue;
+            }
+
+            uint8_t value = 0;
+            int repeat;
+            if (symbol == 16) {
+                if (index == 0) return false;
+                value = lengths[index - 1];
+                repeat = 3 + Bits(2);
+            } else if (symbol == 17) {
+                repeat = 3 + Bits(3);
+            } else {
+                repeat = 11 + Bits(7);
+            }
+            if (index + repeat > total) return false;
+            while (repeat--) lengths[index++] = value;
+        }
+        if (lengths[256] == 0) return false;    // Pas de code de fin de bloc
+
+        Huffman literals, distances;
+        if (!Build(literals, lengths, literalCount)) return false;
+        if (!Build(distances, lengths + literalCount, distanceCount)) return false;
+        return Codes(literals, distances);
+    }
+
+    const unsigned char* m_data;
+    size_t m_size;
+    size_t m_limit;
+    size_t m_pos;
+    uint32_t m_bitBuffer;
+    int m_bitCount;
+    bool m_error;
+    std::vector<unsigned char>& m_out;
+};
+
+uint8_t Paeth(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = abs(p - a);
+    int pb = abs(p - b);
+    int pc = abs(p - c);
+    if (pa <= pb && pa <= pc) return (uint8_t)a;
+    if (pb <= pc) return (uint8_t)b;
+    return (uint8_t)c;
+}
+
+// Entier décimal d'un en-tête PNM (espaces et commentaires ignorés)
+bool ReadPnmValue(const unsigned char* data, size_t size, size_t& pos, unsigned& value) {
+    for (;;) {
+        while (pos < size && (data[pos] == ' ' || data[pos] == '\t' || data[pos] == '\r' || data[pos] == '\n')) pos++;
+        if (pos < size && data[pos] == '#') {
+            while (pos < size && data[pos] != '\n') pos++;
+            continue;
+        }
+        break;
+    }
+    if (pos >= size || data[pos] < '0' || data[pos] > '9') return false;
+    value = 0;
+    while (pos < size && data[pos] >= '0' && data[pos] <= '9') {
+        value = value * 10 + (data[pos++] - '0');
+        if (value > 1000000) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool ImageFile::LoadGray(const std::wstring& path, GrayImage& image) {
+    MappedFile file;
+    if (!file.Open(path)) return false;
+    return DecodeGray(file.Data(), file.Size(), image);
+}
+
+bool ImageFile::DecodeGray(const unsigned char* data, size_t size, GrayImage& image) {
+    static const unsigned char PNG_SIGNATURE[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+
+    if (size >= 8 && memcmp(data, PNG_SIGNATURE, 8) == 0) return DecodePng(data, size, image);
+    if (size >= 2 && data[0] == 'B' && data[1] == 'M') return DecodeBmp(data, size, image);
+    if (size >= 2 && data[0] == 'P' && (data[1] == '5' || data[1] == '6')) return DecodePnm(data, size, image);
+    return false;
+}
+
+bool ImageFile::DecodePng(const unsigned char* data, size_t size, GrayImage& image) {
+    uint32_t width = 0, height = 0;
+    int depth = 0, colorType = -1, interlace = 0;
+    std::vector<uint8_t> palette;              // Luminance de chaque entrée
+    std::vector<unsigned char> compressed;
+
+    size_t pos = 8;
+    bool ended = false;
+    while (!ended) {
+        if (pos + 12 > size) return false;
+        uint32_t length = ReadBE32(data + pos);
+        const unsigned char* type = data + pos + 4;
+        const unsigned char* body = data + pos + 8;
+        if (length > size - pos - 12) return false;
+
+        if (memcmp(type, "IHDR", 4) == 0) {
+            if (length < 13) return false;
+            width = ReadBE32(body);
+            height = ReadBE32(body + 4);
+            depth = body[8];
+            colorType = body[9];
+            if (body[10] != 0 || body[11] != 0) return false;
+            interlace = body[12];
+        } else if (memcmp(type, "PLTE", 4) == 0) {
+            for (uint32_t i = 0; i + 2 < length; i += 3) {
+                palette.push_back(GrayImage::Luma(body[i], body[i + 1], body[i + 2]));
+            }
+        } else if (memcmp(type, "IDAT", 4) == 0) {
+            compressed.insert(compressed.end(), body, body + length);
+        } else if (memcmp(type, "IEND", 4) == 0) {
+            ended = true;
+        }
+        pos += 12 + (size_t)length;
+    }
+
+    if (width == 0 || height == 0 || width > (uint32_t)MAX_DIMENSION || height > (uint32_t)MAX_DIMENSION) return false;
+    if (interlace != 0) return false;
+
+    int channels;
+    switch (colorType) {
+        case 0: channels = 1; break;    // Gris
+        case 2: channels = 3; break;    // RVB
+        case 3: channels = 1; break;    // Palette
+        case 4: channels = 2; break;    // Gris + alpha
+        case 6: channels = 4; break;    // RVBA
+        default: return false;
+    }
+    bool depthValid = depth == 8 || depth == 16 ||
+                      ((colorType == 0 || colorType == 3) && (depth == 1 || depth == 2 || depth == 4));
+    if (!depthValid || (colorType == 3 && (depth == 16 || palette.empty()))) return false;
+
+    const size_t bitsPerPixel = (size_t)channels * depth;
+    const size_t rowBytes = (width * bitsPerPixel + 7) / 8;
+    const size_t filterStep = bitsPerPixel >= 8 ? bitsPerPixel / 8 : 1;
+    const size_t expected = (size_t)height * (rowBytes + 1);
+
+    std::vector<unsigned char> raw;
+    raw.reserve(expected);
+    Inflater inflater(compressed.data(), compressed.size(), expected, raw);
+    if (!inflater.Run() || raw.size() < expected) return false;
+
+    image.Resize((int)width, (int)height);
+    std::vector<unsigned char> zeroRow(rowBytes, 0);
+    const unsigned char* previous = zeroRow.data();
+
+    for (uint32_t y = 0; y < height; y++) {
+        unsigned char* row = raw.data() + (size_t)y * (rowBytes + 1);
+        int filter = row[0];
+        unsigned char* current = row + 1;
+
+        // Filtres par ligne (a : pixel de gauche, b : au-dessus, c : en haut à gauche)
+        for (size_t i = 0; i < rowBytes; i++) {
+            int a = i >= filterStep ? current[i - filterStep] : 0;
+            int b = previous[i];
+            int c = i >= filterStep ? previous[i - filterStep] : 0;
+            switch (filter) {
+                case 0: break;
+                case 1: current[i] = (unsigned char)(current[i] + a); break;
+                case 2: current[i] = (unsigned char)(current[i] + b); break;
+                case 3: current[i] = (unsigned char)(current[i] + ((a + b) >> 1)); break;
+                case 4: current[i] = (unsigned char)(current[i] + Paeth(a, b, c)); break;
+                default: return false;
+            }
+        }
+        previous = current;
+
+        uint8_t* out = image.Row((int)y);
+        if (depth < 8) {
+            const int maxValue = (1 << depth) - 1;
+            for (uint32_t x = 0; x < width; x++) {
+                size_t bit = (size_t)x * depth;
+                int value = (current[bit / 8] >> (8 - depth - (int)(bit % 8))) & maxValue;
+                if (colorType == 3) {
+                    out[x] = value < (int)palette.size() ? palette[value] : 0;
+                } else {
+                    out[x] = (uint8_t)(value * 255 / maxValue);
+                }
+            }
+            continue;
+        }
+
+        // 8 ou 16 bits : octet de poids fort de chaque échantillon
+        const size_t sampleBytes = depth / 8;
+        const size_t pixelBytes = channels * sampleBytes;
+        for (uint32_t x = 0; x < width; x++) {
+            const unsigned char* p = current + x * pixelBytes;
+            switch (colorType) {
+                case 2:
+                case 6:
+                    out[x] = GrayImage::Luma(p[0], p[sampleBytes], p[2 * sampleBytes]);
+                    break;
+                case 3:
+                    out[x] = p[0] < palette.size() ? palette[p[0]] : 0;
+                    break;
+                default:
+                    out[x] = p[0];
+                    break;
+            }
+        }
+    }
+    return true;
+}
+
+bool ImageFile::DecodeBmp(const unsigned char* data, size_t size, GrayImage& image) {
+    if (size < 54) return false;
+    uint32_t pixelOffset = ReadLE32(data + 10);
+    uint32_t headerSize = ReadLE32(data + 14);
+    int32_t width = (int32_t)ReadLE32(data + 18);
+    int32_t height = (int32_t)ReadLE32(data + 22);
+    int bitCount = ReadLE16(data + 28);
+    uint32_t compression = ReadLE32(data + 30);
+
+    // BI_RGB, ou BI_BITFIELDS en 32 bits (masques BGRA usuels supposés)
+    if (headerSize < 40 || (compression != 0 && !(compression == 3 && bitCount == 32))) return false;
+    if (bitCount != 8 && bitCount != 24 && bitCount != 32) return false;
+
+    bool topDown = height < 0;
+    if (topDown) height = -height;
+    if (width <= 0 || height <= 0 || width > MAX_DIMENSION || height > MAX_DIMENSION) return false;
+
+    const size_t stride = (((size_t)width * bitCount + 31) / 32) * 4;
+    if (pixelOffset > size || stride * (size_t)height > size - pixelOffset) return false;
+
+    std::vector<uint8_t> palette;
+    if (bitCount == 8) {
+        uint32_t colors = ReadLE32(data + 46);
+        if (colors == 0 || colors > 256) colors = 256;
+        size_t paletteOffset = 14 + (size_t)headerSize;
+        if (paletteOffset + colors * 4 > size) return false;
+        for (uint32_t i = 0; i < colors; i++) {
+            const unsigned char* entry = data + paletteOffset + i * 4;
+            palette.push_back(GrayImage::Luma(entry[2], entry[1], entry[0]));
+        }
+    }
+
+    image.Resize(width, height);
+    const size_t pixelBytes = bitCount / 8;
+    for (int y = 0; y < height; y++) {
+        const unsigned char* src = data + pixelOffset + stride * (size_t)(topDown ? y : height - 1 - y);
+        uint8_t* out = image.Row(y);
+        if (bitCount == 8) {
+            for (int x = 0; x < width; x++) out[x] = src[x] < palette.size() ? palette[src[x]] : 0;
+        } else {
+            for (int x = 0; x < width; x++) {
+                const unsigned char* p = src + x * pixelBytes;
+                out[x] = GrayImage::Luma(p[2], p[1], p[0]);
+            }
+        }
+    }
+    return true;
+}
+
+bool ImageFile::DecodePnm(const unsigned char* data, size_t size, GrayImage& image) {
+    const int channels = data[1] == '5' ? 1 : 3;
+    size_t pos = 2;
+    unsigned width, height, maxValue;
+    if (!ReadPnmValue(data, size, pos, width) || !ReadPnmValue(data, size, pos, height) ||
+        !ReadPnmValue(data, size, pos, maxValue)) {
+        return false;
+    }
+    pos++;  // Un seul blanc avant les pixels
+
+    if (width == 0 || height == 0 || width > (unsigned)MAX_DIMENSION || height > (unsigned)MAX_DIMENSION) return false;
+    if (maxValue == 0 || maxValue > 65535) return false;
+
+    const size_t sampleBytes = maxValue > 255 ? 2 : 1;
+    const size_t pixelBytes = channels * sampleBytes;
+    if (pos > size || (size_t)width * height * pixelBytes > size - pos) return false;
+
+    image.Resize((int)width, (int)height);
+    const unsigned char* src = data + pos;
+    for (size_t i = 0; i < (size_t)width * height; i++) {
+        unsigned sample[3];
+        for (int c = 0; c < channels; c++) {
+            const unsigned char* p = src + i * pixelBytes + c * sampleBytes;
+            unsigned value = sampleBytes == 2 ? (unsigned)((p[0] << 8) | p[1]) : p[0];
+            sample[c] = value * 255 / maxValue;
+        }
+        image.pixels[i] = channels == 1 ? (uint8_t)sample[0]
+                                        : GrayImage::Luma((uint8_t)sample[0], (uint8_t)sample[1], (uint8_t)sample[2]);
+    }
+    return true;
+}
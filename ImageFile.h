@@ -0,0 +1,21 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include "GrayImage.h"
+
+// Lecture des images de référence des macros image, sans bibliothèque externe.
+// Formats : PNG (non entrelacé, toutes profondeurs), BMP non compressé
+// (8, 24 ou 32 bits) et PGM/PPM binaires (P5/P6). La transparence est ignorée.
+class ImageFile {
+public:
+    // Décoder un fichier en niveaux de gris ; false si illisible ou format non pris en charge
+    static bool LoadGray(const std::wstring& path, GrayImage& image);
+
+    // Décoder une image déjà en mémoire (format reconnu à sa signature)
+    static bool DecodeGray(const unsigned char* data, size_t size, GrayImage& image);
+
+private:
+    static bool DecodePng(const unsigned char* data, size_t size, GrayImage& image);
+    static bool DecodeBmp(const unsigned char* data, size_t size, GrayImage& image);
+    static bool DecodePnm(const unsigned char* data, size_t size, GrayImage& image);
+};
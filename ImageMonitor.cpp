@@ -0,0 +1,159 @@
+#include "ImageMonitor.h"
+#include <algorithm>
+
+ImageMonitor::ImageMonitor(TemplateCache& templates, DetectedCallback onDetected)
+    : m_templates(templates)
+    , m_onDetected(std::move(onDetected))
+    , m_changeDetection(true)
+    , m_frames(0)
+    , m_searches(0)
+    , m_detections(0)
+    , m_skipped(0)
+    , m_partial(0)
+    , m_tileCount(0)
+    , m_tilesChanged(0)
+    , m_lastFrame()
+{
+}
+
+void ImageMonitor::Publish(std::shared_ptr<const MacroStore> store) {
+    m_store.Publish(std::move(store));
+}
+
+void ImageMonitor::SetChangeDetection(bool enabled) {
+    m_changeDetection = enabled;
+}
+
+const ImageMonitor::MacroState* ImageMonitor::FindState(MacroId id) const {
+    for (const MacroState& state : m_states) {
+        if (state.id == id) return &state;
+    }
+    return nullptr;
+}
+
+MatchResult ImageMonitor::SearchChanged(const CachedTemplate& pattern, float minScore) {
+    // Positions dont la fenêtre du modèle touche un rectangle modifié
+    MatchResult result = {};
+    const int w = pattern.image.width;
+    const int h = pattern.image.height;
+    for (const MatchRect& rect : m_changedRects) {
+        MatchRect positions = { rect.x - w + 1, rect.y - h + 1, rect.width + w - 1, rect.height + h - 1 };
+        MatchResult best = pattern.matcher.FindBestIn(m_pyramid, positions, minScore);
+        if (best.found && (!result.found || best.score > result.score)) result = best;
+    }
+    return result;
+}
+
+void ImageMonitor::ProcessFrame(const CapturedFrame& frame) {
+    FramePipeline::Clock::time_point start = FramePipeline::Clock::now();
+    m_frames++;
+
+    // Le store est gardé pendant toute l'image : les vues restent valides
+    std::shared_ptr<const MacroStore> store = m_store.Load();
+    m_macros.clear();
+    m_patterns.clear();
+    int levels = 1;
+    bool fullTables = false;    // Tables du niveau 0 : seulement si un modèle y est cherché partout
+    if (store) {
+        for (size_t i = 0; i < store->Count(MacroKind::Image); i++) {
+            MacroView macro = store->At(MacroKind::Image, i);
+            if (!macro.Enabled()) continue;
+            std::shared_ptr<const CachedTemplate> pattern = m_templates.Get(macro.ImagePath(), macro.SearchMode());
+            if (!pattern) continue;
+            levels = std::max(levels, pattern->matcher.Levels());
+            fullTables = fullTables || pattern->matcher.ScansFullResolution(macro.Confidence() / 100.0f);
+            m_macros.push_back(macro);
+            m_patterns.push_back(std::move(pattern));
+        }
+    }
+
+    // Désactivée, les empreintes ne suivent plus l'écran : tout repart de zéro
+    FrameCounters counters = {};
+    bool allChanged = true;
+    if (m_changeDetection) {
+        counters.tilesChanged = m_tiles.Update(frame.image);
+        counters.tiles = m_tiles.TileCount();
+        allChanged = counters.tilesChanged == counters.tiles;
+        if (!allChanged) m_tiles.ChangedRects(m_changedRects);
+    } else {
+        m_tiles.Reset();
+    }
+
+    bool prepared = false;
+    m_nextStates.clear();
+    for (size_t i = 0; i < m_macros.size(); i++) {
+        const MacroView& macro = m_macros[i];
+        const CachedTemplate& pattern = *m_patterns[i];
+        const float minScore = macro.Confidence() / 100.0f;
+        const MacroState* previous = FindState(macro.Id());
+        const bool known = !allChanged && previous && previous->pattern == m_patterns[i] &&
+                           previous->minScore == minScore;
+
+        MatchResult result = {};
+        if (known && previous->found &&
+            !m_tiles.AnyChanged(previous->x, previous->y, pattern.image.width, pattern.image.height)) {
+            // Toujours là : les pixels sous le modèle n'ont pas bougé
+            result.found = true;
+            result.x = previous->x;
+            result.y = previous->y;
+            counters.skipped++;
+        } else if (known && !previous->found && counters.tilesChanged == 0) {
+            counters.skipped++;
+        } else {
+            if (!prepared) {
+                m_pyramid.Prepare(frame.image, levels, fullTables);
+                prepared = true;
+            }
+            counters.searches++;
+            if (known) {
+                m_partial++;
+                result = SearchChanged(pattern, minScore);
+            }
+            // Modèle perdu ou macro inconnue : toute l'image
+            if (!known || (previous->found && !result.found)) {
+                result = pattern.matcher.FindBest(m_pyramid, minScore);
+            }
+        }
+
+        m_nextStates.push_back(MacroState{ macro.Id(), m_patterns[i], minScore, result.found, result.x, result.y });
+        if (result.found && !(previous && previous->found)) {
+            m_detections++;
+            m_onDetected(store, macro, frame.capturedAt);
+        }
+    }
+    m_states.swap(m_nextStates);
+    m_nextStates.clear();
+
+    m_searches += counters.searches;
+    m_skipped += counters.skipped;
+    m_tileCount += counters.tiles;
+    m_tilesChanged += counters.tilesChanged;
+    {
+        std::lock_guard<std::mutex> lock(m_lastFrameMutex);
+        m_lastFrame = counters;
+    }
+
+    // Entre deux images, le store n'est gardé que par Publish() ; les modèles
+    // des macros suivies restent gardés par leur état
+    m_macros.clear();
+    m_patterns.clear();
+    m_frameTime.Record(std::chrono::duration_cast<std::chrono::microseconds>(
+        FramePipeline::Clock::now() - start).count());
+}
+
+ImageMonitor::Stats ImageMonitor::GetStats() const {
+    Stats stats;
+    stats.frames = m_frames.load(std::memory_order_relaxed);
+    stats.searches = m_searches.load(std::memory_order_relaxed);
+    stats.detections = m_detections.load(std::memory_order_relaxed);
+    stats.skipped = m_skipped.load(std::memory_order_relaxed);
+    stats.partial = m_partial.load(std::memory_order_relaxed);
+    stats.tiles = m_tileCount.load(std::memory_order_relaxed);
+    stats.tilesChanged = m_tilesChanged.load(std::memory_order_relaxed);
+    return stats;
+}
+
+ImageMonitor::FrameCounters ImageMonitor::GetLastFrame() const {
+    std::lock_guard<std::mutex> lock(m_lastFrameMutex);
+    return m_lastFrame;
+}
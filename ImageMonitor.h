@@ -0,0 +1,114 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "DirtyTiles.h"
+#include "FramePipeline.h"
+#include "MacroStore.h"
+#include "PreciseTimer.h"
+#include "PyramidMatcher.h"
+#include "RcuPointer.h"
+#include "TemplateCache.h"
+
+// Détection continue des macros image : pour chaque image de la capture
+// (thread de recherche d'un FramePipeline), cherche le modèle de chaque macro
+// image activée. Le callback part à l'apparition du modèle seulement : tant
+// qu'il reste à l'écran, la macro n'est pas redéclenchée.
+// La pyramide de l'image est construite une fois et partagée par tous les modèles.
+//
+// D'une image à la suivante, seules les tuiles modifiées (DirtyTiles) sont
+// revues : un modèle encore sous des tuiles intactes reste trouvé, et un modèle
+// absent n'est cherché qu'aux positions touchant une tuile modifiée. Si le
+// modèle quitte sa position, toute l'image est revue une fois : une seconde
+// occurrence restée immobile n'est pas perdue. Une macro nouvelle, modifiée ou
+// dont le fichier a changé est cherchée dans toute l'image.
+class ImageMonitor {
+public:
+    // Appelé sur le thread de recherche ; le store est celui où la macro a été
+    // trouvée, capturedAt l'instant de la capture
+    typedef std::function<void(const std::shared_ptr<const MacroStore>& store, MacroView macro,
+                               FramePipeline::Clock::time_point capturedAt)> DetectedCallback;
+
+    struct Stats {
+        uint64_t frames;        // Images traitées
+        uint64_t searches;      // Recherches de modèle faites (complètes ou limitées)
+        uint64_t detections;    // Apparitions (callbacks)
+        uint64_t skipped;       // Recherches évitées (aucune tuile modifiée en jeu)
+        uint64_t partial;       // Recherches limitées aux tuiles modifiées
+        uint64_t tiles;         // Tuiles examinées
+        uint64_t tilesChanged;  // dont modifiées
+    };
+
+    // Compteurs de la dernière image traitée
+    struct FrameCounters {
+        size_t tiles;
+        size_t tilesChanged;
+        size_t searches;        // Recherches faites, complètes ou limitées
+        size_t skipped;
+    };
+
+    ImageMonitor(TemplateCache& templates, DetectedCallback onDetected);
+
+    ImageMonitor(const ImageMonitor&) = delete;
+    ImageMonitor& operator=(const ImageMonitor&) = delete;
+
+    // Nouvel ensemble de macros, depuis n'importe quel thread ; une macro
+    // (même identifiant) déjà visible le reste sans nouveau déclenchement
+    void Publish(std::shared_ptr<const MacroStore> store);
+
+    // Thread de recherche seulement
+    void ProcessFrame(const CapturedFrame& frame);
+
+    // Activée par défaut ; désactivée, chaque image est revue en entier (mesures)
+    void SetChangeDetection(bool enabled);
+
+    Stats GetStats() const;
+    FrameCounters GetLastFrame() const;
+
+    // Durée de traitement d'une image (tous modèles), en µs
+    TimingStats::Report GetFrameTimeReport() const { return m_frameTime.GetReport(); }
+
+private:
+    // Résultat de la dernière recherche d'une macro
+    struct MacroState {
+        MacroId id;
+        std::shared_ptr<const CachedTemplate> pattern;  // Gardé : l'identité prouve le même modèle
+        float minScore;
+        bool found;
+        int x;
+        int y;
+    };
+
+    const MacroState* FindState(MacroId id) const;
+    MatchResult SearchChanged(const CachedTemplate& pattern, float minScore);
+
+    TemplateCache& m_templates;
+    DetectedCallback m_onDetected;
+    RcuPointer<MacroStore> m_store;
+
+    // Thread de recherche seulement, réutilisés d'une image à l'autre
+    MatchPyramid m_pyramid;
+    DirtyTiles m_tiles;
+    std::vector<MatchRect> m_changedRects;
+    std::vector<std::shared_ptr<const CachedTemplate>> m_patterns;
+    std::vector<MacroView> m_macros;
+    std::vector<MacroState> m_states;       // Image précédente
+    std::vector<MacroState> m_nextStates;
+
+    std::atomic<bool> m_changeDetection;
+
+    std::atomic<uint64_t> m_frames;
+    std::atomic<uint64_t> m_searches;
+    std::atomic<uint64_t> m_detections;
+    std::atomic<uint64_t> m_skipped;
+    std::atomic<uint64_t> m_partial;
+    std::atomic<uint64_t> m_tileCount;
+    std::atomic<uint64_t> m_tilesChanged;
+    TimingStats m_frameTime;
+
+    mutable std::mutex m_lastFrameMutex;
+    FrameCounters m_lastFrame;
+};
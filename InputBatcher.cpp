@@ -0,0 +1,23 @@
+#include "InputBatcher.h"
+
+InputBatcher::InputBatcher(InputSink& sink)
+    : m_sink(sink)
+    , m_count(0)
+{
+}
+
+InputBatcher::~InputBatcher() {
+    // Ne jamais laisser une touche enfoncée
+    Flush();
+}
+
+void InputBatcher::Add(const InputEvent& event) {
+    if (m_count == MaxBatch) Flush();
+    m_events[m_count++] = event;
+}
+
+void InputBatcher::Flush() {
+    if (m_count == 0) return;
+    m_sink.Submit(m_events, m_count);
+    m_count = 0;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "InputSink.h"
+
+// Regroupe les événements qui partagent le même instant et les envoie
+// au sink en un seul Submit() (un seul SendInput sous Windows).
+// Tampon fixe : aucune allocation.
+class InputBatcher {
+public:
+    static const size_t MaxBatch = 16;
+
+    explicit InputBatcher(InputSink& sink);
+    ~InputBatcher();
+
+    void Add(const InputEvent& event);
+
+    // Envoyer le lot en attente (à appeler avant que le temps n'avance)
+    void Flush();
+
+    size_t Pending() const { return m_count; }
+
+private:
+    InputSink& m_sink;
+    InputEvent m_events[MaxBatch];
+    size_t m_count;
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Boutons souris
+enum class MouseButton : uint8_t {
+    Left,
+    Right,
+    Middle,
+    X1,
+    X2
+};
+
+// Événement d'entrée élémentaire, indépendant de la plateforme
+struct InputEvent {
+    enum class Type : uint8_t { KeyDown, KeyUp, MouseDown, MouseUp };
+
+    Type type;
+    MouseButton button; // Pour MouseDown / MouseUp
+    uint16_t vk;        // Pour KeyDown / KeyUp
+
+    static InputEvent Key(uint16_t vk, bool down) {
+        InputEvent e;
+        e.type = down ? Type::KeyDown : Type::KeyUp;
+        e.button = MouseButton::Left;
+        e.vk = vk;
+        return e;
+    }
+
+    static InputEvent Mouse(MouseButton button, bool down) {
+        InputEvent e;
+        e.type = down ? Type::MouseDown : Type::MouseUp;
+        e.button = button;
+        e.vk = 0;
+        return e;
+    }
+};
+
+// Destination des entrées simulées (SendInput, enregistreur, ...).
+// Submit() reçoit un lot d'événements à injecter d'un seul bloc, dans l'ordre.
+class InputSink {
+public:
+    virtual ~InputSink() {}
+
+    virtual void Submit(const InputEvent* events, size_t count) = 0;
+};
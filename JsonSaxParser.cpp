@@ -0,0 +1,273 @@
+#include "JsonSaxParser.h"
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+// Imbrication maximale acceptée (le schéma de macros.json en utilise 4)
+const int MAX_DEPTH = 64;
+
+class ParserState {
+public:
+    ParserState(const char* data, size_t size, JsonSaxHandler& handler)
+        : m_begin(data)
+        , m_pos(data)
+        , m_end(data + size)
+        , m_handler(handler)
+    {
+    }
+
+    bool Run() {
+        // BOM UTF-8 écrit par SaveToFile
+        if (m_end - m_pos >= 3 && (unsigned char)m_pos[0] == 0xEF &&
+            (unsigned char)m_pos[1] == 0xBB && (unsigned char)m_pos[2] == 0xBF) {
+            m_pos += 3;
+        }
+
+        SkipWhitespace();
+        if (!ParseValue(0)) return false;
+        SkipWhitespace();
+        return m_pos == m_end;
+    }
+
+    size_t Offset() const { return (size_t)(m_pos - m_begin); }
+
+private:
+    void SkipWhitespace() {
+        while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\n' || *m_pos == '\r' || *m_pos == '\t')) {
+            m_pos++;
+        }
+    }
+
+    bool Consume(char c) {
+        if (m_pos < m_end && *m_pos == c) {
+            m_pos++;
+            return true;
+        }
+        return false;
+    }
+
+    bool ConsumeLiteral(const char* literal, size_t length) {
+        if ((size_t)(m_end - m_pos) < length) return false;
+        for (size_t i = 0; i < length; i++) {
+            if (m_pos[i] != literal[i]) return false;
+        }
+        m_pos += length;
+        return true;
+    }
+
+    bool ParseValue(int depth) {
+        if (m_pos >= m_end) return false;
+
+        switch (*m_pos) {
+            case '{': return ParseObject(depth + 1);
+            case '[': return ParseArray(depth + 1);
+            case '"': {
+                const char* str;
+                size_t length;
+                return ParseString(str, length) && m_handler.String(str, length);
+            }
+            case 't': return ConsumeLiteral("true", 4) && m_handler.Bool(true);
+            case 'f': return ConsumeLiteral("false", 5) && m_handler.Bool(false);
+            case 'n': return ConsumeLiteral("null", 4) && m_handler.Null();
+            default:  return ParseNumber();
+        }
+    }
+
+    bool ParseObject(int depth) {
+        if (depth > MAX_DEPTH) return false;
+        m_pos++; // '{'
+        if (!m_handler.StartObject()) return false;
+
+        SkipWhitespace();
+        if (Consume('}')) return m_handler.EndObject();
+
+        while (true) {
+            const char* key;
+            size_t length;
+            if (m_pos >= m_end || *m_pos != '"') return false;
+            if (!ParseString(key, length) || !m_handler.Key(key, length)) return false;
+
+            SkipWhitespace();
+            if (!Consume(':')) return false;
+            SkipWhitespace();
+            if (!ParseValue(depth)) return false;
+
+            SkipWhitespace();
+            if (Consume(',')) {
+                SkipWhitespace();
+                continue;
+            }
+            if (Consume('}')) return m_handler.EndObject();
+            return false;
+        }
+    }
+
+    bool ParseArray(int depth) {
+        if (depth > MAX_DEPTH) return false;
+        m_pos++; // '['
+        if (!m_handler.StartArray()) return false;
+
+        SkipWhitespace();
+        if (Consume(']')) return m_handler.EndArray();
+
+        while (true) {
+            if (!ParseValue(depth)) return false;
+
+            SkipWhitespace();
+            if (Consume(',')) {
+                SkipWhitespace();
+                continue;
+            }
+            if (Consume(']')) return m_handler.EndArray();
+            return false;
+        }
+    }
+
+    // Sans échappement : pointe dans le tampon d'entrée.
+    // Sinon : chaîne reconstruite dans m_scratch (réutilisé d'une chaîne à l'autre).
+    bool ParseString(const char*& str, size_t& length) {
+        m_pos++; // '"'
+        const char* start = m_pos;
+
+        while (m_pos < m_end && *m_pos != '"' && *m_pos != '\\') {
+            if ((unsigned char)*m_pos < 0x20) return false;
+            m_pos++;
+        }
+        if (m_pos >= m_end) return false;
+
+        if (*m_pos == '"') {
+            str = start;
+            length = (size_t)(m_pos - start);
+            m_pos++;
+            return true;
+        }
+
+        m_scratch.assign(start, m_pos);
+        while (m_pos < m_end) {
+            char c = *m_pos++;
+            if (c == '"') {
+                str = m_scratch.data();
+                length = m_scratch.size();
+                return true;
+            }
+            if ((unsigned char)c < 0x20) return false;
+            if (c != '\\') {
+                m_scratch += c;
+                continue;
+            }
+
+            if (m_pos >= m_end) return false;
+            switch (*m_pos++) {
+                case '"':  m_scratch += '"'; break;
+                case '\\': m_scratch += '\\'; break;
+                case '/':  m_scratch += '/'; break;
+                case 'b':  m_scratch += '\b'; break;
+                case 'f':  m_scratch += '\f'; break;
+                case 'n':  m_scratch += '\n'; break;
+                case 'r':  m_scratch += '\r'; break;
+                case 't':  m_scratch += '\t'; break;
+                case 'u':
+                    if (!ParseUnicodeEscape()) return false;
+                    break;
+                default:
+                    return false;
+            }
+        }
+        return false;
+    }
+
+    bool ParseHex4(uint32_t& value) {
+        if (m_end - m_pos < 4) return false;
+        value = 0;
+        for (int i = 0; i < 4; i++) {
+            char c = *m_pos++;
+            value <<= 4;
+            if (c >= '0' && c <= '9') value |= (uint32_t)(c - '0');
+            else if (c >= 'a' && c <= 'f') value |= (uint32_t)(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') value |= (uint32_t)(c - 'A' + 10);
+            else return false;
+        }
+        return true;
+    }
+
+    // \uXXXX (paires de substitution comprises) réencodé en UTF-8
+    bool ParseUnicodeEscape() {
+        uint32_t code;
+        if (!ParseHex4(code)) return false;
+
+        if (code >= 0xD800 && code <= 0xDBFF) {
+            uint32_t low;
+            if (!ConsumeLiteral("\\u", 2) || !ParseHex4(low)) return false;
+            if (low < 0xDC00 || low > 0xDFFF) return false;
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        } else if (code >= 0xDC00 && code <= 0xDFFF) {
+            return false;
+        }
+
+        if (code < 0x80) {
+            m_scratch += (char)code;
+        } else if (code < 0x800) {
+            m_scratch += (char)(0xC0 | (code >> 6));
+            m_scratch += (char)(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            m_scratch += (char)(0xE0 | (code >> 12));
+            m_scratch += (char)(0x80 | ((code >> 6) & 0x3F));
+            m_scratch += (char)(0x80 | (code & 0x3F));
+        } else {
+            m_scratch += (char)(0xF0 | (code >> 18));
+            m_scratch += (char)(0x80 | ((code >> 12) & 0x3F));
+            m_scratch += (char)(0x80 | ((code >> 6) & 0x3F));
+            m_scratch += (char)(0x80 | (code & 0x3F));
+        }
+        return true;
+    }
+
+    bool ParseNumber() {
+        const char* start = m_pos;
+        bool negative = Consume('-');
+        bool integral = true;
+        int64_t integer = 0;
+
+        if (m_pos >= m_end || *m_pos < '0' || *m_pos > '9') return false;
+        while (m_pos < m_end && *m_pos >= '0' && *m_pos <= '9') {
+            if (integer < 100000000000000000LL) integer = integer * 10 + (*m_pos - '0');
+            else integral = false;
+            m_pos++;
+        }
+        if (m_pos < m_end && (*m_pos == '.' || *m_pos == 'e' || *m_pos == 'E')) {
+            integral = false;
+            while (m_pos < m_end && ((*m_pos >= '0' && *m_pos <= '9') || *m_pos == '.' ||
+                                     *m_pos == 'e' || *m_pos == 'E' || *m_pos == '+' || *m_pos == '-')) {
+                m_pos++;
+            }
+        }
+
+        // Cas courant (entiers du schéma) sans passer par strtod
+        if (integral) {
+            return m_handler.Number((double)(negative ? -integer : integer));
+        }
+
+        std::string text(start, m_pos);
+        char* parsedEnd = nullptr;
+        double value = strtod(text.c_str(), &parsedEnd);
+        if (parsedEnd != text.c_str() + text.size()) return false;
+        return m_handler.Number(value);
+    }
+
+    const char* m_begin;
+    const char* m_pos;
+    const char* m_end;
+    JsonSaxHandler& m_handler;
+    std::string m_scratch;
+};
+
+} // namespace
+
+bool JsonSaxParser::Parse(const char* data, size_t size, JsonSaxHandler& handler, size_t* errorOffset) {
+    ParserState state(data, size, handler);
+    bool ok = state.Run();
+    if (!ok && errorOffset) *errorOffset = state.Offset();
+    return ok;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+
+// Réception des événements du parseur. Les chaînes sont en UTF-8, déjà
+// désechappées, et ne restent valides que pendant l'appel.
+// Retourner false interrompt l'analyse.
+class JsonSaxHandler {
+public:
+    virtual ~JsonSaxHandler() {}
+
+    virtual bool StartObject() = 0;
+    virtual bool EndObject() = 0;
+    virtual bool StartArray() = 0;
+    virtual bool EndArray() = 0;
+    virtual bool Key(const char* str, size_t length) = 0;
+    virtual bool String(const char* str, size_t length) = 0;
+    virtual bool Number(double value) = 0;
+    virtual bool Bool(bool value) = 0;
+    virtual bool Null() = 0;
+};
+
+// Parseur JSON événementiel (style SAX) : un seul passage sur le texte,
+// sans arbre intermédiaire. Une chaîne sans échappement est transmise
+// directement depuis le tampon d'entrée, sans copie.
+class JsonSaxParser {
+public:
+    // data : document UTF-8, BOM accepté.
+    // errorOffset : position de l'erreur en cas d'échec (optionnel).
+    static bool Parse(const char* data, size_t size, JsonSaxHandler& handler, size_t* errorOffset = nullptr);
+};
@@ -0,0 +1,52 @@
+#include "JsonWriter.h"
+#include "Utf8.h"
+#include <cstring>
+
+void JsonWriter::Raw(const char* text) {
+    m_out.append(text, strlen(text));
+}
+
+void JsonWriter::String(const wchar_t* str, size_t length) {
+    static const char hex[] = "0123456789abcdef";
+
+    m_out += '"';
+
+    // Les segments sans caractère à échapper sont convertis d'un bloc
+    size_t runStart = 0;
+    for (size_t i = 0; i < length; i++) {
+        wchar_t c = str[i];
+        if (c >= 0x20 && c != L'"' && c != L'\\') continue;
+
+        if (i > runStart) Utf8::AppendFromWide(str + runStart, i - runStart, m_out);
+        runStart = i + 1;
+
+        switch (c) {
+            case L'"': m_out.append("\\\"", 2); break;
+            case L'\\': m_out.append("\\\\", 2); break;
+            case L'\n': m_out.append("\\n", 2); break;
+            case L'\r': m_out.append("\\r", 2); break;
+            case L'\t': m_out.append("\\t", 2); break;
+            default: {
+                // Autres caractères de contrôle : \u00XX
+                char escape[6] = { '\\', 'u', '0', '0', hex[(c >> 4) & 0xF], hex[c & 0xF] };
+                m_out.append(escape, sizeof(escape));
+                break;
+            }
+        }
+    }
+    if (length > runStart) Utf8::AppendFromWide(str + runStart, length - runStart, m_out);
+
+    m_out += '"';
+}
+
+void JsonWriter::Int(int64_t value) {
+    char buffer[24];
+    char* p = buffer + sizeof(buffer);
+    uint64_t magnitude = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+    do {
+        *--p = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+    if (value < 0) *--p = '-';
+    m_out.append(p, buffer + sizeof(buffer) - p);
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Écriture JSON en un seul passage, directement à la fin d'un tampon UTF-8.
+// Les chaînes larges sont échappées et converties en UTF-8 sans chaîne
+// intermédiaire ; la mise en forme (indentation, séparateurs) reste à l'appelant.
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out) : m_out(out) {}
+
+    // Texte déjà au format JSON, recopié tel quel
+    void Raw(const char* text);
+    void Raw(const char* text, size_t length) { m_out.append(text, length); }
+
+    // Chaîne entre guillemets, échappée
+    void String(const wchar_t* str, size_t length);
+    void String(const std::wstring& str) { String(str.data(), str.size()); }
+
+    void Bool(bool value) { Raw(value ? "true" : "false"); }
+    void Int(int64_t value);
+
+private:
+    std::string& m_out;
+};
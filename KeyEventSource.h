@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+
+// Front d'une touche ou d'un bouton souris (virtual key code)
+struct KeyEdge {
+    uint16_t vk;
+    bool down;      // true = appui, false = relâchement
+};
+
+// Source d'événements de touches : pousse les fronts au lieu d'être interrogée.
+// Le callback est appelé sur le thread de la source et doit rester court.
+class KeyEventSource {
+public:
+    typedef std::function<void(const KeyEdge&)> Callback;
+
+    virtual ~KeyEventSource() {}
+
+    virtual bool Start(Callback callback) = 0;
+    virtual void Stop() = 0;
+};
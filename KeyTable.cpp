@@ -0,0 +1,234 @@
+#include "KeyTable.h"
+#include <cstdint>
+
+namespace {
+
+struct KeyEntry {
+    const char* name;   // En majuscules
+    uint16_t vk;
+};
+
+// Triée par nom (ordre ASCII) pour la recherche dichotomique ; vérifié par static_assert.
+// Les codes sont les valeurs VK_* de Windows, écrites en dur pour ne pas dépendre de <windows.h>.
+constexpr KeyEntry KEY_TABLE[] = {
+    { "'", 0xDE },              // VK_OEM_7
+    { ",", 0xBC },              // VK_OEM_COMMA
+    { "-", 0xBD },              // VK_OEM_MINUS
+    { ".", 0xBE },              // VK_OEM_PERIOD
+    { "/", 0xBF },              // VK_OEM_2
+    { "0", 0x30 },
+    { "1", 0x31 },
+    { "2", 0x32 },
+    { "3", 0x33 },
+    { "4", 0x34 },
+    { "5", 0x35 },
+    { "6", 0x36 },
+    { "7", 0x37 },
+    { "8", 0x38 },
+    { "9", 0x39 },
+    { ";", 0xBA },              // VK_OEM_1
+    { "=", 0xBB },              // VK_OEM_PLUS
+    { "A", 0x41 },
+    { "ADD", 0x6B },            // VK_ADD
+    { "ALT", 0x12 },            // VK_MENU
+    { "APOSTROPHE", 0xDE },     // VK_OEM_7
+    { "APPS", 0x5D },           // VK_APPS
+    { "B", 0x42 },
+    { "BACK", 0x08 },           // VK_BACK
+    { "BACKQUOTE", 0xC0 },      // VK_OEM_3
+    { "BACKSLASH", 0xDC },      // VK_OEM_5
+    { "BACKSPACE", 0x08 },      // VK_BACK
+    { "C", 0x43 },
+    { "CAPSLOCK", 0x14 },       // VK_CAPITAL
+    { "COMMA", 0xBC },          // VK_OEM_COMMA
+    { "CONTROL", 0x11 },        // VK_CONTROL
+    { "CTRL", 0x11 },           // VK_CONTROL
+    { "D", 0x44 },
+    { "DECIMAL", 0x6E },        // VK_DECIMAL
+    { "DEL", 0x2E },            // VK_DELETE
+    { "DELETE", 0x2E },         // VK_DELETE
+    { "DIVIDE", 0x6F },         // VK_DIVIDE
+    { "DOWN", 0x28 },           // VK_DOWN
+    { "E", 0x45 },
+    { "END", 0x23 },            // VK_END
+    { "ENTER", 0x0D },          // VK_RETURN
+    { "EQUALS", 0xBB },         // VK_OEM_PLUS
+    { "ESC", 0x1B },            // VK_ESCAPE
+    { "ESCAPE", 0x1B },         // VK_ESCAPE
+    { "F", 0x46 },
+    { "F1", 0x70 },             // VK_F1
+    { "F10", 0x79 },            // VK_F10
+    { "F11", 0x7A },            // VK_F11
+    { "F12", 0x7B },            // VK_F12
+    { "F13", 0x7C },            // VK_F13
+    { "F14", 0x7D },            // VK_F14
+    { "F15", 0x7E },            // VK_F15
+    { "F16", 0x7F },            // VK_F16
+    { "F17", 0x80 },            // VK_F17
+    { "F18", 0x81 },            // VK_F18
+    { "F19", 0x82 },            // VK_F19
+    { "F2", 0x71 },             // VK_F2
+    { "F20", 0x83 },            // VK_F20
+    { "F21", 0x84 },            // VK_F21
+    { "F22", 0x85 },            // VK_F22
+    { "F23", 0x86 },            // VK_F23
+    { "F24", 0x87 },            // VK_F24
+    { "F3", 0x72 },             // VK_F3
+    { "F4", 0x73 },             // VK_F4
+    { "F5", 0x74 },             // VK_F5
+    { "F6", 0x75 },             // VK_F6
+    { "F7", 0x76 },             // VK_F7
+    { "F8", 0x77 },             // VK_F8
+    { "F9", 0x78 },             // VK_F9
+    { "G", 0x47 },
+    { "GRAVE", 0xC0 },          // VK_OEM_3
+    { "H", 0x48 },
+    { "HOME", 0x24 },           // VK_HOME
+    { "I", 0x49 },
+    { "INS", 0x2D },            // VK_INSERT
+    { "INSERT", 0x2D },         // VK_INSERT
+    { "J", 0x4A },
+    { "K", 0x4B },
+    { "L", 0x4C },
+    { "LALT", 0xA4 },           // VK_LMENU
+    { "LBRACKET", 0xDB },       // VK_OEM_4
+    { "LBUTTON", 0x01 },        // VK_LBUTTON
+    { "LCTRL", 0xA2 },          // VK_LCONTROL
+    { "LEFT", 0x25 },           // VK_LEFT
+    { "LSHIFT", 0xA0 },         // VK_LSHIFT
+    { "LWIN", 0x5B },           // VK_LWIN
+    { "M", 0x4D },
+    { "MBUTTON", 0x04 },        // VK_MBUTTON
+    { "MENU", 0x12 },           // VK_MENU
+    { "MINUS", 0xBD },          // VK_OEM_MINUS
+    { "MOUSE4", 0x05 },         // VK_XBUTTON1
+    { "MOUSE5", 0x06 },         // VK_XBUTTON2
+    { "MULTIPLY", 0x6A },       // VK_MULTIPLY
+    { "N", 0x4E },
+    { "NUMLOCK", 0x90 },        // VK_NUMLOCK
+    { "NUMPAD0", 0x60 },        // VK_NUMPAD0
+    { "NUMPAD1", 0x61 },        // VK_NUMPAD1
+    { "NUMPAD2", 0x62 },        // VK_NUMPAD2
+    { "NUMPAD3", 0x63 },        // VK_NUMPAD3
+    { "NUMPAD4", 0x64 },        // VK_NUMPAD4
+    { "NUMPAD5", 0x65 },        // VK_NUMPAD5
+    { "NUMPAD6", 0x66 },        // VK_NUMPAD6
+    { "NUMPAD7", 0x67 },        // VK_NUMPAD7
+    { "NUMPAD8", 0x68 },        // VK_NUMPAD8
+    { "NUMPAD9", 0x69 },        // VK_NUMPAD9
+    { "NUMPADADD", 0x6B },      // VK_ADD
+    { "NUMPADDECIMAL", 0x6E },  // VK_DECIMAL
+    { "NUMPADDIVIDE", 0x6F },   // VK_DIVIDE
+    { "NUMPADMULTIPLY", 0x6A }, // VK_MULTIPLY
+    { "NUMPADSUBTRACT", 0x6D }, // VK_SUBTRACT
+    { "O", 0x4F },
+    { "OEM_1", 0xBA },          // VK_OEM_1
+    { "OEM_102", 0xE2 },        // VK_OEM_102
+    { "OEM_2", 0xBF },          // VK_OEM_2
+    { "OEM_3", 0xC0 },          // VK_OEM_3
+    { "OEM_4", 0xDB },          // VK_OEM_4
+    { "OEM_5", 0xDC },          // VK_OEM_5
+    { "OEM_6", 0xDD },          // VK_OEM_6
+    { "OEM_7", 0xDE },          // VK_OEM_7
+    { "OEM_COMMA", 0xBC },      // VK_OEM_COMMA
+    { "OEM_MINUS", 0xBD },      // VK_OEM_MINUS
+    { "OEM_PERIOD", 0xBE },     // VK_OEM_PERIOD
+    { "OEM_PLUS", 0xBB },       // VK_OEM_PLUS
+    { "P", 0x50 },
+    { "PAGEDOWN", 0x22 },       // VK_NEXT
+    { "PAGEUP", 0x21 },         // VK_PRIOR
+    { "PAUSE", 0x13 },          // VK_PAUSE
+    { "PERIOD", 0xBE },         // VK_OEM_PERIOD
+    { "PGDN", 0x22 },           // VK_NEXT
+    { "PGUP", 0x21 },           // VK_PRIOR
+    { "PLUS", 0xBB },           // VK_OEM_PLUS
+    { "PRINTSCREEN", 0x2C },    // VK_SNAPSHOT
+    { "Q", 0x51 },
+    { "QUOTE", 0xDE },          // VK_OEM_7
+    { "R", 0x52 },
+    { "RALT", 0xA5 },           // VK_RMENU
+    { "RBRACKET", 0xDD },       // VK_OEM_6
+    { "RBUTTON", 0x02 },        // VK_RBUTTON
+    { "RCTRL", 0xA3 },          // VK_RCONTROL
+    { "RETURN", 0x0D },         // VK_RETURN
+    { "RIGHT", 0x27 },          // VK_RIGHT
+    { "RSHIFT", 0xA1 },         // VK_RSHIFT
+    { "RWIN", 0x5C },           // VK_RWIN
+    { "S", 0x53 },
+    { "SCROLLLOCK", 0x91 },     // VK_SCROLL
+    { "SEMICOLON", 0xBA },      // VK_OEM_1
+    { "SHIFT", 0x10 },          // VK_SHIFT
+    { "SLASH", 0xBF },          // VK_OEM_2
+    { "SPACE", 0x20 },          // VK_SPACE
+    { "SUBTRACT", 0x6D },       // VK_SUBTRACT
+    { "T", 0x54 },
+    { "TAB", 0x09 },            // VK_TAB
+    { "U", 0x55 },
+    { "UP", 0x26 },             // VK_UP
+    { "V", 0x56 },
+    { "W", 0x57 },
+    { "WIN", 0x5B },            // VK_LWIN
+    { "X", 0x58 },
+    { "XBUTTON1", 0x05 },       // VK_XBUTTON1
+    { "XBUTTON2", 0x06 },       // VK_XBUTTON2
+    { "Y", 0x59 },
+    { "Z", 0x5A },
+    { "[", 0xDB },              // VK_OEM_4
+    { "\\", 0xDC },             // VK_OEM_5
+    { "]", 0xDD },              // VK_OEM_6
+    { "`", 0xC0 },              // VK_OEM_3
+};
+
+constexpr size_t KEY_COUNT = sizeof(KEY_TABLE) / sizeof(KEY_TABLE[0]);
+
+constexpr int CompareNames(const char* a, const char* b) {
+    while (*a && *a == *b) { a++; b++; }
+    return (unsigned char)*a - (unsigned char)*b;
+}
+
+constexpr bool IsSorted() {
+    for (size_t i = 1; i < KEY_COUNT; i++) {
+        if (CompareNames(KEY_TABLE[i - 1].name, KEY_TABLE[i].name) >= 0) return false;
+    }
+    return true;
+}
+
+static_assert(IsSorted(), "KEY_TABLE doit être triée et sans doublon");
+
+inline wchar_t ToUpperAscii(wchar_t c) {
+    return (c >= L'a' && c <= L'z') ? (wchar_t)(c - L'a' + L'A') : c;
+}
+
+// Compare une saisie (longueur explicite, casse quelconque) à un nom de la table
+int CompareKey(const wchar_t* key, size_t length, const char* name) {
+    for (size_t i = 0; i < length; i++) {
+        wchar_t c = ToUpperAscii(key[i]);
+        unsigned char n = (unsigned char)name[i];
+        if (n == 0) return 1;               // La saisie est plus longue
+        if ((unsigned)c != n) return (unsigned)c < n ? -1 : 1;
+    }
+    return name[length] == 0 ? 0 : -1;      // La saisie est un préfixe
+}
+
+} // namespace
+
+int KeyTable::Lookup(const wchar_t* name, size_t length) {
+    if (length == 0) return 0;
+
+    // Lettres et chiffres : le VK est le code ASCII majuscule ; la ponctuation
+    // (touches OEM) passe par la table
+    if (length == 1) {
+        wchar_t c = ToUpperAscii(name[0]);
+        if ((c >= L'A' && c <= L'Z') || (c >= L'0' && c <= L'9')) return (int)c;
+    }
+
+    size_t lo = 0, hi = KEY_COUNT;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        int cmp = CompareKey(name, length, KEY_TABLE[mid].name);
+        if (cmp == 0) return KEY_TABLE[mid].vk;
+        if (cmp < 0) hi = mid;
+        else lo = mid + 1;
+    }
+    return 0;
+}
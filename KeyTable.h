@@ -0,0 +1,13 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// Table unique et immuable nom de touche -> virtual key code,
+// partagée par HotkeyManager, MacroCompiler et l'exécuteur.
+// Générée à la compilation : aucune construction ni allocation à l'exécution.
+class KeyTable {
+public:
+    // Recherche insensible à la casse ; retourne 0 si la touche est inconnue
+    static int Lookup(const wchar_t* name, size_t length);
+    static int Lookup(const std::wstring& name) { return Lookup(name.data(), name.size()); }
+};
@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Correspondance virtual key code (valeurs VK_* de Windows, voir KeyTable) <->
+// codes du sous-système input de Linux (KEY_* / BTN_*).
+// Utilisée par UinputInputSink (injection) et EvdevKeySource (déclenchement).
+class LinuxKeyMap {
+public:
+    // Retourne 0 si la touche n'a pas d'équivalent
+    static uint16_t ToLinux(uint16_t vk);
+    static uint16_t FromLinux(uint16_t code);
+
+    // Appelle visit(code) pour chaque code Linux de la table (déclaration des
+    // touches du périphérique virtuel)
+    template <typename Visitor>
+    static void ForEachCode(Visitor visit) {
+        for (size_t i = 0; i < EntryCount(); i++) visit(CodeAt(i));
+    }
+
+private:
+    static size_t EntryCount();
+    static uint16_t CodeAt(size_t i);
+};
@@ -0,0 +1,854 @@
+#include "MacroBench.h"
+#include "AtomicFile.h"
+#include "DirtyTiles.h"
+#include "FramePipeline.h"
+#include "GrayImage.h"
+#include "ImageFile.h"
+#include "ImageMonitor.h"
+#include "KeyTable.h"
+#include "MacroClock.h"
+#include "MacroCompiler.h"
+#include "MacroManager.h"
+#include "MacroSnapshot.h"
+#include "MacroStore.h"
+#include "MappedFile.h"
+#include "NullInputSink.h"
+#include "PreciseTimer.h"
+#include "PyramidMatcher.h"
+#include "SyntheticFrameSource.h"
+#include "TemplateCache.h"
+#include "TemplateMatcher.h"
+#include "TriggerDispatcher.h"
+#include "Utf8.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cwctype>
+#include <map>
+#include <thread>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double ElapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Jeu de macros représentatif : 70 % basiques, 20 % combos, 10 % image.
+// Les hotkeys parcourent F1..F24 ; les actions mêlent touches, accords, clics et attentes.
+void Generate(MacroManager& macros, size_t count) {
+    static const wchar_t* const ACTIONS[] = {
+        L"Press Q", L"Press CTRL+SHIFT+E", L"Wait 25", L"Click Left", L"Press F", L"Wait 100"
+    };
+    const size_t actionCount = sizeof(ACTIONS) / sizeof(ACTIONS[0]);
+
+    macros.basicMacros.clear();
+    macros.imageMacros.clear();
+    macros.comboMacros.clear();
+
+    for (size_t i = 0; i < count; i++) {
+        std::wstring name = L"Macro été #" + std::to_wstring(i);
+        std::wstring hotkey = L"F" + std::to_wstring(1 + i % 24);
+
+        if (i % 10 < 7) {
+            BasicMacro m = {};
+            m.name = name;
+            m.hotkey = hotkey;
+            for (size_t a = 0; a < 4; a++) m.actions.push_back(ACTIONS[(i + a) % actionCount]);
+            m.enabled = true;
+            m.loop = (i % 5 == 0);
+            m.overloadPolicy = (OverloadPolicy)(i % 4);
+            m.queueLimit = 3;
+            macros.basicMacros.push_back(m);
+        } else if (i % 10 < 9) {
+            ComboMacro m = {};
+            m.name = name;
+            m.hotkey = hotkey;
+            for (size_t a = 0; a < 6; a++) m.skills.push_back(ACTIONS[(i + a) % actionCount]);
+            m.delayBetween = 120;
+            m.enabled = true;
+            m.overloadPolicy = OverloadPolicy::Queue;
+            m.queueLimit = 2;
+            macros.comboMacros.push_back(m);
+        } else {
+            ImageMacro m = {};
+            m.name = name;
+            m.imagePath = L"images/target_" + std::to_wstring(i) + L".png";
+            m.action = ACTIONS[i % actionCount];
+            m.confidence = 80;
+            m.searchMode = (ImageSearchMode)(i % 3);
+            m.enabled = true;
+            macros.imageMacros.push_back(m);
+        }
+    }
+    macros.CompileMacros();
+    macros.AssignIds();
+}
+
+void Report(const char* name, const MacroBench::Options& options, double totalMs, const char* extra = "") {
+    double perIteration = totalMs / (double)options.iterations;
+    printf("%-18s %7zu macros  %10.3f ms/iter  %s\n", name, options.macroCount, perIteration, extra);
+}
+
+// Exécution simulée d'une instruction : ce que l'exécuteur lit à chaque déclenchement
+inline uint64_t Consume(const MacroInstruction& ins) {
+    return (uint64_t)ins.op * 1000003u + ins.vk * 31u + ins.modifiers + (uint64_t)ins.button + ins.durationMs;
+}
+
+// Déclenchements de toutes les macros basiques : actions parsées à chaque fois
+// (comme avant la compilation) contre programme compilé au chargement
+void BenchCompile(const MacroBench::Options& options) {
+    MacroManager macros;
+    Generate(macros, options.macroCount);
+
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < options.iterations; i++) macros.CompileMacros();
+    Report("compile.all", options, ElapsedMs(start));
+
+    size_t actions = 0;
+    for (const BasicMacro& m : macros.basicMacros) actions += m.actions.size();
+
+    uint64_t parsedSum = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < options.iterations; i++) {
+        for (const BasicMacro& m : macros.basicMacros) {
+            for (const std::wstring& action : m.actions) parsedSum += Consume(MacroCompiler::CompileAction(action));
+        }
+    }
+    const double parseMs = ElapsedMs(start);
+
+    uint64_t compiledSum = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < options.iterations; i++) {
+        for (const BasicMacro& m : macros.basicMacros) {
+            for (const MacroInstruction& ins : m.program) compiledSum += Consume(ins);
+        }
+    }
+    const double compiledMs = ElapsedMs(start);
+
+    char extra[96];
+    const double count = (double)actions * options.iterations;
+    snprintf(extra, sizeof(extra), "%.1f ns par action", parseMs * 1e6 / count);
+    Report("compile.parse", options, parseMs, extra);
+    snprintf(extra, sizeof(extra), "%.2f ns par action, x%.0f%s", compiledMs * 1e6 / count,
+             compiledMs > 0 ? parseMs / compiledMs : 0.0, parsedSum == compiledSum ? "" : " (RÉSULTATS DIFFÉRENTS)");
+    Report("compile.program", options, compiledMs, extra);
+}
+
+// Percentiles d'un échantillon trié
+int64_t Percentile(const std::vector<int64_t>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = (size_t)(p * (double)(sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+// Erreur de réveil de DeadlineTimer sur l'horloge système (attentes de 1, 2 et
+// 5 ms enchaînées), puis dérive d'un sleep_for relatif sur les mêmes attentes
+void BenchTiming(const MacroBench::Options& options) {
+    static const uint32_t STEPS_MS[] = { 1, 2, 5 };
+    const size_t steps = options.iterations * 25;
+
+    SystemClock clock;
+    TimingStats stats;
+    DeadlineTimer timer(&stats, nullptr, &clock);
+    std::vector<int64_t> errors;
+    errors.reserve(steps);
+    uint64_t nominalMs = 0;
+
+    timer.Restart();
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < steps; i++) {
+        const uint32_t ms = STEPS_MS[i % 3];
+        nominalMs += ms;
+        timer.WaitFor(ms);
+        errors.push_back(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - timer.Deadline()).count());
+    }
+    const double deadlineDriftMs = ElapsedMs(start) - (double)nominalMs;
+
+    std::sort(errors.begin(), errors.end());
+    TimingStats::Report report = stats.GetReport();
+    printf("%-18s %7llu pas    moyenne %.1f µs, p50 %lld µs, p90 %lld µs, p99 %lld µs, max %lld µs, dérive %.2f ms\n",
+           "timing.deadline", (unsigned long long)report.steps, report.meanErrorUs,
+           (long long)Percentile(errors, 0.50), (long long)Percentile(errors, 0.90),
+           (long long)Percentile(errors, 0.99), (long long)report.maxErrorUs, deadlineDriftMs);
+    int64_t lower = 0;
+    for (int b = 0; b < TimingStats::BucketCount; b++) {
+        const int64_t limit = TimingStats::BucketLimitUs(b);
+        char range[48];
+        if (b == 0) snprintf(range, sizeof(range), "< %lld µs", (long long)limit);
+        else if (limit < 0) snprintf(range, sizeof(range), ">= %lld µs", (long long)lower);
+        else snprintf(range, sizeof(range), "%lld - %lld µs", (long long)lower, (long long)limit);
+        printf("%-18s %18s  %6llu  %5.1f %%\n", "", range, (unsigned long long)report.buckets[b],
+               report.steps ? 100.0 * report.buckets[b] / report.steps : 0.0);
+        lower = limit;
+    }
+
+    // Sans échéance absolue : chaque retard s'ajoute au suivant
+    start = Clock::now();
+    for (size_t i = 0; i < steps; i++) std::this_thread::sleep_for(std::chrono::milliseconds(STEPS_MS[i % 3]));
+    printf("%-18s %7zu pas    dérive %.2f ms sur %llu ms\n", "timing.sleep_for", steps,
+           ElapsedMs(start) - (double)nominalMs, (unsigned long long)nominalMs);
+}
+
+// Résolution des noms de touches : table constante (KeyTable) contre l'ancienne
+// std::map<std::wstring, int>, consultée après une copie en majuscules
+void BenchKeys(const MacroBench::Options& options) {
+    static const wchar_t* const NAMES[] = {
+        L"F1", L"ctrl", L"Shift", L"NumPad7", L"PageDown", L"Esc", L"a", L"Z", L"7", L"Delete",
+        L";", L"oem_plus", L"LBracket", L"Multiply", L"XButton1", L"Space", L"Inconnue", L"F24",
+    };
+    const size_t count = sizeof(NAMES) / sizeof(NAMES[0]);
+
+    std::map<std::wstring, int> legacy;
+    for (const wchar_t* name : NAMES) {
+        std::wstring upper = name;
+        std::transform(upper.begin(), upper.end(), upper.begin(), ::towupper);
+        if (int vk = KeyTable::Lookup(name)) legacy[upper] = vk;
+    }
+    std::vector<std::wstring> names(NAMES, NAMES + count);
+
+    const size_t lookups = options.iterations * 50000;
+    long checksum = 0;
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < lookups; i++) {
+        const std::wstring& name = names[i % count];
+        checksum += KeyTable::Lookup(name.data(), name.size());
+    }
+    const double tableMs = ElapsedMs(start);
+
+    long legacySum = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < lookups; i++) {
+        std::wstring upper = names[i % count];
+        std::transform(upper.begin(), upper.end(), upper.begin(), ::towupper);
+        auto it = legacy.find(upper);
+        legacySum += it != legacy.end() ? it->second : 0;
+    }
+    const double legacyMs = ElapsedMs(start);
+
+    printf("%-18s %7zu noms    %8.1f ns par recherche, sans allocation%s\n", "keys.table", count,
+           tableMs * 1e6 / lookups, checksum == legacySum ? "" : " (RÉSULTATS DIFFÉRENTS)");
+    printf("%-18s %7zu noms    %8.1f ns par recherche (copie + map), x%.1f\n", "keys.map", count,
+           legacyMs * 1e6 / lookups, tableMs > 0 ? legacyMs / tableMs : 0.0);
+}
+
+void BenchJson(const MacroBench::Options& options) {
+    MacroManager macros;
+    Generate(macros, options.macroCount);
+    std::wstring path = Utf8::ToWide(options.directory + "/macroflow-bench.json");
+
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < options.iterations; i++) macros.SaveToFile(path);
+    double saveMs = ElapsedMs(start);
+
+    size_t bytes = macros.ToJson().size();
+    char extra[64];
+    snprintf(extra, sizeof(extra), "%.1f MB/s (%zu octets)", bytes * options.iterations / (saveMs * 1000.0), bytes);
+    Report("json.save", options, saveMs, extra);
+
+    MacroManager loaded;
+    start = Clock::now();
+    for (size_t i = 0; i < options.iterations; i++) loaded.LoadFromFile(path);
+    double loadMs = ElapsedMs(start);
+    snprintf(extra, sizeof(extra), "%.1f MB/s", bytes * options.iterations / (loadMs * 1000.0));
+    Report("json.load", options, loadMs, extra);
+
+    // Gros fichier de référence (50 000 macros), quel que soit --macros
+    MacroBench::Options large = options;
+    large.macroCount = 50000;
+    large.iterations = std::max<size_t>(options.iterations / 5, 1);
+    Generate(macros, large.macroCount);
+    macros.SaveToFile(path);
+    bytes = macros.ToJson().size();
+    start = Clock::now();
+    bool loadedAll = true;
+    for (size_t i = 0; i < large.iterations; i++) loadedAll = loaded.LoadFromFile(path) && loadedAll;
+    loadMs = ElapsedMs(start);
+    const size_t count = loaded.basicMacros.size() + loaded.comboMacros.size() + loaded.imageMacros.size();
+    snprintf(extra, sizeof(extra), "%.1f MB/s (%zu octets)%s", bytes * large.iterations / (loadMs * 1000.0),
+             bytes, loadedAll && count == large.macroCount ? "" : " (CHARGEMENT INCOMPLET)");
+    Report("json.load50k", large, loadMs, extra);
+
+    std::remove(WStringToString(path).c_str());
+}
+
+void BenchSnapshot(const MacroBench::Options& options) {
+    MacroManager macros;
+    Generate(macros, options.macroCount);
+    std::wstring source = Utf8::ToWide(options.directory + "/macroflow-bench.json");
+    std::wstring snapshot = Utf8::ToWide(options.directory + "/macroflow-bench.snapshot");
+    macros.SaveToFile(source);
+
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < options.iterations; i++) macros.SaveSnapshot(snapshot, source);
+    Report("snapshot.save", options, ElapsedMs(start));
+
+    MacroManager loaded;
+    start = Clock::now();
+    for (size_t i = 0; i < options.iterations; i++) loaded.LoadSnapshot(snapshot, source);
+    Report("snapshot.load", options, ElapsedMs(start));
+
+    // Démarrage de l'application : store construit en place, sans MacroManager
+    SnapshotSource stamp = {};
+    MappedFile::Stat(source, stamp.size, stamp.writeTime);
+    size_t rows = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < options.iterations; i++) {
+        MacroSnapshot mapped;
+        if (mapped.Open(snapshot, stamp)) rows = MacroStore::FromSnapshot(mapped)->Size();
+    }
+    Report("snapshot.store", options, ElapsedMs(start), rows == options.macroCount ? "" : "(SNAPSHOT REFUSÉ)");
+
+    std::remove(WStringToString(source).c_str());
+    std::remove(WStringToString(snapshot).c_str());
+}
+
+void BenchStore(const MacroBench::Options& options) {
+    MacroManager macros;
+    Generate(macros, options.macroCount);
+
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < options.iterations; i++) MacroStore::Build(macros);
+    Report("store.build", options, ElapsedMs(start));
+}
+
+// Coût côté thread des hooks (OnKeyEdge) et latence déclenchement -> exécution.
+// Macros vides et sink sans effet : seul le moteur est mesuré, pas la durée des macros.
+void BenchDispatch(const MacroBench::Options& options) {
+    MacroManager macros;
+    Generate(macros, options.macroCount);
+    for (auto& m : macros.basicMacros) { m.actions.clear(); m.program.clear(); m.loop = false; }
+    for (auto& m : macros.comboMacros) { m.skills.clear(); m.program.clear(); }
+
+    NullInputSink sink;
+    MacroExecutor executor(&sink);
+    TriggerDispatcher dispatcher(executor);
+    dispatcher.Publish(MacroStore::Build(macros));
+    dispatcher.Start();
+
+    const size_t presses = options.iterations * 10;
+    double edgeMs = 0;
+    for (size_t i = 0; i < presses; i++) {
+        KeyEdge edge;
+        edge.vk = (uint16_t)KeyTable::Lookup(L"F" + std::to_wstring(1 + i % 24));
+        edge.down = true;
+        Clock::time_point start = Clock::now();
+        dispatcher.OnKeyEdge(edge);
+        edge.down = false;
+        dispatcher.OnKeyEdge(edge);
+        edgeMs += ElapsedMs(start);
+
+        // Vider la file entre deux appuis : un hotkey partagé par beaucoup de
+        // macros remplirait sinon la file plus vite que les consommateurs
+        while (dispatcher.GetStats().depth > 0 || executor.IsExecuting()) std::this_thread::yield();
+    }
+    dispatcher.Stop();
+    executor.StopExecution(true);
+
+    TriggerDispatcher::Stats stats = dispatcher.GetStats();
+    TimingStats::Report latency = dispatcher.GetLatencyReport();
+    char extra[160];
+    snprintf(extra, sizeof(extra), "%.0f ns/déclenchement, %llu postés, %llu perdus, latence moy. %.0f us (max %lld us)",
+             edgeMs * 1e6 / (double)(stats.posted > 0 ? stats.posted : 1), (unsigned long long)stats.posted,
+             (unsigned long long)stats.dropped, latency.meanErrorUs, (long long)latency.maxErrorUs);
+    printf("%-18s %7zu macros  %10zu appuis    %s\n", "dispatch.edge", options.macroCount, presses, extra);
+}
+
+// Publication d'un nouveau store pendant le monitoring (modification d'une macro)
+void BenchPublish(const MacroBench::Options& options) {
+    MacroManager macros;
+    Generate(macros, options.macroCount);
+
+    NullInputSink sink;
+    MacroExecutor executor(&sink);
+    TriggerDispatcher dispatcher(executor);
+    dispatcher.Publish(MacroStore::Build(macros));
+    dispatcher.Start();
+
+    double totalMs = 0;
+    for (size_t i = 0; i < options.iterations; i++) {
+        macros.basicMacros[i % macros.basicMacros.size()].enabled ^= true;
+        std::shared_ptr<const MacroStore> store = MacroStore::Build(macros);
+
+        Clock::time_point start = Clock::now();
+        dispatcher.Publish(store);
+        totalMs += ElapsedMs(start);
+    }
+    dispatcher.Stop();
+    Report("dispatch.publish", options, totalMs);
+}
+
+// Débit de la simulation (VirtualClock) : macros en boucle pendant cinq minutes
+// simulée ; mesure le coût de l'ordonnanceur par réveil, sans attente réelle.
+// Au plus 32 macros, le pool d'exécution plafonnant les exécutions simultanées.
+void BenchSimulate(const MacroBench::Options& options) {
+    const size_t count = options.macroCount < 32 ? options.macroCount : 32;
+    MacroManager macros;
+    for (size_t i = 0; i < count; i++) {
+        BasicMacro m = {};
+        m.name = L"Boucle " + std::to_wstring(i);
+        m.actions.push_back(L"Press Q");
+        m.actions.push_back(L"Wait " + std::to_wstring(20 + i % 7));
+        m.actions.push_back(L"Click Left");
+        m.enabled = true;
+        m.loop = true;
+        macros.basicMacros.push_back(m);
+    }
+    macros.CompileMacros();
+    macros.AssignIds();
+    std::shared_ptr<const MacroStore> store = MacroStore::Build(macros);
+
+    NullInputSink sink;
+    VirtualClock clock;
+    MacroExecutor executor(&sink, &clock);
+
+    Clock::time_point start = Clock::now();
+    clock.Attach();
+    std::vector<RunHandle> runs;
+    for (size_t i = 0; i < count; i++) runs.push_back(executor.ExecuteMacro(store, store->At(MacroKind::Basic, i)));
+    clock.SleepUntil(clock.Now() + std::chrono::minutes(5));
+    for (RunHandle& run : runs) run.Stop();
+    clock.Detach();
+    for (RunHandle& run : runs) run.Join();
+    double totalMs = ElapsedMs(start);
+
+    char extra[160];
+    snprintf(extra, sizeof(extra), "5 min simulées en %.1f ms, %llu événements, %llu réveils (%.0f réveils/s)", totalMs,
+             (unsigned long long)sink.EventCount(), (unsigned long long)clock.WakeCount(),
+             (double)clock.WakeCount() * 1000.0 / (totalMs > 0 ? totalMs : 1));
+    printf("%-18s %7zu macros  %10s           %s\n", "simulate.5min", count, "", extra);
+}
+
+typedef SyntheticFrameSource::Random Random;
+typedef SyntheticFrameSource::Target ScreenTarget;
+
+// Recherche exhaustive de plusieurs modèles dans un écran 1080p, par noyau
+// disponible, comparée au budget de 16 ms par image (60 images/s) sur un cœur.
+// Elle ne le tient pas (de l'ordre de 0,6 à 1,3 s) : seule la recherche
+// pyramidale en mode rapide le tient, pour des modèles de type icône.
+void BenchMatch(const MacroBench::Options& options) {
+    Random random(2024);
+    GrayImage screen;
+    std::vector<ScreenTarget> targets;
+    SyntheticFrameSource::Generate(screen, targets, random);
+
+    const float minScore = 0.85f;
+    const size_t rounds = options.iterations >= 10 ? options.iterations / 10 : 1;
+    const TemplateMatcher::Kernel kernels[] = {
+        TemplateMatcher::Kernel::Scalar, TemplateMatcher::Kernel::Sse2, TemplateMatcher::Kernel::Avx2
+    };
+
+    MatchFrame frame;
+    frame.Prepare(screen);    // Tables allouées une fois, comme d'une capture à l'autre
+
+    for (TemplateMatcher::Kernel kernel : kernels) {
+        if (!TemplateMatcher::IsSupported(kernel)) continue;
+
+        std::vector<TemplateMatcher> matchers(targets.size());
+        for (size_t i = 0; i < targets.size(); i++) {
+            matchers[i].SetTemplate(targets[i].pattern);
+            matchers[i].SetKernel(kernel);
+        }
+
+        double prepareMs = 0;
+        std::vector<double> searchMs(targets.size(), 0);
+        size_t found = 0, positions = 0, completed = 0;
+        for (size_t r = 0; r < rounds; r++) {
+            Clock::time_point start = Clock::now();
+            frame.Prepare(screen);
+            prepareMs += ElapsedMs(start);
+
+            for (size_t i = 0; i < targets.size(); i++) {
+                start = Clock::now();
+                MatchResult result = matchers[i].FindBest(frame, minScore);
+                searchMs[i] += ElapsedMs(start);
+                if (result.found && result.x == targets[i].x && result.y == targets[i].y) found++;
+                positions += result.positions;
+                completed += result.completed;
+            }
+        }
+
+        double totalMs = prepareMs;
+        std::string detail;
+        char part[48];
+        for (size_t i = 0; i < targets.size(); i++) {
+            totalMs += searchMs[i];
+            snprintf(part, sizeof(part), " %dx%d %.1f", targets[i].pattern.width, targets[i].pattern.height,
+                     searchMs[i] / (double)rounds);
+            detail += part;
+        }
+        totalMs /= (double)rounds;
+
+        char name[32];
+        snprintf(name, sizeof(name), "match.%s", TemplateMatcher::KernelName(kernel));
+        printf("%-18s %7s  %10.3f ms/image  tables %.1f ms, modèles (ms)%s, trouvés %zu/%zu, "
+               "%.2f %% corrélées entièrement, budget 16 ms %s\n",
+               name, "1080p", totalMs, prepareMs / (double)rounds, detail.c_str(), found, targets.size() * rounds,
+               100.0 * (double)completed / (double)(positions ? positions : 1), totalMs <= 16.0 ? "tenu" : "dépassé");
+    }
+}
+
+// Recherche pyramidale comparée à la recherche exhaustive sur les mêmes écrans :
+// temps par image (pyramide comprise), gain, et accord des résultats (même
+// présence, même position) au seuil de 0,85. Aux icônes s'ajoutent des modèles
+// découpés dans un autre écran, normalement absents.
+// Le budget de 16 ms est évalué sur une image où l'on ne cherche que les icônes,
+// pyramide comprise : les découpes, du texte aux détails fins, n'ont pas de niveau
+// réduit fiable et sont cherchées en pleine résolution (plus de 100 ms chacune
+// en 1080p sur un cœur).
+void BenchPyramid(const MacroBench::Options& options) {
+    const float minScore = 0.85f;
+    const ImageSearchMode modes[] = { ImageSearchMode::Balanced, ImageSearchMode::Fast };
+    const struct { const char* label; int width; int height; size_t screens; } sizes[] = {
+        { "1080p", 1920, 1080, options.iterations >= 4 ? options.iterations / 4 : 1 },
+        { "4K", 3840, 2160, 1 },
+    };
+
+    // Tables allouées une fois, comme d'une capture à l'autre
+    MatchFrame frame;
+    MatchPyramid pyramid;
+
+    for (const auto& size : sizes) {
+        double exactMs = 0;
+        double modeMs[2] = { 0, 0 };
+        double iconMs[2] = { 0, 0 };
+        size_t agreed[2] = { 0, 0 };
+        size_t searches = 0, present = 0;
+        size_t positions[3] = { 0, 0, 0 };
+
+        for (size_t s = 0; s < size.screens; s++) {
+            Random random(7000 + (uint32_t)s);
+            GrayImage screen, other;
+            std::vector<ScreenTarget> targets, decoys;
+            SyntheticFrameSource::Generate(screen, targets, random, size.width, size.height);
+            SyntheticFrameSource::Generate(other, decoys, random, size.width, size.height);
+
+            std::vector<GrayImage> patterns;
+            for (const ScreenTarget& target : targets) patterns.push_back(target.pattern);
+            for (int i = 0; i < 2; i++) {
+                GrayImage decoy;
+                decoy.Resize(40, 24);
+                const int x = random.Below(other.width - 40), y = random.Below(other.height - 24);
+                for (int row = 0; row < 24; row++) {
+                    std::copy(other.Row(y + row) + x, other.Row(y + row) + x + 40, decoy.Row(row));
+                }
+                patterns.push_back(decoy);
+            }
+
+            std::vector<MatchResult> expected;
+            {
+                Clock::time_point start = Clock::now();
+                frame.Prepare(screen);
+                for (const GrayImage& pattern : patterns) {
+                    TemplateMatcher matcher;
+                    matcher.SetTemplate(pattern);
+                    expected.push_back(matcher.FindBest(frame, minScore));
+                    positions[0] += expected.back().positions;
+                    if (expected.back().found) present++;
+                }
+                exactMs += ElapsedMs(start);
+            }
+            searches += patterns.size();
+
+            for (int m = 0; m < 2; m++) {
+                std::vector<PyramidMatcher> matchers(patterns.size());
+                int levels = 1;
+                bool fullTables = false, iconTables = false;
+                for (size_t i = 0; i < patterns.size(); i++) {
+                    matchers[i].SetTemplate(patterns[i], PyramidSettings::For(modes[m]));
+                    levels = std::max(levels, matchers[i].Levels());
+                    fullTables = fullTables || matchers[i].ScansFullResolution(minScore);
+                    if (i < targets.size()) iconTables = iconTables || matchers[i].ScansFullResolution(minScore);
+                }
+
+                pyramid.Prepare(screen, levels);    // Hors mesure : tables allouées au besoin
+
+                // Icônes seules : la pyramide ne prépare que ce qu'elles utilisent
+                Clock::time_point start = Clock::now();
+                pyramid.Prepare(screen, levels, iconTables);
+                for (size_t i = 0; i < targets.size(); i++) matchers[i].FindBest(pyramid, minScore);
+                iconMs[m] += ElapsedMs(start);
+
+                start = Clock::now();
+                pyramid.Prepare(screen, levels, fullTables);
+                for (size_t i = 0; i < patterns.size(); i++) {
+                    MatchResult result = matchers[i].FindBest(pyramid, minScore);
+                    positions[m + 1] += result.positions;
+                    if (result.found == expected[i].found &&
+                        (!result.found || (result.x == expected[i].x && result.y == expected[i].y))) {
+                        agreed[m]++;
+                    }
+                }
+                modeMs[m] += ElapsedMs(start);
+            }
+        }
+
+        const double screens = (double)size.screens;
+        printf("%-18s %7s  %10.3f ms/image  %zu recherches, %zu modèles présents, %.0f positions/image\n",
+               "pyramid.exact", size.label, exactMs / screens, searches, present, (double)positions[0] / screens);
+        for (int m = 0; m < 2; m++) {
+            char name[32];
+            snprintf(name, sizeof(name), "pyramid.%s", MacroManager::ImageSearchModeName(modes[m]));
+            printf("%-18s %7s  %10.3f ms/image  gain x%.1f, accord %zu/%zu, %.0f positions/image, "
+                   "icônes seules %.1f ms, budget 16 ms %s\n",
+                   name, size.label, modeMs[m] / screens, exactMs / (modeMs[m] > 0 ? modeMs[m] : 1), agreed[m],
+                   searches, (double)positions[m + 1] / screens, iconMs[m] / screens,
+                   iconMs[m] / screens <= 16.0 ? "tenu (icônes seules)" : "dépassé");
+        }
+    }
+}
+
+bool WritePgm(const std::wstring& path, const GrayImage& image) {
+    std::string data = "P5\n" + std::to_string(image.width) + " " + std::to_string(image.height) + "\n255\n";
+    data.append(image.pixels.begin(), image.pixels.end());
+    return AtomicFile::Write(path, data);
+}
+
+// Modèles des macros image : décodage et préparation à chaque recherche,
+// comparés au cache (accès vérifiant la date du fichier) ; puis remplacement
+// d'un fichier et budget mémoire trop petit pour tous les modèles.
+void BenchTemplates(const MacroBench::Options& options) {
+    Random random(2024);
+    GrayImage screen;
+    std::vector<ScreenTarget> targets;
+    SyntheticFrameSource::Generate(screen, targets, random);
+
+    std::vector<std::wstring> paths;
+    for (size_t i = 0; i < targets.size(); i++) {
+        paths.push_back(Utf8::ToWide(options.directory + "/macroflow-bench-" + std::to_string(i) + ".pgm"));
+        if (!WritePgm(paths.back(), targets[i].pattern)) {
+            printf("templates          écriture impossible dans %s\n", options.directory.c_str());
+            return;
+        }
+    }
+    const double loads = (double)(options.iterations * paths.size());
+    const ImageSearchMode mode = ImageSearchMode::Balanced;
+
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < options.iterations; i++) {
+        for (const std::wstring& path : paths) {
+            GrayImage pattern;
+            PyramidMatcher matcher;
+            ImageFile::LoadGray(path, pattern);
+            matcher.SetTemplate(pattern, PyramidSettings::For(mode));
+        }
+    }
+    const double coldUs = ElapsedMs(start) * 1000.0 / loads;
+
+    TemplateCache cache;
+    start = Clock::now();
+    for (size_t i = 0; i < options.iterations; i++) {
+        for (const std::wstring& path : paths) cache.Get(path, mode);
+    }
+    const double cachedUs = ElapsedMs(start) * 1000.0 / loads;
+    TemplateCache::Stats stats = cache.GetStats();
+    printf("%-18s %7zu modèles  %8.1f µs/accès sans cache, %.1f µs avec (x%.0f), succès %.1f %%, %zu octets\n",
+           "templates.cache", paths.size(), coldUs, cachedUs, coldUs / (cachedUs > 0 ? cachedUs : 1),
+           100.0 * stats.hits / (double)stats.lookups, stats.residentBytes);
+
+    // Un autre modèle (de taille différente) remplace le premier fichier
+    WritePgm(paths[0], targets[1].pattern);
+    std::shared_ptr<const CachedTemplate> replaced = cache.Get(paths[0], mode);
+    stats = cache.GetStats();
+    printf("%-18s %7s  %llu rechargement(s), modèle %dx%d après remplacement\n", "templates.reload", "",
+           (unsigned long long)stats.reloads, replaced ? replaced->image.width : 0,
+           replaced ? replaced->image.height : 0);
+
+    // Budget pour la moitié des modèles, accès en boucle : pire cas du LRU
+    TemplateCache small(stats.residentBytes / 2);
+    for (size_t i = 0; i < options.iterations; i++) {
+        for (const std::wstring& path : paths) small.Get(path, mode);
+    }
+    stats = small.GetStats();
+    printf("%-18s %7s  budget %zu octets : %zu modèles gardés, succès %.1f %%, %llu évictions\n",
+           "templates.budget", "", stats.budget, stats.entries, 100.0 * stats.hits / (double)stats.lookups,
+           (unsigned long long)stats.evictions);
+
+    for (const std::wstring& path : paths) std::remove(WStringToString(path).c_str());
+}
+
+// Capture et recherche en parallèle (FramePipeline + ImageMonitor) sur l'écran
+// synthétique 1080p, capture au plus vite : cadence de capture seule, puis avec
+// la recherche des quatre icônes (macros image, mode équilibré) sur l'autre thread.
+// Une macro image par icône de l'écran synthétique, modèles écrits dans le
+// répertoire du bench (paths, à effacer) ; nullptr, rien n'étant laissé, si
+// l'écriture échoue
+std::shared_ptr<const MacroStore> BuildTargetMacros(const char* bench, const MacroBench::Options& options,
+                                                    const std::vector<ScreenTarget>& targets,
+                                                    std::vector<std::wstring>& paths) {
+    MacroManager macros;
+    for (size_t i = 0; i < targets.size(); i++) {
+        paths.push_back(Utf8::ToWide(options.directory + "/macroflow-bench-" + std::to_string(i) + ".pgm"));
+        if (!WritePgm(paths.back(), targets[i].pattern)) {
+            printf("%-18s écriture impossible dans %s\n", bench, options.directory.c_str());
+            for (const std::wstring& path : paths) std::remove(WStringToString(path).c_str());
+            paths.clear();
+            return nullptr;
+        }
+        ImageMacro m = {};
+        m.name = L"Icône " + std::to_wstring(i);
+        m.imagePath = paths.back();
+        m.action = L"Press F";
+        m.confidence = 85;
+        m.searchMode = ImageSearchMode::Balanced;
+        m.enabled = true;
+        macros.imageMacros.push_back(m);
+    }
+    macros.CompileMacros();
+    macros.AssignIds();
+    return MacroStore::Build(macros);
+}
+
+void BenchPipeline(const MacroBench::Options& options) {
+    SyntheticFrameSource source;
+    std::vector<std::wstring> paths;
+    std::shared_ptr<const MacroStore> store = BuildTargetMacros("pipeline", options, source.Targets(), paths);
+    if (!store) return;
+
+    const std::chrono::milliseconds duration(25 * (long)options.iterations);
+    for (int withSearch = 0; withSearch < 2; withSearch++) {
+        TemplateCache templates;
+        ImageMonitor monitor(templates, [](const std::shared_ptr<const MacroStore>&, MacroView,
+                                           FramePipeline::Clock::time_point) {});
+        if (withSearch) monitor.Publish(store);
+
+        FramePipeline pipeline;
+        Clock::time_point start = Clock::now();
+        pipeline.Start(source, 0, [&monitor](const CapturedFrame& frame) { monitor.ProcessFrame(frame); });
+        std::this_thread::sleep_for(duration);
+        pipeline.Stop();
+        const double seconds = ElapsedMs(start) / 1000.0;
+
+        FramePipeline::Stats frames = pipeline.GetStats();
+        ImageMonitor::Stats detection = monitor.GetStats();
+        TimingStats::Report frameTime = monitor.GetFrameTimeReport();
+        TimingStats::Report age = pipeline.GetFrameAgeReport();
+        printf("%-18s %7s  %8.1f captures/s, %.1f traitées/s, %llu sautées, %.2f ms par image, "
+               "prise après %.2f ms, %llu détections\n",
+               withSearch ? "pipeline.search" : "pipeline.capture", "1080p", frames.captured / seconds,
+               frames.processed / seconds, (unsigned long long)frames.skipped, frameTime.meanErrorUs / 1000.0,
+               age.meanErrorUs / 1000.0, (unsigned long long)detection.detections);
+    }
+
+    for (const std::wstring& path : paths) std::remove(WStringToString(path).c_str());
+}
+
+// Écran presque immobile : quelques zones de texte redessinées à chaque image,
+// et une icône qui disparaît puis revient ailleurs toutes les 10 images.
+// Les mêmes images passent par deux ImageMonitor, avec et sans les tuiles ;
+// leurs détections (image, macro) doivent être identiques.
+void BenchTiles(const MacroBench::Options& options) {
+    SyntheticFrameSource source;
+    const TemplateMatcher::Kernel kernels[] = {
+        TemplateMatcher::Kernel::Scalar, TemplateMatcher::Kernel::Sse2, TemplateMatcher::Kernel::Avx2
+    };
+    for (TemplateMatcher::Kernel kernel : kernels) {
+        DirtyTiles tiles;
+        if (!tiles.SetKernel(kernel)) continue;
+        tiles.Update(source.Screen());
+        const size_t rounds = options.iterations * 5;
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < rounds; i++) tiles.Update(source.Screen());
+        char name[32];
+        snprintf(name, sizeof(name), "tiles.hash.%s", TemplateMatcher::KernelName(kernel));
+        printf("%-18s %7s  %8.3f ms par image, %zu tuiles de %d pixels\n", name, "1080p",
+               ElapsedMs(start) / rounds, tiles.TileCount(), DirtyTiles::TileSize);
+    }
+
+    std::vector<std::wstring> paths;
+    std::shared_ptr<const MacroStore> store = BuildTargetMacros("tiles", options, source.Targets(), paths);
+    if (!store) return;
+
+    TemplateCache templates;
+    size_t frameIndex = 0;
+    std::vector<std::pair<size_t, MacroId>> events[2];
+    ImageMonitor full(templates, [&events, &frameIndex](const std::shared_ptr<const MacroStore>&, MacroView macro,
+                                                        FramePipeline::Clock::time_point) {
+        events[0].push_back(std::make_pair(frameIndex, macro.Id()));
+    });
+    ImageMonitor tiled(templates, [&events, &frameIndex](const std::shared_ptr<const MacroStore>&, MacroView macro,
+                                                         FramePipeline::Clock::time_point) {
+        events[1].push_back(std::make_pair(frameIndex, macro.Id()));
+    });
+    full.SetChangeDetection(false);
+    full.Publish(store);
+    tiled.Publish(store);
+
+    const size_t frames = std::max<size_t>(options.iterations * 3, 20);
+    CapturedFrame frame = {};
+    for (frameIndex = 0; frameIndex < frames; frameIndex++) {
+        if (frameIndex > 0) source.Animate(3);
+        const size_t target = (frameIndex / 10) % source.Targets().size();
+        if (frameIndex % 10 == 5) source.HideTarget(target);
+        if (frameIndex % 10 == 6) source.ShowTarget(target);
+
+        source.Capture(frame.image);
+        frame.sequence = frameIndex + 1;
+        frame.capturedAt = FramePipeline::Clock::now();
+        full.ProcessFrame(frame);
+        tiled.ProcessFrame(frame);
+    }
+
+    const ImageMonitor* monitors[] = { &full, &tiled };
+    const double fullMs = full.GetFrameTimeReport().meanErrorUs / 1000.0;
+    for (int i = 0; i < 2; i++) {
+        ImageMonitor::Stats stats = monitors[i]->GetStats();
+        const double ms = monitors[i]->GetFrameTimeReport().meanErrorUs / 1000.0;
+        const double changed = stats.tiles ? 100.0 * stats.tilesChanged / stats.tiles : 100.0;
+        const uint64_t checks = stats.searches + stats.skipped;
+        printf("%-18s %7s  %8.2f ms par image (x%.1f), tuiles modifiées %.1f %%, %llu recherches dont %llu "
+               "limitées, %llu évitées sur %llu, %zu détections%s\n",
+               i ? "tiles.monitor" : "tiles.full", "1080p", ms, ms > 0 ? fullMs / ms : 0.0, changed,
+               (unsigned long long)stats.searches, (unsigned long long)stats.partial,
+               (unsigned long long)stats.skipped, (unsigned long long)checks, events[i].size(),
+               i && events[1] != events[0] ? " (DIFFÉRENTES de la recherche complète)" : "");
+    }
+
+    for (const std::wstring& path : paths) std::remove(WStringToString(path).c_str());
+}
+
+struct BenchEntry {
+    const char* name;
+    void (*run)(const MacroBench::Options&);
+};
+
+const BenchEntry BENCHES[] = {
+    { "compile", BenchCompile },
+    { "timing", BenchTiming },
+    { "keys", BenchKeys },
+    { "json", BenchJson },
+    { "snapshot", BenchSnapshot },
+    { "store", BenchStore },
+    { "dispatch", BenchDispatch },
+    { "publish", BenchPublish },
+    { "simulate", BenchSimulate },
+    { "match", BenchMatch },
+    { "pyramid", BenchPyramid },
+    { "templates", BenchTemplates },
+    { "pipeline", BenchPipeline },
+    { "tiles", BenchTiles },
+};
+
+} // namespace
+
+bool MacroBench::Run(const std::string& name, const Options& options) {
+    bool found = false;
+    for (const BenchEntry& bench : BENCHES) {
+        if (name == "all" || name == bench.name) {
+            bench.run(options);
+            found = true;
+        }
+    }
+    return found;
+}
+
+std::string MacroBench::Names() {
+    std::string names;
+    for (const BenchEntry& bench : BENCHES) {
+        if (!names.empty()) names += ' ';
+        names += bench.name;
+    }
+    return names;
+}
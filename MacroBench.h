@@ -0,0 +1,22 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// Mesures du moteur hors interface graphique (commande "bench" de macroflow).
+// Chaque mesure génère ses propres macros et affiche une ligne par résultat.
+class MacroBench {
+public:
+    struct Options {
+        size_t macroCount;      // Macros générées
+        size_t iterations;      // Répétitions de chaque mesure
+        std::string directory;  // Fichiers temporaires (JSON, snapshot)
+
+        Options() : macroCount(1000), iterations(20), directory(".") {}
+    };
+
+    // name : nom d'une mesure ou "all" ; false si la mesure est inconnue
+    static bool Run(const std::string& name, const Options& options);
+
+    // Noms des mesures, séparés par des espaces
+    static std::string Names();
+};
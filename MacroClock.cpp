@@ -0,0 +1,143 @@
+#include "MacroClock.h"
+#include "PreciseTimer.h"
+
+MacroClock& MacroClock::System() {
+    static SystemClock clock;
+    return clock;
+}
+
+bool SystemClock::SleepUntil(TimePoint deadline, const CancellationToken* token) {
+    return DeadlineTimer::SleepUntil(deadline, token);
+}
+
+VirtualClock::VirtualClock(TimePoint start)
+    : m_now(start)
+    , m_busy(0)
+    , m_nextActivity(1)
+    , m_wakeCount(0)
+{
+}
+
+MacroClock::TimePoint VirtualClock::Now() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_now;
+}
+
+bool VirtualClock::SleepUntil(TimePoint deadline, const CancellationToken* token) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (token && token->IsCancelled()) return false;
+    if (deadline <= m_now) return true;
+
+    Activity activity = AddWaiter(deadline, token);
+    Waiter& waiter = m_waiters[activity];
+    m_busy--;
+    Advance();
+
+    waiter.wake.wait(lock, [&waiter]() { return waiter.woken; });
+    bool cancelled = waiter.cancelled;
+    m_waiters.erase(activity);
+    return !cancelled;
+}
+
+MacroClock::Activity VirtualClock::BeginActivity() {
+    // En file à l'instant présent : réveillée à son tour, sans avance du temps
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return AddWaiter(m_now, nullptr);
+}
+
+void VirtualClock::EnterActivity(Activity activity) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_waiters.find(activity);
+    if (it == m_waiters.end()) return;
+
+    Waiter& waiter = it->second;
+    waiter.wake.wait(lock, [&waiter]() { return waiter.woken; });
+    m_waiters.erase(it);
+}
+
+void VirtualClock::LeaveActivity() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_busy--;
+    Advance();
+}
+
+void VirtualClock::DropActivity(Activity activity) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_waiters.find(activity);
+    if (it == m_waiters.end()) return;
+
+    if (it->second.woken) {
+        m_busy--;   // Son tour était venu : le rendre
+    } else {
+        for (auto entry = m_queue.begin(); entry != m_queue.end(); ++entry) {
+            if (entry->second == activity) {
+                m_queue.erase(entry);
+                break;
+            }
+        }
+    }
+    m_waiters.erase(it);
+    Advance();
+}
+
+void VirtualClock::Attach() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_busy++;
+}
+
+void VirtualClock::Detach() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_busy--;
+    Advance();
+}
+
+void VirtualClock::RunUntilIdle() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_busy--;
+    Advance();
+    m_idle.wait(lock, [this]() { return m_busy == 0 && m_queue.empty(); });
+    m_busy++;
+}
+
+uint64_t VirtualClock::WakeCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_wakeCount;
+}
+
+MacroClock::Activity VirtualClock::AddWaiter(TimePoint deadline, const CancellationToken* token) {
+    Activity activity = m_nextActivity++;
+    Waiter& waiter = m_waiters[activity];
+    waiter.token = token;
+    waiter.woken = false;
+    waiter.cancelled = false;
+    m_queue.insert(std::make_pair(deadline, activity));
+    return activity;
+}
+
+void VirtualClock::Advance() {
+    // Un seul participant à la fois : tant que quelqu'un travaille, le temps est figé
+    if (m_busy > 0) return;
+    if (m_queue.empty()) {
+        m_idle.notify_all();
+        return;
+    }
+
+    // Attentes annulées d'abord, réveillées sans avancer le temps
+    auto next = m_queue.begin();
+    for (auto it = m_queue.begin(); it != m_queue.end(); ++it) {
+        const Waiter& waiter = m_waiters[it->second];
+        if (waiter.token && waiter.token->IsCancelled()) {
+            next = it;
+            break;
+        }
+    }
+
+    Waiter& waiter = m_waiters[next->second];
+    waiter.cancelled = waiter.token && waiter.token->IsCancelled();
+    if (!waiter.cancelled && next->first > m_now) m_now = next->first;
+    waiter.woken = true;
+    m_queue.erase(next);
+    m_busy++;
+    m_wakeCount++;
+    waiter.wake.notify_one();
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <utility>
+#include "CancellationToken.h"
+
+// Source du temps du moteur : horloge système, ou horloge virtuelle en simulation.
+// Toutes les attentes des exécutions passent par SleepUntil().
+class MacroClock {
+public:
+    typedef std::chrono::steady_clock Clock;
+    typedef Clock::time_point TimePoint;
+    typedef uint64_t Activity;
+
+    virtual ~MacroClock() {}
+
+    virtual TimePoint Now() const = 0;
+
+    // Attendre l'échéance ; retourne false si le jeton a été annulé avant
+    virtual bool SleepUntil(TimePoint deadline, const CancellationToken* token = nullptr) = 0;
+
+    // Travail confié à un autre thread (exécution dans le pool, déclenchement en file) :
+    // BeginActivity() sur le thread qui le crée, EnterActivity() sur celui qui le
+    // traite, LeaveActivity() une fois fini, DropActivity() s'il n'est jamais traité.
+    // Sans effet sur l'horloge système.
+    virtual Activity BeginActivity() { return 0; }
+    virtual void EnterActivity(Activity activity) { (void)activity; }
+    virtual void LeaveActivity() {}
+    virtual void DropActivity(Activity activity) { (void)activity; }
+
+    // Horloge système, partagée
+    static MacroClock& System();
+};
+
+// Temps réel : steady_clock et attente précise de DeadlineTimer
+class SystemClock : public MacroClock {
+public:
+    TimePoint Now() const override { return Clock::now(); }
+    bool SleepUntil(TimePoint deadline, const CancellationToken* token = nullptr) override;
+};
+
+// Horloge de simulation : le temps ne s'écoule pas, il saute à la prochaine
+// échéance dès qu'aucun participant ne travaille plus. Des heures d'activité
+// s'exécutent ainsi en quelques millisecondes.
+// Les participants (exécutions, déclenchements en file, pilote attaché) sont
+// réveillés un par un, par échéance puis par ordre d'arrivée : une simulation
+// produit toujours la même chronologie, quel que soit l'ordonnancement des threads.
+// Une annulation est prise en compte à l'instant courant, avant toute avance.
+//
+// Le pilote (test, mesure) s'attache avec Attach() et fait avancer le temps par
+// SleepUntil() ou RunUntilIdle(). Attaché, il ne doit pas attendre autrement
+// (RunHandle::Join, StopExecution(true)) : le temps n'avancerait plus.
+class VirtualClock : public MacroClock {
+public:
+    // Début hors de l'époque : time_point() signifie "non renseigné" dans le moteur
+    explicit VirtualClock(TimePoint start = TimePoint(std::chrono::seconds(1)));
+
+    TimePoint Now() const override;
+    bool SleepUntil(TimePoint deadline, const CancellationToken* token = nullptr) override;
+
+    Activity BeginActivity() override;
+    void EnterActivity(Activity activity) override;
+    void LeaveActivity() override;
+    void DropActivity(Activity activity) override;
+
+    // Le thread appelant devient (ou cesse d'être) participant
+    void Attach();
+    void Detach();
+
+    // Laisser la simulation se dérouler jusqu'à ce que plus rien ne soit prévu
+    // (pilote attaché ; ne revient pas tant qu'une macro tourne en boucle)
+    void RunUntilIdle();
+
+    // Réveils effectués depuis la création (mesure du coût de l'ordonnanceur)
+    uint64_t WakeCount() const;
+
+private:
+    struct Waiter {
+        std::condition_variable wake;
+        const CancellationToken* token;
+        bool woken;
+        bool cancelled;
+    };
+
+    // Appelées avec m_mutex verrouillé
+    Activity AddWaiter(TimePoint deadline, const CancellationToken* token);
+    void Advance();
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_idle;
+    TimePoint m_now;
+    size_t m_busy;                                  // Participants en train de travailler
+    Activity m_nextActivity;
+    uint64_t m_wakeCount;
+    std::set<std::pair<TimePoint, Activity>> m_queue;   // Échéances, puis ordre d'arrivée
+    std::map<Activity, Waiter> m_waiters;
+};
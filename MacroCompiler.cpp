@@ -0,0 +1,107 @@
+#include "MacroCompiler.h"
+#include "KeyTable.h"
+#include <cwchar>
+
+namespace {
+
+// Modificateur correspondant à un VK, 0 si ce n'en est pas un
+uint8_t ModifierFor(int vk) {
+    switch (vk) {
+        case 0x10: case 0xA0: case 0xA1: return KEYMOD_SHIFT;   // VK_SHIFT, VK_LSHIFT, VK_RSHIFT
+        case 0x11: case 0xA2: case 0xA3: return KEYMOD_CTRL;    // VK_CONTROL, VK_LCONTROL, VK_RCONTROL
+        case 0x12: case 0xA4: case 0xA5: return KEYMOD_ALT;     // VK_MENU, VK_LMENU, VK_RMENU
+        case 0x5B: case 0x5C:            return KEYMOD_WIN;     // VK_LWIN, VK_RWIN
+        default:                         return 0;
+    }
+}
+
+// Résoudre "Q", "F1" ou un accord "CTRL+SHIFT+X" ; retourne false si une touche est inconnue
+bool ResolveKeys(const wchar_t* keys, size_t length, MacroInstruction& ins) {
+    uint8_t modifiers = 0;
+    size_t start = 0;
+
+    while (true) {
+        size_t end = start;
+        while (end < length && keys[end] != L'+') end++;
+
+        // Enlever les espaces autour du segment
+        size_t a = start, b = end;
+        while (a < b && (keys[a] == L' ' || keys[a] == L'\t')) a++;
+        while (b > a && (keys[b - 1] == L' ' || keys[b - 1] == L'\t')) b--;
+
+        int vk = KeyTable::Lookup(keys + a, b - a);
+        if (vk == 0) return false;
+
+        if (end == length) {
+            // Dernier segment : la touche principale
+            ins.vk = (uint16_t)vk;
+            ins.modifiers = modifiers;
+            return true;
+        }
+
+        // Segments précédents : uniquement des modificateurs
+        uint8_t mod = ModifierFor(vk);
+        if (mod == 0) return false;
+        modifiers |= mod;
+        start = end + 1;
+    }
+}
+
+MacroInstruction Compile(const std::wstring& action) {
+    MacroInstruction ins;
+
+    // Même ordre de reconnaissance que l'ancien parseur texte de MacroExecutor
+    if (action.find(L"Click") != std::wstring::npos) {
+        // Format: "Click Left", "Click Right", "Click Middle", "Click XButton1"
+        ins.op = MacroOp::MouseClick;
+        if (action.find(L"Left") != std::wstring::npos) ins.button = MouseButton::Left;
+        else if (action.find(L"Right") != std::wstring::npos) ins.button = MouseButton::Right;
+        else if (action.find(L"Middle") != std::wstring::npos) ins.button = MouseButton::Middle;
+        else if (action.find(L"XButton1") != std::wstring::npos) ins.button = MouseButton::X1;
+        else if (action.find(L"XButton2") != std::wstring::npos) ins.button = MouseButton::X2;
+        else ins.op = MacroOp::Nop;
+    }
+    else if (action.find(L"Press") != std::wstring::npos) {
+        // Format: "Press Q", "Press F1" ou "Press CTRL+SHIFT+X"
+        size_t pos = action.find(L"Press") + 5; // "Press" = 5 caractères
+        if (ResolveKeys(action.data() + pos, action.size() - pos, ins)) {
+            ins.op = MacroOp::KeyPress;
+        }
+    }
+    else if (action.find(L"Wait") != std::wstring::npos) {
+        // Format: "Wait 500ms" ou "Wait 1000"
+        size_t pos = action.find_first_of(L"0123456789");
+        if (pos != std::wstring::npos) {
+            ins.op = MacroOp::Wait;
+            ins.durationMs = (uint32_t)wcstoul(action.c_str() + pos, nullptr, 10);
+        }
+    }
+    else {
+        // Pour les combos de jeu, format simple: "Q - Skill name"
+        static const wchar_t skillKeys[] = { L'Q', L'W', L'E', L'R' };
+        for (wchar_t k : skillKeys) {
+            if (action.find(k) != std::wstring::npos) {
+                ins.op = MacroOp::KeyPress;
+                ins.vk = (uint16_t)k; // VK des lettres = code ASCII majuscule
+                break;
+            }
+        }
+    }
+
+    return ins;
+}
+
+} // namespace
+
+MacroInstruction MacroCompiler::CompileAction(const std::wstring& action) {
+    return Compile(action);
+}
+
+std::vector<MacroInstruction> MacroCompiler::CompileActions(const std::vector<std::wstring>& actions) {
+    std::vector<MacroInstruction> program;
+    program.reserve(actions.size());
+    for (const auto& action : actions) {
+        program.push_back(Compile(action));
+    }
+    return program;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "InputSink.h"
+
+// Opcodes des instructions compilées
+enum class MacroOp : uint8_t {
+    Nop,        // Action non reconnue (conservée pour garder l'alignement avec les actions)
+    KeyPress,   // Appuyer puis relâcher une touche (avec modificateurs éventuels)
+    MouseClick, // Clic souris
+    Wait        // Attente en millisecondes
+};
+
+// Modificateurs d'un accord ("Press CTRL+SHIFT+X"), combinables
+enum KeyModifierFlags : uint8_t {
+    KEYMOD_CTRL  = 0x01,
+    KEYMOD_SHIFT = 0x02,
+    KEYMOD_ALT   = 0x04,
+    KEYMOD_WIN   = 0x08
+};
+
+// Instruction pré-parsée : opcode + paramètre déjà résolu (12 octets)
+struct MacroInstruction {
+    MacroOp op;
+    MouseButton button;     // Pour MouseClick
+    uint8_t modifiers;      // KeyModifierFlags pour KeyPress
+    uint16_t vk;            // Virtual key pour KeyPress
+    uint32_t durationMs;    // Pour Wait
+
+    MacroInstruction() : op(MacroOp::Nop), button(MouseButton::Left), modifiers(0), vk(0), durationMs(0) {}
+};
+
+// Compile les chaînes d'action ("Press Q", "Press CTRL+SHIFT+X", "Click Left", "Wait 500ms", "Q - Skill")
+// en instructions typées. Appelé quand une macro est sauvegardée ou chargée,
+// pour que les threads d'exécution n'aient plus à parser de texte.
+class MacroCompiler {
+public:
+    // Compiler une seule action
+    static MacroInstruction CompileAction(const std::wstring& action);
+
+    // Compiler une liste d'actions (une instruction par action, même ordre)
+    static std::vector<MacroInstruction> CompileActions(const std::vector<std::wstring>& actions);
+};
@@ -1,188 +1,295 @@
 #include "MacroExecutor.h"
-#include "MacroManager.h"      // ← Pour les structures BasicMacro, etc.
-#include "HotkeyManager.h"     // ← Pour GetVirtualKeyCode
-#include <thread>
+#include "MacroStore.h"
+#include "InputBatcher.h"
+#include "PyramidMatcher.h"
+#include <algorithm>
 
-MacroExecutor::MacroExecutor()
-    : m_isExecuting(false)
-    , m_executionThread(nullptr)
+#ifdef _WIN32
+#include "Win32InputSink.h"
+#include "Win32ScreenCapture.h"
+#include <windows.h>
+#include <mmsystem.h>          // ← Pour timeBeginPeriod
+
+#pragma comment(lib, "winmm.lib")
+#else
+#include "NullInputSink.h"
+#endif
+
+namespace {
+
+// Durées nominales des étapes (ms)
+const uint32_t KEY_HOLD_MS = 50;    // Maintien d'une touche / d'un clic
+const uint32_t ACTION_GAP_MS = 50;  // Délai entre les actions
+const uint32_t LOOP_GAP_MS = 100;   // Délai entre deux boucles
+
+// Workers démarrés d'avance / plafond en cas de nombreuses macros simultanées
+const size_t POOL_INITIAL_THREADS = 4;
+const size_t POOL_MAX_THREADS = 64;
+
+// Ordre d'appui des modificateurs d'un accord (relâchés dans l'ordre inverse)
+const struct { uint8_t flag; uint16_t vk; } CHORD_MODIFIERS[] = {
+    { KEYMOD_CTRL,  0x11 },    // VK_CONTROL
+    { KEYMOD_SHIFT, 0x10 },    // VK_SHIFT
+    { KEYMOD_ALT,   0x12 },    // VK_MENU
+    { KEYMOD_WIN,   0x5B }     // VK_LWIN
+};
+const int CHORD_MODIFIER_COUNT = sizeof(CHORD_MODIFIERS) / sizeof(CHORD_MODIFIERS[0]);
+
+} // namespace
+
+// Contexte d'une exécution : échéancier + lot d'entrées en attente.
+// Les événements d'un même instant partent ensemble ; le lot est envoyé
+// dès que le temps doit avancer.
+struct MacroExecutor::ExecutionContext {
+    DeadlineTimer timer;
+    InputBatcher input;
+
+    ExecutionContext(TimingStats* stats, const MacroRun& run, InputSink& sink, MacroClock& clock)
+        : timer(stats, &run.Token(), &clock)
+        , input(sink)
+    {
+    }
+
+    // Retourne false si l'attente a été interrompue par un arrêt
+    bool Wait(uint32_t ms) {
+        if (ms == 0) return true;
+        input.Flush();
+        return timer.WaitFor(ms);
+    }
+};
+
+#ifdef _WIN32
+typedef Win32InputSink DefaultInputSink;
+#else
+typedef NullInputSink DefaultInputSink;    // Pas d'injection implicite hors Windows
+#endif
+
+MacroExecutor::MacroExecutor(InputSink* sink, MacroClock* clock)
+    : m_defaultSink(sink ? nullptr : new DefaultInputSink())
+    , m_sink(sink ? sink : m_defaultSink.get())
+    , m_clock(clock ? *clock : MacroClock::System())
+    , m_nextRunId(1)
+    , m_pool(POOL_INITIAL_THREADS, POOL_MAX_THREADS)
 {
+#ifdef _WIN32
+    // Granularité du sommeil système à 1 ms pour la phase grossière de DeadlineTimer
+    timeBeginPeriod(1);
+    m_frameCapture = [](GrayImage& frame) {
+        Win32ScreenCapture capture;
+        return capture.Capture(frame);
+    };
+#endif
 }
 
 MacroExecutor::~MacroExecutor() {
-    StopExecution();
+    StopExecution(true);
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+    // m_pool est détruit en premier et joint ses workers
 }
 
-void MacroExecutor::ExecuteBasicMacro(const BasicMacro& macro) {
-    if (m_isExecuting) return;
-
-    m_isExecuting = true;
-
-    // Créer un thread pour l'exécution
-    std::thread([this, macro]() {
-        do {
-            // Exécuter toutes les actions
-            for (const auto& action : macro.actions) {
-                if (!m_isExecuting) break;
-                ExecuteAction(action);
-                Sleep(50); // Petit délai entre les actions
-            }
-
-            // Si mode loop, ajouter un délai avant de recommencer
-            if (macro.loop && m_isExecuting) {
-                Sleep(100); // Délai entre les boucles
-            }
-        } while (macro.loop && m_isExecuting);
-
-        m_isExecuting = false;
-    }).detach();
-}
+RunHandle MacroExecutor::ExecuteMacro(std::shared_ptr<const MacroStore> store, MacroView macro,
+                                      Clock::time_point triggeredAt, FinishedCallback onFinished) {
+    // Le worker parcourt les instructions compilées en place, dans le store
+    // qu'il garde en vie : rien n'est copié au déclenchement
+    const MacroInstruction* program = macro.Program();
+    size_t programSize = macro.ProgramSize();
+
+    switch (macro.Kind()) {
+        case MacroKind::Basic: {
+            bool loop = macro.Loop();
+            return StartRun([this, store = std::move(store), program, programSize, loop](MacroRun& run) {
+                // Toutes les étapes sont planifiées sur des échéances absolues,
+                // et chaque attente est interrompue dès l'arrêt de l'exécution
+                ExecutionContext ctx(&m_timingStats, run, *m_sink, m_clock);
 
-void MacroExecutor::ExecuteComboMacro(const ComboMacro& macro) {
-    if (m_isExecuting) return;
+                do {
+                    // Exécuter toutes les instructions
+                    for (size_t i = 0; i < programSize; i++) {
+                        if (run.StopRequested()) break;
+                        ExecuteInstruction(program[i], ctx);
+                        ctx.Wait(ACTION_GAP_MS); // Petit délai entre les actions
+                    }
 
-    m_isExecuting = true;
+                    // Si mode loop, ajouter un délai avant de recommencer
+                    if (loop && !run.StopRequested()) {
+                        ctx.Wait(LOOP_GAP_MS); // Délai entre les boucles
+                    }
+                } while (loop && !run.StopRequested());
+            }, triggeredAt, std::move(onFinished));
+        }
+
+        case MacroKind::Combo: {
+            int delayBetween = macro.DelayBetween();
+            return StartRun([this, store = std::move(store), program, programSize, delayBetween](MacroRun& run) {
+                ExecutionContext ctx(&m_timingStats, run, *m_sink, m_clock);
 
-    std::thread([this, macro]() {
-        // Exécuter chaque skill avec délai
-        for (const auto& skill : macro.skills) {
-            if (!m_isExecuting) break;
+                // Exécuter chaque skill avec délai
+                for (size_t i = 0; i < programSize; i++) {
+                    if (run.StopRequested()) break;
 
-            ExecuteAction(skill);
+                    ExecuteInstruction(program[i], ctx);
 
-            // Attendre le délai entre les skills
-            Sleep(macro.delayBetween);
+                    // Attendre le délai entre les skills
+                    ctx.Wait(delayBetween > 0 ? (uint32_t)delayBetween : 0);
+                }
+            }, triggeredAt, std::move(onFinished));
         }
-        m_isExecuting = false;
-    }).detach();
-}
 
-void MacroExecutor::ExecuteImageMacro(const ImageMacro& macro) {
-    // Pour l'instant, juste exécuter l'action
-    // TODO: Ajouter la détection d'image avec OpenCV
-    ExecuteAction(macro.action);
+        case MacroKind::Image:
+        default: {
+            // L'action ne part que si le modèle est à l'écran avec la confiance demandée
+            const wchar_t* imagePath = macro.ImagePath();
+            float minScore = macro.Confidence() / 100.0f;
+            ImageSearchMode mode = macro.SearchMode();
+            return StartRun([this, store = std::move(store), program, programSize, imagePath, minScore, mode](MacroRun& run) {
+                ExecutionContext ctx(&m_timingStats, run, *m_sink, m_clock);
+                if (programSize > 0 && DetectImage(imagePath, minScore, mode) && !run.StopRequested()) {
+                    ExecuteInstruction(program[0], ctx);
+                }
+            }, triggeredAt, std::move(onFinished));
+        }
+    }
 }
 
-void MacroExecutor::StopExecution() {
-    m_isExecuting = false;
-
-    // Attendre un peu pour que le thread se termine
-    Sleep(100);
+RunHandle MacroExecutor::ExecuteDetected(std::shared_ptr<const MacroStore> store, MacroView macro,
+                                         Clock::time_point triggeredAt) {
+    const MacroInstruction* program = macro.Program();
+    size_t programSize = macro.ProgramSize();
+    return StartRun([this, store = std::move(store), program, programSize](MacroRun& run) {
+        ExecutionContext ctx(&m_timingStats, run, *m_sink, m_clock);
+        if (programSize > 0 && !run.StopRequested()) {
+            ExecuteInstruction(program[0], ctx);
+        }
+    }, triggeredAt, nullptr);
 }
 
-void MacroExecutor::ExecuteAction(const std::wstring& action) {
-    // Parser l'action pour savoir quoi faire
+void MacroExecutor::SetFrameCapture(FrameCapture capture) {
+    std::lock_guard<std::mutex> lock(m_runsMutex);
+    m_frameCapture = std::move(capture);
+}
 
-    if (action.find(L"Click") != std::wstring::npos) {
-        // Action de clic souris
-        if (action.find(L"Left") != std::wstring::npos) {
-            SimulateMouseClick(L"LEFT");
-        } else if (action.find(L"Right") != std::wstring::npos) {
-            SimulateMouseClick(L"RIGHT");
-        }
+bool MacroExecutor::DetectImage(const wchar_t* imagePath, float minScore, ImageSearchMode mode) {
+    FrameCapture capture;
+    {
+        std::lock_guard<std::mutex> lock(m_runsMutex);
+        capture = m_frameCapture;
     }
-    else if (action.find(L"Press") != std::wstring::npos) {
-        // Action de pression de touche
-        // Format: "Press Q" ou "Press F1"
-        size_t pos = action.find(L"Press");
-        if (pos != std::wstring::npos) {
-            std::wstring key = action.substr(pos + 5); // "Press" = 5 caractères
-            // Enlever les espaces au début et à la fin
-            key.erase(0, key.find_first_not_of(L" \t"));
-            key.erase(key.find_last_not_of(L" \t") + 1);
-
-            SimulateKeyPress(key);
+    if (!capture || imagePath[0] == L'\0') return false;
+
+    std::shared_ptr<const CachedTemplate> pattern = m_templates.Get(imagePath, mode);
+    if (!pattern) return false;
+
+    GrayImage screen;
+    if (!capture(screen)) return false;
+
+    MatchPyramid pyramid;
+    pyramid.Prepare(screen, pattern->matcher.Levels(), pattern->matcher.ScansFullResolution(minScore));
+    return pattern->matcher.FindBest(pyramid, minScore).found;
+}
+
+void MacroExecutor::StopExecution(bool join) {
+    std::vector<std::shared_ptr<MacroRun>> runs;
+    {
+        std::lock_guard<std::mutex> lock(m_runsMutex);
+        for (auto& run : m_runs) {
+            run->RequestStop();
         }
+        if (join) runs = m_runs;
     }
-    else if (action.find(L"Wait") != std::wstring::npos) {
-        // Action d'attente
-        // Format: "Wait 500ms" ou "Wait 1000"
-        size_t pos = action.find_first_of(L"0123456789");
-        if (pos != std::wstring::npos) {
-            int delay = _wtoi(action.substr(pos).c_str());
-            Sleep(delay);
-        }
+
+    // Attente synchrone optionnelle, hors verrou
+    for (auto& run : runs) {
+        run->Join();
     }
-    else if (action.find(L"Q") != std::wstring::npos ||
-             action.find(L"W") != std::wstring::npos ||
-             action.find(L"E") != std::wstring::npos ||
-             action.find(L"R") != std::wstring::npos) {
-        // Pour les combos de jeu, format simple: "Q - Skill name"
-        std::wstring key;
-        if (action.find(L"Q") != std::wstring::npos) key = L"Q";
-        else if (action.find(L"W") != std::wstring::npos) key = L"W";
-        else if (action.find(L"E") != std::wstring::npos) key = L"E";
-        else if (action.find(L"R") != std::wstring::npos) key = L"R";
-
-        if (!key.empty()) {
-            SimulateKeyPress(key);
-        }
+}
+
+bool MacroExecutor::IsExecuting() const {
+    std::lock_guard<std::mutex> lock(m_runsMutex);
+    for (const auto& run : m_runs) {
+        if (run->IsActive()) return true;
     }
+    return false;
 }
 
-void MacroExecutor::SimulateKeyPress(const std::wstring& key) {
-    HotkeyManager hkm;
-    int vk = hkm.GetVirtualKeyCode(key);
-    if (vk == 0) return;
+RunHandle MacroExecutor::StartRun(std::function<void(MacroRun&)> body, Clock::time_point triggeredAt,
+                                  FinishedCallback onFinished) {
+    auto run = std::make_shared<MacroRun>(m_nextRunId++);
 
-    INPUT input = {0};
-    input.type = INPUT_KEYBOARD;
-    input.ki.wVk = vk;
+    {
+        std::lock_guard<std::mutex> lock(m_runsMutex);
+        // Oublier les exécutions terminées
+        m_runs.erase(std::remove_if(m_runs.begin(), m_runs.end(),
+                                    [](const std::shared_ptr<MacroRun>& r) { return !r->IsActive(); }),
+                     m_runs.end());
+        m_runs.push_back(run);
+    }
 
-    // Key down (appuyer sur la touche)
-    SendInput(1, &input, sizeof(INPUT));
-    Sleep(50); // Maintenir 50ms
+    // En simulation, l'exécution prend son tour dans l'échéancier dès maintenant
+    MacroClock::Activity activity = m_clock.BeginActivity();
 
-    // Key up (relâcher la touche)
-    input.ki.dwFlags = KEYEVENTF_KEYUP;
-    SendInput(1, &input, sizeof(INPUT));
-}
+    m_pool.Submit([this, run, activity, body = std::move(body), triggeredAt, onFinished = std::move(onFinished)]() {
+        m_clock.EnterActivity(activity);
+        run->MarkRunning();
+        if (triggeredAt != Clock::time_point()) {
+            m_startLatency.Record(std::chrono::duration_cast<std::chrono::microseconds>(
+                m_clock.Now() - triggeredAt).count());
+        }
+        if (!run->StopRequested()) {
+            body(*run);
+        }
+        run->MarkFinished();
 
-void MacroExecutor::SimulateKeyDown(const std::wstring& key) {
-    HotkeyManager hkm;
-    int vk = hkm.GetVirtualKeyCode(key);
-    if (vk == 0) return;
+        // Après MarkFinished : l'appelant peut enchaîner une nouvelle exécution
+        if (onFinished) onFinished();
+        m_clock.LeaveActivity();
+    });
 
-    INPUT input = {0};
-    input.type = INPUT_KEYBOARD;
-    input.ki.wVk = vk;
-    SendInput(1, &input, sizeof(INPUT));
+    return RunHandle(run);
 }
 
-void MacroExecutor::SimulateKeyUp(const std::wstring& key) {
-    HotkeyManager hkm;
-    int vk = hkm.GetVirtualKeyCode(key);
-    if (vk == 0) return;
-
-    INPUT input = {0};
-    input.type = INPUT_KEYBOARD;
-    input.ki.wVk = vk;
-    input.ki.dwFlags = KEYEVENTF_KEYUP;
-    SendInput(1, &input, sizeof(INPUT));
+void MacroExecutor::ExecuteInstruction(const MacroInstruction& ins, ExecutionContext& ctx) {
+    // Plus de parsing ici : tout a été résolu par MacroCompiler
+    switch (ins.op) {
+        case MacroOp::KeyPress:
+            SimulateKeyPress(ins, ctx);
+            break;
+        case MacroOp::MouseClick:
+            SimulateMouseClick(ins.button, ctx);
+            break;
+        case MacroOp::Wait:
+            ctx.Wait(ins.durationMs);
+            break;
+        case MacroOp::Nop:
+            break;
+    }
 }
 
-void MacroExecutor::SimulateMouseClick(const std::wstring& button) {
-    INPUT input = {0};
-    input.type = INPUT_MOUSE;
-
-    if (button == L"LEFT") {
-        // Clic gauche
-        input.mi.dwFlags = MOUSEEVENTF_LEFTDOWN;
-        SendInput(1, &input, sizeof(INPUT));
-        Sleep(50);
-        input.mi.dwFlags = MOUSEEVENTF_LEFTUP;
-        SendInput(1, &input, sizeof(INPUT));
+void MacroExecutor::SimulateKeyPress(const MacroInstruction& ins, ExecutionContext& ctx) {
+    if (ins.vk == 0) return;
+
+    // Key down : modificateurs puis touche, dans un seul lot
+    for (int i = 0; i < CHORD_MODIFIER_COUNT; i++) {
+        if (ins.modifiers & CHORD_MODIFIERS[i].flag) {
+            ctx.input.Add(InputEvent::Key(CHORD_MODIFIERS[i].vk, true));
+        }
     }
-    else if (button == L"RIGHT") {
-        // Clic droit
-        input.mi.dwFlags = MOUSEEVENTF_RIGHTDOWN;
-        SendInput(1, &input, sizeof(INPUT));
-        Sleep(50);
-        input.mi.dwFlags = MOUSEEVENTF_RIGHTUP;
-        SendInput(1, &input, sizeof(INPUT));
+    ctx.input.Add(InputEvent::Key(ins.vk, true));
+
+    ctx.Wait(KEY_HOLD_MS); // Maintenir 50ms (même si l'attente est interrompue, on relâche)
+
+    // Key up : touche puis modificateurs en ordre inverse
+    ctx.input.Add(InputEvent::Key(ins.vk, false));
+    for (int i = CHORD_MODIFIER_COUNT - 1; i >= 0; i--) {
+        if (ins.modifiers & CHORD_MODIFIERS[i].flag) {
+            ctx.input.Add(InputEvent::Key(CHORD_MODIFIERS[i].vk, false));
+        }
     }
 }
 
-void MacroExecutor::SimulateMouseMove(int x, int y) {
-    SetCursorPos(x, y);
+void MacroExecutor::SimulateMouseClick(MouseButton button, ExecutionContext& ctx) {
+    ctx.input.Add(InputEvent::Mouse(button, true));
+    ctx.Wait(KEY_HOLD_MS);
+    ctx.input.Add(InputEvent::Mouse(button, false));
 }
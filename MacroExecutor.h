@@ -1,47 +1,108 @@
 #pragma once
-#include <windows.h>
 #include <string>
 #include <vector>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include "GrayImage.h"
+#include "InputSink.h"
+#include "MacroCompiler.h"
+#include "MacroRun.h"
+#include "PreciseTimer.h"
+#include "TemplateCache.h"
+#include "WorkerPool.h"
 
-// Forward declarations
-struct BasicMacro;
-struct ImageMacro;
-struct ComboMacro;
+class MacroStore;
+class MacroView;
+enum class ImageSearchMode : uint8_t;
 
 // Classe pour excuter les macros
+// Chaque dclenchement est une excution indpendante (MacroRun) confie au pool
 class MacroExecutor {
 public:
-    MacroExecutor();
+    // sink : destination des entres simules (par dfaut SendInput sous Windows,
+    // aucune ailleurs : passer un UinputInputSink pour injecter sous Linux)
+    // clock : source du temps (systme par dfaut). Avec une VirtualClock, les
+    // excutions sont simules ; au plus 64 excutions simultanes (taille du pool).
+    explicit MacroExecutor(InputSink* sink = nullptr, MacroClock* clock = nullptr);
     ~MacroExecutor();
 
-    // Excuter une macro basique
-    void ExecuteBasicMacro(const BasicMacro& macro);
+    typedef DeadlineTimer::Clock Clock;
 
-    // Excuter une macro d'image
-    void ExecuteImageMacro(const ImageMacro& macro);
+    MacroClock& GetClock() const { return m_clock; }
 
-    // Excuter une macro combo
-    void ExecuteComboMacro(const ComboMacro& macro);
+    // Capture de l'cran pour les macros image : remplit l'image, false si
+    // indisponible. Par dfaut l'cran principal sous Windows, aucune ailleurs
+    // (les macros image ne se dclenchent alors jamais).
+    typedef std::function<bool(GrayImage&)> FrameCapture;
+    void SetFrameCapture(FrameCapture capture);
 
-    // Arrter l'excution
-    void StopExecution();
+    typedef std::function<void()> FinishedCallback;
 
-    // tat d'excution
-    bool IsExecuting() const { return m_isExecuting; }
+    // triggeredAt : instant du dclenchement (front de touche), pour mesurer
+    // la latence dclenchement -> dbut d'excution ; ignor si non renseign.
+    // onFinished : appel sur le worker une fois l'excution termine.
+
+    // Excuter une macro du store (basique, image ou combo selon macro.Kind()).
+    // L'excution garde le store en vie et lit ses instructions sur place.
+    RunHandle ExecuteMacro(std::shared_ptr<const MacroStore> store, MacroView macro,
+                           Clock::time_point triggeredAt = Clock::time_point(),
+                           FinishedCallback onFinished = nullptr);
+
+    // Macro image dont le modle vient d'tre trouv sur une capture (ImageMonitor) :
+    // l'action part sans nouvelle capture ni recherche
+    RunHandle ExecuteDetected(std::shared_ptr<const MacroStore> store, MacroView macro,
+                              Clock::time_point triggeredAt = Clock::time_point());
+
+    // Arrter toutes les excutions (non bloquant ; join = attendre leur fin)
+    void StopExecution(bool join = false);
+
+    // Au moins une excution en cours
+    bool IsExecuting() const;
+
+    // Erreur de timing par tape (rveil rel - chance)
+    TimingStats::Report GetTimingReport() const { return m_timingStats.GetReport(); }
+
+    // Latence dclenchement -> dbut d'excution sur un worker, en s
+    TimingStats::Report GetStartLatencyReport() const { return m_startLatency.GetReport(); }
+
+    // Modles des macros image, dcods et prpars une fois par fichier
+    TemplateCache& GetTemplateCache() { return m_templates; }
 
 private:
-    bool m_isExecuting;
-    HANDLE m_executionThread;
+    struct ExecutionContext;
+
+    TimingStats m_timingStats;
+    TimingStats m_startLatency;
+
+    std::unique_ptr<InputSink> m_defaultSink;
+    InputSink* m_sink;
+    MacroClock& m_clock;
+    FrameCapture m_frameCapture;            // Protg par m_runsMutex
+    TemplateCache m_templates;
+
+    // Excutions actives (pour StopExecution / IsExecuting)
+    mutable std::mutex m_runsMutex;
+    std::vector<std::shared_ptr<MacroRun>> m_runs;
+    std::atomic<uint64_t> m_nextRunId;
+
+    // Dclar en dernier : dtruit (et joint) avant les membres utiliss par les workers
+    WorkerPool m_pool;
+
+    // Enregistrer une excution et la confier au pool
+    RunHandle StartRun(std::function<void(MacroRun&)> body, Clock::time_point triggeredAt,
+                       FinishedCallback onFinished);
+
+    // Capturer l'cran et y chercher le modle imagePath (score NCC >= minScore)
+    bool DetectImage(const wchar_t* imagePath, float minScore, ImageSearchMode mode);
 
-    // Excuter une action individuelle
-    void ExecuteAction(const std::wstring& action);
+    // Excuter une instruction compile
+    void ExecuteInstruction(const MacroInstruction& ins, ExecutionContext& ctx);
 
-    // Simuler une touche
-    void SimulateKeyPress(const std::wstring& key);
-    void SimulateKeyDown(const std::wstring& key);
-    void SimulateKeyUp(const std::wstring& key);
+    // Simuler une touche ou un accord (CTRL+SHIFT+X)
+    void SimulateKeyPress(const MacroInstruction& ins, ExecutionContext& ctx);
 
     // Simuler la souris
-    void SimulateMouseClick(const std::wstring& button);
-    void SimulateMouseMove(int x, int y);
+    void SimulateMouseClick(MouseButton button, ExecutionContext& ctx);
 };
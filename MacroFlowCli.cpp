@@ -0,0 +1,535 @@
+// macroflow : exécution des macros sans interface graphique (Linux, Windows)
+//
+//   macroflow list    [-f macros.json]
+//   macroflow run     <nom> [-f macros.json] [--sink null|record|uinput] [--duration ms] [--simulate]
+//                     [--frame image]
+//   macroflow trigger <touche> [-f macros.json] [--sink ...] [--count n] [--interval ms] [--simulate]
+//   macroflow monitor [-f macros.json] [--sink ...] --device /dev/input/eventN
+//   macroflow watch   [image...] [-f macros.json] [--sink ...] [--duration ms] [--interval ms]
+//   macroflow match   <image> <modèle> [--confidence n] [--search exact|balanced|fast]
+//   macroflow bench   [nom|all] [--macros n] [--iterations n] [--dir répertoire]
+#include "FileFrameSource.h"
+#include "FramePipeline.h"
+#include "ImageFile.h"
+#include "ImageMonitor.h"
+#include "KeyTable.h"
+#include "MacroBench.h"
+#include "MacroClock.h"
+#include "MacroExecutor.h"
+#include "MacroManager.h"
+#include "MacroStore.h"
+#include "NullInputSink.h"
+#include "PyramidMatcher.h"
+#include "RecordingInputSink.h"
+#include "SyntheticFrameSource.h"
+#include "TriggerDispatcher.h"
+#include "Utf8.h"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include "EvdevKeySource.h"
+#include "UinputInputSink.h"
+#endif
+
+namespace {
+
+struct CliOptions {
+    std::string command;
+    std::vector<std::string> arguments;     // Arguments positionnels après la commande
+    std::string file;
+    std::string sink;
+    std::string device;
+    std::string directory;
+    std::string frame;
+    std::string search;
+    long durationMs;
+    long count;
+    long intervalMs;
+    long macroCount;
+    long iterations;
+    long confidence;
+    bool simulate;
+
+    CliOptions() : file("macros.json"), sink("null"), directory("."), search("balanced"), durationMs(10000),
+                   count(1), intervalMs(0), macroCount(1000), iterations(20), confidence(85), simulate(false) {}
+};
+
+std::atomic<bool> g_interrupted(false);
+
+void OnSignal(int) {
+    g_interrupted = true;
+}
+
+int Usage() {
+    fprintf(stderr,
+            "usage : macroflow <commande> [options]\n"
+            "  list                     lister les macros\n"
+            "  run <nom>                exécuter une macro\n"
+            "  trigger <touche>         simuler l'appui d'un hotkey\n"
+            "  monitor                  déclencher depuis un clavier (--device)\n"
+            "  watch [image...]         lancer les macros image vues dans des images\n"
+            "                           (écran synthétique sans image)\n"
+            "  match <image> <modèle>   chercher un modèle dans une image\n"
+            "  bench [nom|all]          mesures du moteur (%s)\n"
+            "options :\n"
+            "  -f <fichier>             macros (défaut : macros.json)\n"
+            "  --sink null|record|uinput  destination des entrées (défaut : null)\n"
+            "  --duration <ms>          durée maximale de run (défaut : 10000)\n"
+            "  --count <n>              appuis pour trigger (défaut : 1)\n"
+            "  --interval <ms>          délai entre deux appuis de trigger, période de\n"
+            "                           capture de watch (défaut : 0)\n"
+            "  --simulate               temps virtuel : --duration s'écoule sans attendre\n"
+            "  --device <chemin>        périphérique evdev pour monitor\n"
+            "  --frame <image>          image tenant lieu d'écran pour run (macros image)\n"
+            "  --confidence <n>         score minimal de match, en %% (défaut : 85)\n"
+            "  --search <mode>          exact|balanced|fast pour match (défaut : balanced)\n"
+            "  --macros <n> --iterations <n> --dir <répertoire>  options de bench\n",
+            MacroBench::Names().c_str());
+    return 2;
+}
+
+bool ParseArguments(int argc, char** argv, CliOptions& options) {
+    if (argc < 2) return false;
+    options.command = argv[1];
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (arg == "-f" && hasValue) options.file = argv[++i];
+        else if (arg == "--sink" && hasValue) options.sink = argv[++i];
+        else if (arg == "--device" && hasValue) options.device = argv[++i];
+        else if (arg == "--dir" && hasValue) options.directory = argv[++i];
+        else if (arg == "--duration" && hasValue) options.durationMs = atol(argv[++i]);
+        else if (arg == "--count" && hasValue) options.count = atol(argv[++i]);
+        else if (arg == "--interval" && hasValue) options.intervalMs = atol(argv[++i]);
+        else if (arg == "--simulate") options.simulate = true;
+        else if (arg == "--frame" && hasValue) options.frame = argv[++i];
+        else if (arg == "--confidence" && hasValue) options.confidence = atol(argv[++i]);
+        else if (arg == "--search" && hasValue) options.search = argv[++i];
+        else if (arg == "--macros" && hasValue) options.macroCount = atol(argv[++i]);
+        else if (arg == "--iterations" && hasValue) options.iterations = atol(argv[++i]);
+        else if (!arg.empty() && arg[0] == '-') return false;
+        else options.arguments.push_back(arg);
+    }
+    return true;
+}
+
+const char* KindName(MacroKind kind) {
+    switch (kind) {
+        case MacroKind::Image: return "image";
+        case MacroKind::Combo: return "combo";
+        default:               return "basic";
+    }
+}
+
+std::string Narrow(const wchar_t* text) {
+    return Utf8::FromWide(std::wstring(text));
+}
+
+bool LoadStore(const CliOptions& options, std::shared_ptr<const MacroStore>& store) {
+    MacroManager macros;
+    if (!macros.LoadFromFile(Utf8::ToWide(options.file))) {
+        fprintf(stderr, "impossible de lire %s\n", options.file.c_str());
+        return false;
+    }
+    macros.AssignIds();
+    store = MacroStore::Build(macros);
+    return true;
+}
+
+// --frame : image fixe tenant lieu d'écran pour la détection des macros image
+bool SetupFrame(const CliOptions& options, MacroExecutor& executor) {
+    if (options.frame.empty()) return true;
+    std::shared_ptr<GrayImage> frame = std::make_shared<GrayImage>();
+    if (!ImageFile::LoadGray(Utf8::ToWide(options.frame), *frame)) {
+        fprintf(stderr, "image illisible : %s\n", options.frame.c_str());
+        return false;
+    }
+    executor.SetFrameCapture([frame](GrayImage& out) {
+        out = *frame;
+        return true;
+    });
+    return true;
+}
+
+// Destination des entrées selon --sink ; nullptr si indisponible.
+// clock : horloge de la simulation, pour horodater l'enregistrement.
+std::unique_ptr<InputSink> CreateSink(const std::string& name, MacroClock* clock) {
+    if (name == "null") return std::unique_ptr<InputSink>(new NullInputSink());
+    if (name == "record") return std::unique_ptr<InputSink>(new RecordingInputSink(clock));
+#ifdef __linux__
+    if (name == "uinput" && !clock) {
+        std::unique_ptr<UinputInputSink> sink(new UinputInputSink());
+        if (!sink->Open()) {
+            fprintf(stderr, "impossible d'ouvrir /dev/uinput (droits ?)\n");
+            return nullptr;
+        }
+        return sink;
+    }
+#endif
+    fprintf(stderr, "sink inconnu : %s\n", name.c_str());
+    return nullptr;
+}
+
+// Chronologie des lots enregistrés (--sink record)
+void PrintRecording(const InputSink& sink) {
+    const RecordingInputSink* recording = dynamic_cast<const RecordingInputSink*>(&sink);
+    if (!recording) return;
+
+    std::vector<RecordingInputSink::Batch> batches = recording->GetBatches();
+    if (batches.empty()) return;
+    for (const auto& batch : batches) {
+        double ms = std::chrono::duration<double, std::milli>(batch.time - batches.front().time).count();
+        printf("%9.3f ms ", ms);
+        for (const InputEvent& e : batch.events) {
+            switch (e.type) {
+                case InputEvent::Type::KeyDown:   printf(" key+%02X", e.vk); break;
+                case InputEvent::Type::KeyUp:     printf(" key-%02X", e.vk); break;
+                case InputEvent::Type::MouseDown: printf(" btn+%d", (int)e.button); break;
+                case InputEvent::Type::MouseUp:   printf(" btn-%d", (int)e.button); break;
+            }
+        }
+        printf("\n");
+    }
+}
+
+void PrintSinkSummary(const InputSink& sink) {
+    if (const NullInputSink* null = dynamic_cast<const NullInputSink*>(&sink)) {
+        printf("%llu lots, %llu événements\n", (unsigned long long)null->BatchCount(),
+               (unsigned long long)null->EventCount());
+    }
+    PrintRecording(sink);
+}
+
+// Cache des modèles des macros image, s'il a servi
+void PrintTemplateSummary(MacroExecutor& executor) {
+    TemplateCache::Stats stats = executor.GetTemplateCache().GetStats();
+    if (stats.lookups == 0) return;
+    printf("modèles : %llu accès, %.1f %% en cache, %llu décodages (%llu rechargements), %zu modèles, %zu octets\n",
+           (unsigned long long)stats.lookups, 100.0 * stats.hits / (double)stats.lookups,
+           (unsigned long long)stats.loads, (unsigned long long)stats.reloads, stats.entries, stats.residentBytes);
+}
+
+// Temps simulé et temps réel écoulé (--simulate)
+void PrintSimulationSummary(const VirtualClock* simulation, MacroClock::TimePoint simulatedStart,
+                            std::chrono::steady_clock::time_point started) {
+    if (!simulation) return;
+    double realMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    double simulatedMs = std::chrono::duration<double, std::milli>(simulation->Now() - simulatedStart).count();
+    printf("simulation : %.0f ms simulées en %.1f ms, %llu réveils\n", simulatedMs, realMs,
+           (unsigned long long)simulation->WakeCount());
+}
+
+int CommandList(const CliOptions& options) {
+    std::shared_ptr<const MacroStore> store;
+    if (!LoadStore(options, store)) return 1;
+
+    const MacroKind kinds[] = { MacroKind::Basic, MacroKind::Image, MacroKind::Combo };
+    for (MacroKind kind : kinds) {
+        for (size_t i = 0; i < store->Count(kind); i++) {
+            MacroView macro = store->At(kind, i);
+            printf("%-6s %c %-10s %s\n", KindName(kind), macro.Enabled() ? '*' : ' ',
+                   Narrow(macro.Hotkey()).c_str(), Narrow(macro.Name()).c_str());
+        }
+    }
+    return 0;
+}
+
+int CommandRun(const CliOptions& options) {
+    if (options.arguments.size() != 1) return Usage();
+
+    std::shared_ptr<const MacroStore> store;
+    if (!LoadStore(options, store)) return 1;
+
+    std::wstring name = Utf8::ToWide(options.arguments[0]);
+    MacroView macro;
+    for (uint32_t row = 0; row < store->Size() && !macro.IsValid(); row++) {
+        MacroView candidate = store->Find(store->IdData()[row]);
+        if (name == candidate.Name()) macro = candidate;
+    }
+    if (!macro.IsValid()) {
+        fprintf(stderr, "macro introuvable : %s\n", options.arguments[0].c_str());
+        return 1;
+    }
+
+    std::unique_ptr<VirtualClock> simulation(options.simulate ? new VirtualClock() : nullptr);
+    std::unique_ptr<InputSink> sink = CreateSink(options.sink, simulation.get());
+    if (!sink) return 1;
+
+    MacroClock::TimePoint simulatedStart = simulation ? simulation->Now() : MacroClock::TimePoint();
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    {
+        MacroExecutor executor(sink.get(), simulation.get());
+        if (!SetupFrame(options, executor)) return 1;
+        if (simulation) simulation->Attach();
+
+        RunHandle run = executor.ExecuteMacro(store, macro);
+
+        // Les macros en boucle tournent jusqu'à --duration ou Ctrl+C
+        MacroClock::TimePoint deadline = executor.GetClock().Now() + std::chrono::milliseconds(options.durationMs);
+        if (simulation) {
+            simulation->SleepUntil(deadline);
+        } else {
+            while (run.IsRunning() && !g_interrupted && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+        }
+        run.Stop();
+
+        // Détaché, le pilote laisse la simulation traiter l'arrêt
+        if (simulation) simulation->Detach();
+        run.Join();
+        PrintTemplateSummary(executor);
+    }
+
+    PrintSinkSummary(*sink);
+    PrintSimulationSummary(simulation.get(), simulatedStart, started);
+    return 0;
+}
+
+int CommandTrigger(const CliOptions& options) {
+    if (options.arguments.size() != 1) return Usage();
+
+    int vk = KeyTable::Lookup(Utf8::ToWide(options.arguments[0]));
+    if (vk <= 0) {
+        fprintf(stderr, "touche inconnue : %s\n", options.arguments[0].c_str());
+        return 1;
+    }
+
+    std::shared_ptr<const MacroStore> store;
+    if (!LoadStore(options, store)) return 1;
+    std::unique_ptr<VirtualClock> simulation(options.simulate ? new VirtualClock() : nullptr);
+    std::unique_ptr<InputSink> sink = CreateSink(options.sink, simulation.get());
+    if (!sink) return 1;
+
+    MacroClock::TimePoint simulatedStart = simulation ? simulation->Now() : MacroClock::TimePoint();
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    {
+        MacroExecutor executor(sink.get(), simulation.get());
+        MacroClock& clock = executor.GetClock();
+        TriggerDispatcher dispatcher(executor);
+        dispatcher.Publish(store);
+        dispatcher.Start();
+        if (simulation) simulation->Attach();
+
+        MacroClock::TimePoint next = clock.Now();
+        size_t posted = 0;
+        for (long i = 0; i < options.count; i++) {
+            if (i > 0 && options.intervalMs > 0) {
+                next += std::chrono::milliseconds(options.intervalMs);
+                clock.SleepUntil(next);
+            }
+            KeyEdge edge;
+            edge.vk = (uint16_t)vk;
+            edge.down = true;
+            posted += dispatcher.OnKeyEdge(edge);
+            edge.down = false;
+            dispatcher.OnKeyEdge(edge);
+        }
+        if (posted == 0) printf("aucune macro active sur %s\n", options.arguments[0].c_str());
+
+        // Attendre la fin des exécutions (et des attentes en file), au plus --duration
+        MacroClock::TimePoint deadline = clock.Now() + std::chrono::milliseconds(options.durationMs);
+        if (simulation) {
+            simulation->SleepUntil(deadline);
+            simulation->Detach();
+        } else {
+            do {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            } while ((executor.IsExecuting() || dispatcher.GetStats().depth > 0) && !g_interrupted &&
+                     std::chrono::steady_clock::now() < deadline);
+        }
+
+        dispatcher.Stop();
+        executor.StopExecution(true);
+
+        TriggerDispatcher::Stats stats = dispatcher.GetStats();
+        printf("%llu fronts postés, %llu traités, %llu perdus\n", (unsigned long long)stats.posted,
+               (unsigned long long)stats.dispatched, (unsigned long long)stats.dropped);
+        PrintTemplateSummary(executor);
+    }
+
+    PrintSinkSummary(*sink);
+    PrintSimulationSummary(simulation.get(), simulatedStart, started);
+    return 0;
+}
+
+int CommandMonitor(const CliOptions& options) {
+#ifdef __linux__
+    if (options.device.empty()) return Usage();
+
+    std::shared_ptr<const MacroStore> store;
+    if (!LoadStore(options, store)) return 1;
+    std::unique_ptr<InputSink> sink = CreateSink(options.sink, nullptr);
+    if (!sink) return 1;
+
+    MacroExecutor executor(sink.get());
+    TriggerDispatcher dispatcher(executor);
+    dispatcher.Publish(store);
+    dispatcher.Start();
+
+    EvdevKeySource source(options.device);
+    if (!source.Start([&dispatcher](const KeyEdge& edge) { dispatcher.OnKeyEdge(edge); })) {
+        fprintf(stderr, "impossible d'ouvrir %s\n", options.device.c_str());
+        return 1;
+    }
+
+    printf("monitoring de %s, Ctrl+C pour arrêter\n", options.device.c_str());
+    while (!g_interrupted) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    source.Stop();
+    dispatcher.Stop();
+    executor.StopExecution(true);
+    return 0;
+#else
+    (void)options;
+    fprintf(stderr, "monitor n'est disponible que sous Linux (evdev)\n");
+    return 1;
+#endif
+}
+
+// Détection continue comme dans l'interface : capture et recherche sur deux
+// threads ; les images données tiennent lieu d'écran, tour à tour
+int CommandWatch(const CliOptions& options) {
+    std::shared_ptr<const MacroStore> store;
+    if (!LoadStore(options, store)) return 1;
+
+    std::unique_ptr<FrameSource> source;
+    if (options.arguments.empty()) {
+        source.reset(new SyntheticFrameSource());
+    } else {
+        std::vector<std::wstring> paths;
+        for (const std::string& argument : options.arguments) paths.push_back(Utf8::ToWide(argument));
+        std::unique_ptr<FileFrameSource> files(new FileFrameSource());
+        std::wstring failed;
+        if (!files->Open(paths, &failed)) {
+            fprintf(stderr, "image illisible : %s\n", Utf8::FromWide(failed).c_str());
+            return 1;
+        }
+        source = std::move(files);
+    }
+
+    std::unique_ptr<InputSink> sink = CreateSink(options.sink, nullptr);
+    if (!sink) return 1;
+    {
+        MacroExecutor executor(sink.get());
+        ImageMonitor monitor(executor.GetTemplateCache(),
+                             [&executor](const std::shared_ptr<const MacroStore>& current, MacroView macro,
+                                         FramePipeline::Clock::time_point capturedAt) {
+                                 printf("%s : modèle trouvé\n", Narrow(macro.Name()).c_str());
+                                 executor.ExecuteDetected(current, macro, capturedAt);
+                             });
+        monitor.Publish(store);
+
+        FramePipeline pipeline;
+        pipeline.Start(*source, (int)options.intervalMs, [&monitor](const CapturedFrame& frame) {
+            monitor.ProcessFrame(frame);
+        });
+        std::chrono::steady_clock::time_point deadline =
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(options.durationMs);
+        while (!g_interrupted && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        pipeline.Stop();
+        executor.StopExecution(true);
+
+        FramePipeline::Stats frames = pipeline.GetStats();
+        ImageMonitor::Stats detection = monitor.GetStats();
+        TimingStats::Report frameTime = monitor.GetFrameTimeReport();
+        TimingStats::Report age = pipeline.GetFrameAgeReport();
+        printf("%llu images capturées, %llu traitées, %llu sautées, %llu captures en échec\n",
+               (unsigned long long)frames.captured, (unsigned long long)frames.processed,
+               (unsigned long long)frames.skipped, (unsigned long long)frames.failed);
+        printf("%llu recherches, %llu détections, %.2f ms par image (max %.2f), image prise après %.2f ms en moyenne\n",
+               (unsigned long long)detection.searches, (unsigned long long)detection.detections,
+               frameTime.meanErrorUs / 1000.0, frameTime.maxErrorUs / 1000.0, age.meanErrorUs / 1000.0);
+        printf("%llu recherches limitées aux tuiles modifiées, %llu évitées ; %llu tuiles modifiées sur %llu\n",
+               (unsigned long long)detection.partial, (unsigned long long)detection.skipped,
+               (unsigned long long)detection.tilesChanged, (unsigned long long)detection.tiles);
+        PrintTemplateSummary(executor);
+    }
+
+    PrintSinkSummary(*sink);
+    return 0;
+}
+
+int CommandMatch(const CliOptions& options) {
+    ImageSearchMode mode;
+    if (options.arguments.size() < 2 || !MacroManager::ParseImageSearchMode(options.search, mode)) return Usage();
+
+    GrayImage screen, pattern;
+    for (size_t i = 0; i < 2; i++) {
+        if (!ImageFile::LoadGray(Utf8::ToWide(options.arguments[i]), i == 0 ? screen : pattern)) {
+            fprintf(stderr, "image illisible : %s\n", options.arguments[i].c_str());
+            return 1;
+        }
+    }
+
+    PyramidMatcher matcher;
+    if (!matcher.SetTemplate(pattern, PyramidSettings::For(mode))) {
+        fprintf(stderr, "modèle vide, uniforme ou trop grand : %s\n", options.arguments[1].c_str());
+        return 1;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const float minScore = options.confidence / 100.0f;
+    MatchPyramid pyramid;
+    pyramid.Prepare(screen, matcher.Levels(), matcher.ScansFullResolution(minScore));
+    MatchResult result = matcher.FindBest(pyramid, minScore);
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (result.found) {
+        printf("trouvé en (%d, %d), score %.3f\n", result.x, result.y, result.score);
+    } else {
+        printf("absent (confiance %ld %%)\n", options.confidence);
+    }
+    printf("modèle %dx%d, image %dx%d, recherche %s (%d niveau%s), noyau %s, %.1f ms, "
+           "%zu positions dont %zu corrélées entièrement\n",
+           pattern.width, pattern.height, screen.width, screen.height, options.search.c_str(),
+           matcher.Levels(), matcher.Levels() > 1 ? "x" : "", TemplateMatcher::KernelName(TemplateMatcher::BestKernel()),
+           elapsedMs, result.positions, result.completed);
+    return result.found ? 0 : 1;
+}
+
+int CommandBench(const CliOptions& options) {
+    MacroBench::Options bench;
+    bench.macroCount = options.macroCount > 0 ? (size_t)options.macroCount : 1;
+    bench.iterations = options.iterations > 0 ? (size_t)options.iterations : 1;
+    bench.directory = options.directory;
+
+    std::string name = options.arguments.empty() ? "all" : options.arguments[0];
+    if (!MacroBench::Run(name, bench)) {
+        fprintf(stderr, "mesure inconnue : %s (%s)\n", name.c_str(), MacroBench::Names().c_str());
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    CliOptions options;
+    if (!ParseArguments(argc, argv, options)) return Usage();
+
+    std::signal(SIGINT, OnSignal);
+    std::signal(SIGTERM, OnSignal);
+
+    if (options.command == "list") return CommandList(options);
+    if (options.command == "run") return CommandRun(options);
+    if (options.command == "trigger") return CommandTrigger(options);
+    if (options.command == "monitor") return CommandMonitor(options);
+    if (options.command == "watch") return CommandWatch(options);
+    if (options.command == "match") return CommandMatch(options);
+    if (options.command == "bench") return CommandBench(options);
+    return Usage();
+}
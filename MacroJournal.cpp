@@ -0,0 +1,462 @@
+#include "MacroJournal.h"
+#include "AtomicFile.h"
+#include "MappedFile.h"
+#include "Utf8.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char JOURNAL_MAGIC[8] = { 'M', 'F', 'J', 'R', 'N', 'L', 0, 0 };
+
+struct JournalHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+};
+
+// En-tête d'enregistrement, suivi de payloadSize octets
+struct RecordHeader {
+    uint32_t payloadSize;
+    uint32_t checksum;          // FNV-1a sur la suite de l'en-tête et le contenu
+    uint64_t sequence;
+    uint8_t op;
+    uint8_t kind;
+    uint16_t reserved;
+    uint32_t index;
+};
+
+uint32_t Checksum(const unsigned char* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Somme de contrôle d'un enregistrement complet (champ checksum exclu)
+uint32_t RecordChecksum(const unsigned char* record, size_t size) {
+    const size_t skip = offsetof(RecordHeader, sequence);
+    return Checksum(record + skip, size - skip);
+}
+
+// Encodage des macros : entiers little-endian, chaînes UTF-8 préfixées par leur longueur
+class Writer {
+public:
+    void U8(uint8_t value) { m_data += (char)value; }
+    void U32(uint32_t value) { m_data.append((const char*)&value, sizeof(value)); }
+    void I32(int32_t value) { m_data.append((const char*)&value, sizeof(value)); }
+
+    void String(const std::wstring& str) {
+        size_t lengthPos = m_data.size();
+        U32(0);
+        Utf8::AppendFromWide(str.data(), str.size(), m_data);
+        uint32_t length = (uint32_t)(m_data.size() - lengthPos - sizeof(uint32_t));
+        memcpy(&m_data[lengthPos], &length, sizeof(length));
+    }
+
+    void Strings(const std::vector<std::wstring>& strings) {
+        U32((uint32_t)strings.size());
+        for (const auto& str : strings) String(str);
+    }
+
+    std::string& Data() { return m_data; }
+
+private:
+    std::string m_data;
+};
+
+class Reader {
+public:
+    Reader(const unsigned char* data, size_t size) : m_pos(data), m_end(data + size), m_ok(true) {}
+
+    bool Ok() const { return m_ok; }
+    bool AtEnd() const { return m_pos == m_end; }
+
+    uint8_t U8() {
+        uint8_t value = 0;
+        Read(&value, sizeof(value));
+        return value;
+    }
+
+    uint32_t U32() {
+        uint32_t value = 0;
+        Read(&value, sizeof(value));
+        return value;
+    }
+
+    int32_t I32() {
+        int32_t value = 0;
+        Read(&value, sizeof(value));
+        return value;
+    }
+
+    std::wstring String() {
+        uint32_t length = U32();
+        std::wstring result;
+        if (!m_ok || (size_t)(m_end - m_pos) < length) {
+            m_ok = false;
+            return result;
+        }
+        Utf8::AppendToWide((const char*)m_pos, length, result);
+        m_pos += length;
+        return result;
+    }
+
+    std::vector<std::wstring> Strings() {
+        uint32_t count = U32();
+        std::vector<std::wstring> result;
+        // Chaque chaîne occupe au moins 4 octets : borne contre un compte aberrant
+        if (!m_ok || count > (size_t)(m_end - m_pos) / sizeof(uint32_t)) {
+            m_ok = false;
+            return result;
+        }
+        result.reserve(count);
+        for (uint32_t i = 0; i < count && m_ok; i++) {
+            result.push_back(String());
+        }
+        return result;
+    }
+
+private:
+    void Read(void* out, size_t size) {
+        if (!m_ok || (size_t)(m_end - m_pos) < size) {
+            m_ok = false;
+            return;
+        }
+        memcpy(out, m_pos, size);
+        m_pos += size;
+    }
+
+    const unsigned char* m_pos;
+    const unsigned char* m_end;
+    bool m_ok;
+};
+
+std::string Encode(const BasicMacro& m) {
+    Writer w;
+    w.String(m.name);
+    w.String(m.hotkey);
+    w.Strings(m.actions);
+    w.U8(m.enabled);
+    w.U8(m.loop);
+    w.U8(m.holdMode);
+    w.U8((uint8_t)m.overloadPolicy);
+    w.I32(m.queueLimit);
+    return std::move(w.Data());
+}
+
+std::string Encode(const ImageMacro& m) {
+    Writer w;
+    w.String(m.name);
+    w.String(m.imagePath);
+    w.String(m.action);
+    w.I32(m.confidence);
+    w.U8(m.enabled);
+    w.U8((uint8_t)m.searchMode);
+    return std::move(w.Data());
+}
+
+std::string Encode(const ComboMacro& m) {
+    Writer w;
+    w.String(m.name);
+    w.String(m.hotkey);
+    w.Strings(m.skills);
+    w.I32(m.delayBetween);
+    w.U8(m.detectCooldown);
+    w.U8(m.enabled);
+    w.U8((uint8_t)m.overloadPolicy);
+    w.I32(m.queueLimit);
+    return std::move(w.Data());
+}
+
+bool Decode(Reader& r, BasicMacro& m) {
+    m.name = r.String();
+    m.hotkey = r.String();
+    m.actions = r.Strings();
+    m.enabled = r.U8() != 0;
+    m.loop = r.U8() != 0;
+    m.holdMode = r.U8() != 0;
+    uint8_t policy = r.U8();
+    m.overloadPolicy = (OverloadPolicy)policy;
+    m.queueLimit = r.I32();
+    m.program = MacroCompiler::CompileActions(m.actions);
+    return r.Ok() && r.AtEnd() && policy <= (uint8_t)OverloadPolicy::Coalesce;
+}
+
+bool Decode(Reader& r, ImageMacro& m) {
+    m.name = r.String();
+    m.imagePath = r.String();
+    m.action = r.String();
+    m.confidence = r.I32();
+    m.enabled = r.U8() != 0;
+    uint8_t mode = r.U8();
+    m.searchMode = (ImageSearchMode)mode;
+    return r.Ok() && r.AtEnd() && mode <= (uint8_t)ImageSearchMode::Fast;
+}
+
+bool Decode(Reader& r, ComboMacro& m) {
+    m.name = r.String();
+    m.hotkey = r.String();
+    m.skills = r.Strings();
+    m.delayBetween = r.I32();
+    m.detectCooldown = r.U8() != 0;
+    m.enabled = r.U8() != 0;
+    uint8_t policy = r.U8();
+    m.overloadPolicy = (OverloadPolicy)policy;
+    m.queueLimit = r.I32();
+    m.program = MacroCompiler::CompileActions(m.skills);
+    return r.Ok() && r.AtEnd() && policy <= (uint8_t)OverloadPolicy::Coalesce;
+}
+
+// Appliquer une opération à un vecteur de macros
+template <typename T>
+bool ApplyTo(std::vector<T>& macros, MacroJournal::Op op, uint32_t index, Reader& payload) {
+    switch (op) {
+        case MacroJournal::Op::Add: {
+            T macro = {};
+            if (!Decode(payload, macro)) return false;
+            macros.push_back(std::move(macro));
+            return true;
+        }
+        case MacroJournal::Op::Update: {
+            T macro = {};
+            if (index >= macros.size() || !Decode(payload, macro)) return false;
+            macro.id = macros[index].id;
+            macros[index] = std::move(macro);
+            return true;
+        }
+        case MacroJournal::Op::Delete:
+            if (index >= macros.size()) return false;
+            macros.erase(macros.begin() + index);
+            return true;
+        case MacroJournal::Op::SetEnabled:
+            if (index >= macros.size()) return false;
+            macros[index].enabled = payload.U8() != 0;
+            return payload.Ok();
+    }
+    return false;
+}
+
+bool Apply(MacroManager& macros, MacroJournal::Op op, MacroKind kind, uint32_t index, Reader& payload) {
+    switch (kind) {
+        case MacroKind::Basic: return ApplyTo(macros.basicMacros, op, index, payload);
+        case MacroKind::Image: return ApplyTo(macros.imageMacros, op, index, payload);
+        case MacroKind::Combo: return ApplyTo(macros.comboMacros, op, index, payload);
+    }
+    return false;
+}
+
+// Ajout en fin de fichier, vidé sur disque
+bool AppendToFile(const std::wstring& path, const std::string& bytes) {
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), FILE_APPEND_DATA, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    DWORD written = 0;
+    bool ok = WriteFile(file, bytes.data(), (DWORD)bytes.size(), &written, nullptr) &&
+              written == bytes.size() && FlushFileBuffers(file);
+    CloseHandle(file);
+    return ok;
+#else
+    int fd = open(Utf8::FromWide(path).c_str(), O_WRONLY | O_APPEND);
+    if (fd < 0) return false;
+
+    bool ok = write(fd, bytes.data(), bytes.size()) == (ssize_t)bytes.size() && fsync(fd) == 0;
+    close(fd);
+    return ok;
+#endif
+}
+
+} // namespace
+
+MacroJournal::MacroJournal()
+    : m_open(false)
+    , m_lastSequence(0)
+    , m_size(0)
+{
+}
+
+size_t MacroJournal::Open(const std::wstring& path, MacroManager& macros) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_path = path;
+    m_records.clear();
+    m_open = false;
+
+    // Enregistrements déjà inclus dans le JSON chargé
+    const uint64_t covered = macros.journalSequence;
+    m_lastSequence = covered;
+
+    size_t replayed = 0;
+    size_t validSize = sizeof(JournalHeader);
+    bool clean = false;
+
+    MappedFile file;
+    if (file.Open(path) && file.Size() >= sizeof(JournalHeader)) {
+        const unsigned char* data = file.Data();
+        JournalHeader header;
+        memcpy(&header, data, sizeof(header));
+
+        if (memcmp(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) == 0 && header.version == Version) {
+            size_t pos = sizeof(JournalHeader);
+            uint64_t previous = 0;
+            bool skipped = false;
+            while (file.Size() - pos >= sizeof(RecordHeader)) {
+                RecordHeader record;
+                memcpy(&record, data + pos, sizeof(record));
+                size_t recordSize = sizeof(RecordHeader) + record.payloadSize;
+                if (record.payloadSize > file.Size() - pos - sizeof(RecordHeader)) break;
+                if (RecordChecksum(data + pos, recordSize) != record.checksum) break;
+                if (record.sequence <= previous) break;
+
+                if (record.sequence <= covered) {
+                    // Arrêt entre l'écriture du JSON et Rebase : déjà appliqué
+                    skipped = true;
+                } else {
+                    // Numéro manquant : la suite ne s'applique pas à ce JSON
+                    if (record.sequence != std::max(previous, covered) + 1) break;
+
+                    Reader payload(data + pos + sizeof(RecordHeader), record.payloadSize);
+                    if (!Apply(macros, (Op)record.op, (MacroKind)record.kind, record.index, payload)) break;
+
+                    m_records.push_back(Record{ record.sequence, std::string((const char*)data + pos, recordSize) });
+                    m_lastSequence = record.sequence;
+                    replayed++;
+                }
+                previous = record.sequence;
+                pos += recordSize;
+            }
+            validSize = pos;
+            clean = !skipped && pos == file.Size();
+        }
+    }
+    file.Close();
+
+    if (clean) {
+        // Fichier intact : continuer à y ajouter
+        m_size = validSize;
+        m_open = true;
+    } else {
+        // Absent, d'une autre version, déjà inclus en partie ou fin tronquée :
+        // réécrire les enregistrements rejoués
+        m_open = Rewrite();
+    }
+    return replayed;
+}
+
+bool MacroJournal::HasRecordsAfter(const std::wstring& path, uint64_t sequence) {
+    MappedFile file;
+    if (!file.Open(path) || file.Size() < sizeof(JournalHeader)) return false;
+
+    // Sans vérifier les sommes de contrôle : au pire, un faux positif
+    const unsigned char* data = file.Data();
+    size_t pos = sizeof(JournalHeader);
+    while (file.Size() - pos >= sizeof(RecordHeader)) {
+        RecordHeader record;
+        memcpy(&record, data + pos, sizeof(record));
+        if (record.sequence > sequence) return true;
+        if (record.payloadSize > file.Size() - pos - sizeof(RecordHeader)) break;
+        pos += sizeof(RecordHeader) + record.payloadSize;
+    }
+    return false;
+}
+
+bool MacroJournal::IsOpen() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_open;
+}
+
+bool MacroJournal::AppendAdd(const BasicMacro& macro) { return Append(Op::Add, MacroKind::Basic, 0, Encode(macro)); }
+bool MacroJournal::AppendAdd(const ImageMacro& macro) { return Append(Op::Add, MacroKind::Image, 0, Encode(macro)); }
+bool MacroJournal::AppendAdd(const ComboMacro& macro) { return Append(Op::Add, MacroKind::Combo, 0, Encode(macro)); }
+
+bool MacroJournal::AppendUpdate(uint32_t index, const BasicMacro& macro) { return Append(Op::Update, MacroKind::Basic, index, Encode(macro)); }
+bool MacroJournal::AppendUpdate(uint32_t index, const ImageMacro& macro) { return Append(Op::Update, MacroKind::Image, index, Encode(macro)); }
+bool MacroJournal::AppendUpdate(uint32_t index, const ComboMacro& macro) { return Append(Op::Update, MacroKind::Combo, index, Encode(macro)); }
+
+bool MacroJournal::AppendDelete(MacroKind kind, uint32_t index) {
+    return Append(Op::Delete, kind, index, std::string());
+}
+
+bool MacroJournal::AppendSetEnabled(MacroKind kind, uint32_t index, bool enabled) {
+    return Append(Op::SetEnabled, kind, index, std::string(1, enabled ? '\1' : '\0'));
+}
+
+uint64_t MacroJournal::LastSequence() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lastSequence;
+}
+
+size_t MacroJournal::RecordCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_records.size();
+}
+
+bool MacroJournal::NeedsCompaction() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_open || m_size > CompactThresholdBytes;
+}
+
+bool MacroJournal::Rebase(uint64_t upToSequence) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_path.empty()) return false;
+
+    size_t kept = 0;
+    while (kept < m_records.size() && m_records[kept].sequence <= upToSequence) kept++;
+    m_records.erase(m_records.begin(), m_records.begin() + kept);
+
+    m_open = Rewrite();
+    return m_open;
+}
+
+bool MacroJournal::Append(Op op, MacroKind kind, uint32_t index, const std::string& payload) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    RecordHeader header = {};
+    header.payloadSize = (uint32_t)payload.size();
+    header.sequence = m_lastSequence + 1;
+    header.op = (uint8_t)op;
+    header.kind = (uint8_t)kind;
+    header.index = index;
+
+    std::string bytes((const char*)&header, sizeof(header));
+    bytes += payload;
+    uint32_t checksum = RecordChecksum((const unsigned char*)bytes.data(), bytes.size());
+    memcpy(&bytes[offsetof(RecordHeader, checksum)], &checksum, sizeof(checksum));
+
+    // Séquence consommée même en cas d'échec : la compaction couvrira la modification
+    m_lastSequence = header.sequence;
+    if (!m_open || !AppendToFile(m_path, bytes)) {
+        m_open = false;
+        return false;
+    }
+
+    m_size += bytes.size();
+    m_records.push_back(Record{ header.sequence, std::move(bytes) });
+    return true;
+}
+
+bool MacroJournal::Rewrite() {
+    // Appelé avec m_mutex verrouillé
+    JournalHeader header = {};
+    memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+    header.version = Version;
+
+    std::string content((const char*)&header, sizeof(header));
+    for (const auto& record : m_records) {
+        content += record.bytes;
+    }
+    if (!AtomicFile::Write(m_path, content)) return false;
+
+    m_size = content.size();
+    return true;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "MacroManager.h"
+
+// Journal des modifications de macros, en ajout seul (macros.journal).
+// Chaque édition ajoute un petit enregistrement au lieu de réécrire tout le
+// JSON ; au démarrage, le journal est rejoué par-dessus macros.json. Quand il
+// devient trop long, le JSON complet est réécrit et le journal ne garde que
+// les enregistrements suivants (Rebase).
+// Les enregistrements ont un numéro de séquence consécutif et une somme de
+// contrôle : une fin de fichier tronquée par un arrêt brutal est ignorée.
+// Le JSON (et le snapshot) portent le dernier numéro qu'ils incluent
+// (MacroManager::journalSequence) : un arrêt entre l'écriture du JSON et
+// Rebase laisse des enregistrements déjà inclus, qui ne sont pas rejoués.
+class MacroJournal {
+public:
+    enum class Op : uint8_t { Add, Update, Delete, SetEnabled };
+
+    static const uint32_t Version = 3;
+    static const size_t CompactThresholdBytes = 64 * 1024;
+
+    MacroJournal();
+
+    // Ouvrir le journal et rejouer sur macros les enregistrements qui suivent
+    // macros.journalSequence. Le rejeu s'arrête au premier numéro manquant (JSON
+    // plus ancien que le journal). Retourne le nombre d'enregistrements rejoués.
+    size_t Open(const std::wstring& path, MacroManager& macros);
+
+    // Le fichier contient peut-être des enregistrements après sequence (lecture
+    // des en-têtes seulement) : Open devra alors les rejouer sur les macros
+    static bool HasRecordsAfter(const std::wstring& path, uint64_t sequence);
+    bool IsOpen() const;
+
+    // Ajout d'un enregistrement (écrit et vidé sur disque avant de rendre la main)
+    bool AppendAdd(const BasicMacro& macro);
+    bool AppendAdd(const ImageMacro& macro);
+    bool AppendAdd(const ComboMacro& macro);
+    bool AppendUpdate(uint32_t index, const BasicMacro& macro);
+    bool AppendUpdate(uint32_t index, const ImageMacro& macro);
+    bool AppendUpdate(uint32_t index, const ComboMacro& macro);
+    bool AppendDelete(MacroKind kind, uint32_t index);
+    bool AppendSetEnabled(MacroKind kind, uint32_t index, bool enabled);
+
+    uint64_t LastSequence() const;
+    size_t RecordCount() const;
+
+    // Journal trop long (ou inutilisable) : réécrire le JSON complet
+    bool NeedsCompaction() const;
+
+    // Le JSON écrit contient tout jusqu'à upToSequence inclus (et le porte dans
+    // journalSequence) : ne garder que les enregistrements suivants
+    bool Rebase(uint64_t upToSequence);
+
+private:
+    struct Record {
+        uint64_t sequence;
+        std::string bytes;      // Enregistrement complet, tel qu'écrit dans le fichier
+    };
+
+    bool Append(Op op, MacroKind kind, uint32_t index, const std::string& payload);
+    bool Rewrite();
+
+    mutable std::mutex m_mutex;
+    std::wstring m_path;
+    bool m_open;
+    uint64_t m_lastSequence;
+    size_t m_size;                  // Taille du fichier
+    std::vector<Record> m_records;  // Enregistrements depuis la base
+};
@@ -1,126 +1,518 @@
 #include "MacroManager.h"
+#include "JsonSaxParser.h"
+#include "MacroSnapshot.h"
+#include "MacroJournal.h"
+#include "AtomicFile.h"
+#include "JsonWriter.h"
+#include "Utf8.h"
+#include <climits>
+#include <cstring>
 #include <fstream>
-#include <sstream>
-#include <locale>
-#include <codecvt>
 
-MacroManager::MacroManager() {}
-MacroManager::~MacroManager() {}
+namespace {
 
-std::wstring MacroManager::WStringToJson(const std::wstring& str) {
-    std::wstring result = L"\"";
-    for (wchar_t c : str) {
-        if (c == L'"') result += L"\\\"";
-        else if (c == L'\\') result += L"\\\\";
-        else if (c == L'\n') result += L"\\n";
-        else if (c == L'\r') result += L"\\r";
-        else if (c == L'\t') result += L"\\t";
-        else result += c;
+// Construit les macros au fil des vnements du parseur, pour le schma
+// crit par SaveToFile :
+//   { "journalSequence": n, "basicMacros": [ {...} ], "imageMacros": [ {...} ], "comboMacros": [ {...} ] }
+// Les cls inconnues sont ignores, les champs absents gardent les valeurs par dfaut.
+class MacroJsonHandler : public JsonSaxHandler {
+public:
+    MacroJsonHandler(std::vector<BasicMacro>& basicMacros, std::vector<ImageMacro>& imageMacros,
+                     std::vector<ComboMacro>& comboMacros, uint64_t& journalSequence)
+        : m_basicMacros(basicMacros)
+        , m_imageMacros(imageMacros)
+        , m_comboMacros(comboMacros)
+        , m_journalSequence(journalSequence)
+        , m_depth(0)
+        , m_rootSequence(false)
+        , m_section(Section::None)
+        , m_field(Field::Other)
+        , m_inMacro(false)
+        , m_list(nullptr)
+        , m_listDepth(0)
+    {
+    }
+
+    bool StartObject() override {
+        m_depth++;
+        if (m_depth == 3) m_inMacro = AddMacro(); // Une macro dans le tableau de sa section
+        return true;
+    }
+
+    bool EndObject() override {
+        if (m_depth == 3) m_inMacro = false;
+        m_depth--;
+        return true;
+    }
+
+    bool StartArray() override {
+        m_depth++;
+        if (m_depth == 3) m_inMacro = false;   // Tableau  la place d'une macro
+        // Liste d'actions / de skills d'une macro
+        if (m_depth == 4 && m_inMacro) {
+            m_list = ListForField();
+            m_listDepth = m_depth;
+        }
+        return true;
+    }
+
+    bool EndArray() override {
+        if (m_list && m_depth == m_listDepth) m_list = nullptr;
+        m_depth--;
+        return true;
+    }
+
+    bool Key(const char* str, size_t length) override {
+        if (m_depth == 1) {
+            // Nouvelle section : rien de la macro prcdente ne doit s'y appliquer
+            m_field = Field::Other;
+            m_rootSequence = Is(str, length, "journalSequence");
+            if (Is(str, length, "basicMacros")) m_section = Section::Basic;
+            else if (Is(str, length, "imageMacros")) m_section = Section::Image;
+            else if (Is(str, length, "comboMacros")) m_section = Section::Combo;
+            else m_section = Section::None;
+        } else if (m_depth == 3) {
+            m_field = FieldFor(str, length);
+        }
+        return true;
+    }
+
+    bool String(const char* str, size_t length) override {
+        if (m_depth == 4 && m_list) {
+            m_list->emplace_back();
+            Utf8::AppendToWide(str, length, m_list->back());
+            return true;
+        }
+        if (m_depth != 3 || !m_inMacro) return true;
+
+        if (m_field == Field::Policy) {
+            OverloadPolicy policy;
+            if (MacroManager::ParseOverloadPolicy(std::string(str, length), policy)) {
+                if (m_section == Section::Basic) m_basicMacros.back().overloadPolicy = policy;
+                else if (m_section == Section::Combo) m_comboMacros.back().overloadPolicy = policy;
+            }
+            return true;
+        }
+        if (m_field == Field::SearchMode) {
+            ImageSearchMode mode;
+            if (m_section == Section::Image && MacroManager::ParseImageSearchMode(std::string(str, length), mode)) {
+                m_imageMacros.back().searchMode = mode;
+            }
+            return true;
+        }
+
+        std::wstring* target = StringField();
+        if (target) {
+            target->clear();
+            Utf8::AppendToWide(str, length, *target);
+        }
+        return true;
+    }
+
+    bool Number(double value) override {
+        if (m_depth == 1 && m_rootSequence) {
+            // Hors de [0, 2^64) (NaN compris) : pas de squence
+            m_journalSequence = (value > 0 && value < 18446744073709551616.0) ? (uint64_t)value : 0;
+            return true;
+        }
+        if (m_depth != 3 || !m_inMacro || value != value) return true;
+        // Ramen dans les bornes d'un int avant conversion
+        int number = value >= (double)INT_MAX ? INT_MAX : value <= (double)INT_MIN ? INT_MIN : (int)value;
+
+        switch (m_section) {
+            case Section::Basic:
+                if (m_field == Field::QueueLimit) m_basicMacros.back().queueLimit = number;
+                break;
+            case Section::Image:
+                if (m_field == Field::Confidence) m_imageMacros.back().confidence = number;
+                break;
+            case Section::Combo:
+                if (m_field == Field::DelayBetween) m_comboMacros.back().delayBetween = number;
+                else if (m_field == Field::QueueLimit) m_comboMacros.back().queueLimit = number;
+                break;
+            default:
+                break;
+        }
+        return true;
     }
-    result += L"\"";
-    return result;
-}
+
+    bool Bool(bool value) override {
+        if (m_depth != 3 || !m_inMacro) return true;
+
+        switch (m_section) {
+            case Section::Basic: {
+                BasicMacro& m = m_basicMacros.back();
+                if (m_field == Field::Enabled) m.enabled = value;
+                else if (m_field == Field::Loop) m.loop = value;
+                else if (m_field == Field::HoldMode) m.holdMode = value;
+                break;
+            }
+            case Section::Image:
+                if (m_field == Field::Enabled) m_imageMacros.back().enabled = value;
+                break;
+            case Section::Combo: {
+                ComboMacro& m = m_comboMacros.back();
+                if (m_field == Field::Enabled) m.enabled = value;
+                else if (m_field == Field::DetectCooldown) m.detectCooldown = value;
+                break;
+            }
+            default:
+                break;
+        }
+        return true;
+    }
+
+    bool Null() override {
+        return true;
+    }
+
+private:
+    enum class Section { None, Basic, Image, Combo };
+    enum class Field {
+        Other, Name, Hotkey, Enabled, Loop, HoldMode, Policy, QueueLimit, Actions,
+        ImagePath, Action, Confidence, SearchMode, DelayBetween, DetectCooldown, Skills
+    };
+
+    static bool Is(const char* str, size_t length, const char* literal) {
+        return strlen(literal) == length && memcmp(str, literal, length) == 0;
+    }
+
+    static Field FieldFor(const char* str, size_t length) {
+        static const struct { const char* key; Field field; } FIELDS[] = {
+            { "name", Field::Name },
+            { "hotkey", Field::Hotkey },
+            { "enabled", Field::Enabled },
+            { "loop", Field::Loop },
+            { "holdMode", Field::HoldMode },
+            { "overloadPolicy", Field::Policy },
+            { "queueLimit", Field::QueueLimit },
+            { "actions", Field::Actions },
+            { "imagePath", Field::ImagePath },
+            { "action", Field::Action },
+            { "confidence", Field::Confidence },
+            { "searchMode", Field::SearchMode },
+            { "delayBetween", Field::DelayBetween },
+            { "detectCooldown", Field::DetectCooldown },
+            { "skills", Field::Skills }
+        };
+        for (const auto& entry : FIELDS) {
+            if (Is(str, length, entry.key)) return entry.field;
+        }
+        return Field::Other;
+    }
+
+    // Valeurs par dfaut identiques  celles des dialogues de cration.
+    // Retourne false hors d'une section de macros (objet ignor).
+    bool AddMacro() {
+        m_field = Field::Other;
+        switch (m_section) {
+            case Section::Basic: {
+                BasicMacro m = {};
+                m.enabled = true;
+                m.overloadPolicy = OverloadPolicy::DropNew;
+                m.queueLimit = 1;
+                m_basicMacros.push_back(std::move(m));
+                return true;
+            }
+            case Section::Image: {
+                ImageMacro m = {};
+                m.confidence = 85;
+                m.searchMode = ImageSearchMode::Balanced;
+                m.enabled = true;
+                m_imageMacros.push_back(std::move(m));
+                return true;
+            }
+            case Section::Combo: {
+                ComboMacro m = {};
+                m.delayBetween = 200;
+                m.detectCooldown = true;
+                m.enabled = true;
+                m.overloadPolicy = OverloadPolicy::DropNew;
+                m.queueLimit = 1;
+                m_comboMacros.push_back(std::move(m));
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    std::wstring* StringField() {
+        switch (m_section) {
+            case Section::Basic:
+                if (m_field == Field::Name) return &m_basicMacros.back().name;
+                if (m_field == Field::Hotkey) return &m_basicMacros.back().hotkey;
+                break;
+            case Section::Image:
+                if (m_field == Field::Name) return &m_imageMacros.back().name;
+                if (m_field == Field::ImagePath) return &m_imageMacros.back().imagePath;
+                if (m_field == Field::Action) return &m_imageMacros.back().action;
+                break;
+            case Section::Combo:
+                if (m_field == Field::Name) return &m_comboMacros.back().name;
+                if (m_field == Field::Hotkey) return &m_comboMacros.back().hotkey;
+                break;
+            default:
+                break;
+        }
+        return nullptr;
+    }
+
+    std::vector<std::wstring>* ListForField() {
+        if (m_section == Section::Basic && m_field == Field::Actions) return &m_basicMacros.back().actions;
+        if (m_section == Section::Combo && m_field == Field::Skills) return &m_comboMacros.back().skills;
+        return nullptr;
+    }
+
+    std::vector<BasicMacro>& m_basicMacros;
+    std::vector<ImageMacro>& m_imageMacros;
+    std::vector<ComboMacro>& m_comboMacros;
+    uint64_t& m_journalSequence;
+
+    int m_depth;                        // Conteneurs ouverts (1 = objet racine)
+    bool m_rootSequence;                // Dernire cl de l'objet racine : "journalSequence"
+    Section m_section;
+    Field m_field;                      // Dernire cl lue dans la macro courante
+    bool m_inMacro;                     // Objet de macro ouvert au niveau 3 (back() utilisable)
+    std::vector<std::wstring>* m_list;  // Tableau de chanes en cours de remplissage
+    int m_listDepth;                    // Niveau du tableau qui a ouvert m_list
+};
+
+} // namespace
+
+MacroManager::MacroManager() : journalSequence(0), m_journal(nullptr), m_nextId(1) {}
+MacroManager::~MacroManager() {}
 
 // Fonction helper pour convertir wstring en string
 std::string WStringToString(const std::wstring& wstr) {
-    if (wstr.empty()) return std::string();
-    int size_needed = WideCharToMultiByte(CP_UTF8, 0, &wstr[0], (int)wstr.size(), NULL, 0, NULL, NULL);
-    std::string strTo(size_needed, 0);
-    WideCharToMultiByte(CP_UTF8, 0, &wstr[0], (int)wstr.size(), &strTo[0], size_needed, NULL, NULL);
-    return strTo;
+    return Utf8::FromWide(wstr);
 }
 
 bool MacroManager::SaveToFile(const std::wstring& filename) {
-    // Convertir le nom de fichier en string pour MinGW
-    std::string filenameStr = WStringToString(filename);
-    std::ofstream file(filenameStr, std::ios::out | std::ios::binary);
-    if (!file.is_open()) return false;
+    // Remplacement atomique : un arrt en cours d'criture laisse l'ancien fichier intact
+    return AtomicFile::Write(filename, ToJson());
+}
+
+std::string MacroManager::ToJson() const {
+    // Tampon dimensionn d'aprs le texte des macros : pas de rallocation en cours d'criture
+    size_t estimate = 64;
+    for (const auto& m : basicMacros) {
+        estimate += 256 + m.name.size() + m.hotkey.size();
+        for (const auto& action : m.actions) estimate += 12 + action.size();
+    }
+    for (const auto& m : imageMacros) {
+        estimate += 192 + m.name.size() + m.imagePath.size() + m.action.size();
+    }
+    for (const auto& m : comboMacros) {
+        estimate += 256 + m.name.size() + m.hotkey.size();
+        for (const auto& skill : m.skills) estimate += 12 + skill.size();
+    }
+
+    std::string file;
+    file.reserve(estimate + estimate / 8);
+    JsonWriter json(file);
 
     // crire le BOM UTF-8 pour que Windows reconnaisse l'encodage
-    const unsigned char bom[] = { 0xEF, 0xBB, 0xBF };
-    file.write((const char*)bom, sizeof(bom));
+    json.Raw("\xEF\xBB\xBF");
 
-    file << "{\n";
+    json.Raw("{\n");
+    json.Raw("  \"journalSequence\": "); json.Int((int64_t)journalSequence); json.Raw(",\n");
 
     // Sauvegarder les macros basiques
-    file << "  \"basicMacros\": [\n";
+    json.Raw("  \"basicMacros\": [\n");
     for (size_t i = 0; i < basicMacros.size(); i++) {
         const auto& m = basicMacros[i];
-        file << "    {\n";
-        file << "      \"name\": " << WStringToString(WStringToJson(m.name)) << ",\n";
-        file << "      \"hotkey\": " << WStringToString(WStringToJson(m.hotkey)) << ",\n";
-        file << "      \"enabled\": " << (m.enabled ? "true" : "false") << ",\n";
-        file << "      \"loop\": " << (m.loop ? "true" : "false") << ",\n";
-        file << "      \"holdMode\": " << (m.holdMode ? "true" : "false") << ",\n";
-        file << "      \"actions\": [\n";
+        json.Raw("    {\n");
+        json.Raw("      \"name\": "); json.String(m.name); json.Raw(",\n");
+        json.Raw("      \"hotkey\": "); json.String(m.hotkey); json.Raw(",\n");
+        json.Raw("      \"enabled\": "); json.Bool(m.enabled); json.Raw(",\n");
+        json.Raw("      \"loop\": "); json.Bool(m.loop); json.Raw(",\n");
+        json.Raw("      \"holdMode\": "); json.Bool(m.holdMode); json.Raw(",\n");
+        json.Raw("      \"overloadPolicy\": \""); json.Raw(OverloadPolicyName(m.overloadPolicy)); json.Raw("\",\n");
+        json.Raw("      \"queueLimit\": "); json.Int(m.queueLimit); json.Raw(",\n");
+        json.Raw("      \"actions\": [\n");
         for (size_t j = 0; j < m.actions.size(); j++) {
-            file << "        " << WStringToString(WStringToJson(m.actions[j]));
-            if (j < m.actions.size() - 1) file << ",";
-            file << "\n";
+            json.Raw("        "); json.String(m.actions[j]);
+            json.Raw(j < m.actions.size() - 1 ? ",\n" : "\n");
         }
-        file << "      ]\n";
-        file << "    }";
-        if (i < basicMacros.size() - 1) file << ",";
-        file << "\n";
+        json.Raw("      ]\n");
+        json.Raw(i < basicMacros.size() - 1 ? "    },\n" : "    }\n");
     }
-    file << "  ],\n";
+    json.Raw("  ],\n");
 
     // Sauvegarder les macros d'image
-    file << "  \"imageMacros\": [\n";
+    json.Raw("  \"imageMacros\": [\n");
     for (size_t i = 0; i < imageMacros.size(); i++) {
         const auto& m = imageMacros[i];
-        file << "    {\n";
-        file << "      \"name\": " << WStringToString(WStringToJson(m.name)) << ",\n";
-        file << "      \"imagePath\": " << WStringToString(WStringToJson(m.imagePath)) << ",\n";
-        file << "      \"action\": " << WStringToString(WStringToJson(m.action)) << ",\n";
-        file << "      \"confidence\": " << m.confidence << ",\n";
-        file << "      \"enabled\": " << (m.enabled ? "true" : "false") << "\n";
-        file << "    }";
-        if (i < imageMacros.size() - 1) file << ",";
-        file << "\n";
-    }
-    file << "  ],\n";
+        json.Raw("    {\n");
+        json.Raw("      \"name\": "); json.String(m.name); json.Raw(",\n");
+        json.Raw("      \"imagePath\": "); json.String(m.imagePath); json.Raw(",\n");
+        json.Raw("      \"action\": "); json.String(m.action); json.Raw(",\n");
+        json.Raw("      \"confidence\": "); json.Int(m.confidence); json.Raw(",\n");
+        json.Raw("      \"searchMode\": \""); json.Raw(ImageSearchModeName(m.searchMode)); json.Raw("\",\n");
+        json.Raw("      \"enabled\": "); json.Bool(m.enabled); json.Raw("\n");
+        json.Raw(i < imageMacros.size() - 1 ? "    },\n" : "    }\n");
+    }
+    json.Raw("  ],\n");
 
     // Sauvegarder les macros combo
-    file << "  \"comboMacros\": [\n";
+    json.Raw("  \"comboMacros\": [\n");
     for (size_t i = 0; i < comboMacros.size(); i++) {
         const auto& m = comboMacros[i];
-        file << "    {\n";
-        file << "      \"name\": " << WStringToString(WStringToJson(m.name)) << ",\n";
-        file << "      \"hotkey\": " << WStringToString(WStringToJson(m.hotkey)) << ",\n";
-        file << "      \"delayBetween\": " << m.delayBetween << ",\n";
-        file << "      \"detectCooldown\": " << (m.detectCooldown ? "true" : "false") << ",\n";
-        file << "      \"enabled\": " << (m.enabled ? "true" : "false") << ",\n";
-        file << "      \"skills\": [\n";
+        json.Raw("    {\n");
+        json.Raw("      \"name\": "); json.String(m.name); json.Raw(",\n");
+        json.Raw("      \"hotkey\": "); json.String(m.hotkey); json.Raw(",\n");
+        json.Raw("      \"delayBetween\": "); json.Int(m.delayBetween); json.Raw(",\n");
+        json.Raw("      \"detectCooldown\": "); json.Bool(m.detectCooldown); json.Raw(",\n");
+        json.Raw("      \"enabled\": "); json.Bool(m.enabled); json.Raw(",\n");
+        json.Raw("      \"overloadPolicy\": \""); json.Raw(OverloadPolicyName(m.overloadPolicy)); json.Raw("\",\n");
+        json.Raw("      \"queueLimit\": "); json.Int(m.queueLimit); json.Raw(",\n");
+        json.Raw("      \"skills\": [\n");
         for (size_t j = 0; j < m.skills.size(); j++) {
-            file << "        " << WStringToString(WStringToJson(m.skills[j]));
-            if (j < m.skills.size() - 1) file << ",";
-            file << "\n";
+            json.Raw("        "); json.String(m.skills[j]);
+            json.Raw(j < m.skills.size() - 1 ? ",\n" : "\n");
         }
-        file << "      ]\n";
-        file << "    }";
-        if (i < comboMacros.size() - 1) file << ",";
-        file << "\n";
+        json.Raw("      ]\n");
+        json.Raw(i < comboMacros.size() - 1 ? "    },\n" : "    }\n");
     }
-    file << "  ]\n";
+    json.Raw("  ]\n");
 
-    file << "}\n";
-    file.close();
-    return true;
+    json.Raw("}\n");
+    return file;
 }
 
 bool MacroManager::LoadFromFile(const std::wstring& filename) {
     // Convertir le nom de fichier en string pour MinGW
     std::string filenameStr = WStringToString(filename);
-    std::ifstream file(filenameStr, std::ios::in | std::ios::binary);
+    std::ifstream file(filenameStr, std::ios::in | std::ios::binary | std::ios::ate);
     if (!file.is_open()) return false;
 
-    basicMacros.clear();
-    imageMacros.clear();
-    comboMacros.clear();
-
-    // Pour l'instant, retourne true mme si le parsing n'est pas implment
-    // TODO: Implmenter le parsing JSON complet
+    // Lecture du fichier en un bloc, puis analyse en un seul passage
+    std::streamoff size = file.tellg();
+    if (size < 0) return false;
+    std::string content((size_t)size, '\0');
+    file.seekg(0);
+    if (size > 0 && !file.read(&content[0], size)) return false;
     file.close();
+
+    // Macros construites  part : en cas d'erreur, les macros actuelles sont conserves
+    std::vector<BasicMacro> loadedBasic;
+    std::vector<ImageMacro> loadedImage;
+    std::vector<ComboMacro> loadedCombo;
+    uint64_t loadedSequence = 0;    // Absent des fichiers antrieurs au journal
+    MacroJsonHandler handler(loadedBasic, loadedImage, loadedCombo, loadedSequence);
+    if (!JsonSaxParser::Parse(content.data(), content.size(), handler)) return false;
+
+    basicMacros.swap(loadedBasic);
+    imageMacros.swap(loadedImage);
+    comboMacros.swap(loadedCombo);
+    journalSequence = loadedSequence;
+
+    CompileMacros();
+    return true;
+}
+
+bool MacroManager::SaveSnapshot(const std::wstring& snapshotPath, const std::wstring& sourcePath) const {
+    SnapshotSource source;
+    if (!MappedFile::Stat(sourcePath, source.size, source.writeTime)) return false;
+    return MacroSnapshot::Write(snapshotPath, source, journalSequence, basicMacros, imageMacros, comboMacros);
+}
+
+bool MacroManager::LoadSnapshot(const std::wstring& snapshotPath, const std::wstring& sourcePath) {
+    SnapshotSource source;
+    if (!MappedFile::Stat(sourcePath, source.size, source.writeTime)) return false;
+
+    MacroSnapshot snapshot;
+    if (!snapshot.Open(snapshotPath, source)) return false;
+
+    // Programmes dj compils : pas de CompileMacros()
+    snapshot.Materialize(basicMacros, imageMacros, comboMacros);
+    journalSequence = snapshot.JournalSequence();
+    return true;
+}
+
+void MacroManager::RecordAdded(MacroKind kind) {
+    if (!m_journal) return;
+    switch (kind) {
+        case MacroKind::Basic: if (!basicMacros.empty()) m_journal->AppendAdd(basicMacros.back()); break;
+        case MacroKind::Image: if (!imageMacros.empty()) m_journal->AppendAdd(imageMacros.back()); break;
+        case MacroKind::Combo: if (!comboMacros.empty()) m_journal->AppendAdd(comboMacros.back()); break;
+    }
+}
+
+void MacroManager::RecordUpdated(MacroKind kind, size_t index) {
+    if (!m_journal) return;
+    switch (kind) {
+        case MacroKind::Basic: if (index < basicMacros.size()) m_journal->AppendUpdate((uint32_t)index, basicMacros[index]); break;
+        case MacroKind::Image: if (index < imageMacros.size()) m_journal->AppendUpdate((uint32_t)index, imageMacros[index]); break;
+        case MacroKind::Combo: if (index < comboMacros.size()) m_journal->AppendUpdate((uint32_t)index, comboMacros[index]); break;
+    }
+}
+
+void MacroManager::RecordDeleted(MacroKind kind, size_t index) {
+    if (m_journal) m_journal->AppendDelete(kind, (uint32_t)index);
+}
+
+void MacroManager::RecordEnabled(MacroKind kind, size_t index) {
+    if (!m_journal) return;
+    switch (kind) {
+        case MacroKind::Basic: if (index < basicMacros.size()) m_journal->AppendSetEnabled(kind, (uint32_t)index, basicMacros[index].enabled); break;
+        case MacroKind::Image: if (index < imageMacros.size()) m_journal->AppendSetEnabled(kind, (uint32_t)index, imageMacros[index].enabled); break;
+        case MacroKind::Combo: if (index < comboMacros.size()) m_journal->AppendSetEnabled(kind, (uint32_t)index, comboMacros[index].enabled); break;
+    }
+}
+
+void MacroManager::CompileMacros() {
+    for (auto& m : basicMacros) {
+        m.program = MacroCompiler::CompileActions(m.actions);
+    }
+    for (auto& m : comboMacros) {
+        m.program = MacroCompiler::CompileActions(m.skills);
+    }
+}
+
+void MacroManager::AssignIds() {
+    for (auto& m : basicMacros) {
+        if (m.id == 0) m.id = m_nextId++;
+    }
+    for (auto& m : imageMacros) {
+        if (m.id == 0) m.id = m_nextId++;
+    }
+    for (auto& m : comboMacros) {
+        if (m.id == 0) m.id = m_nextId++;
+    }
+}
+
+const char* MacroManager::OverloadPolicyName(OverloadPolicy policy) {
+    switch (policy) {
+        case OverloadPolicy::Restart:  return "restart";
+        case OverloadPolicy::Queue:    return "queue";
+        case OverloadPolicy::Coalesce: return "coalesce";
+        default:                       return "drop";
+    }
+}
+
+bool MacroManager::ParseOverloadPolicy(const std::string& name, OverloadPolicy& policy) {
+    if (name == "drop") policy = OverloadPolicy::DropNew;
+    else if (name == "restart") policy = OverloadPolicy::Restart;
+    else if (name == "queue") policy = OverloadPolicy::Queue;
+    else if (name == "coalesce") policy = OverloadPolicy::Coalesce;
+    else return false;
+    return true;
+}
+
+const char* MacroManager::ImageSearchModeName(ImageSearchMode mode) {
+    switch (mode) {
+        case ImageSearchMode::Exact: return "exact";
+        case ImageSearchMode::Fast:  return "fast";
+        default:                     return "balanced";
+    }
+}
+
+bool MacroManager::ParseImageSearchMode(const std::string& name, ImageSearchMode& mode) {
+    if (name == "exact") mode = ImageSearchMode::Exact;
+    else if (name == "balanced") mode = ImageSearchMode::Balanced;
+    else if (name == "fast") mode = ImageSearchMode::Fast;
+    else return false;
     return true;
 }
@@ -1,35 +1,72 @@
 #pragma once
 #include <string>
 #include <vector>
-#include <windows.h>
+#include "MacroCompiler.h"
+
+class MacroJournal;
+
+// Catgorie d'une macro (journal des modifications, MacroStore)
+enum class MacroKind : uint8_t { Basic, Image, Combo };
+
+// Identifiant stable d'une macro pendant la session (0 = pas encore attribu).
+// Contrairement  l'index dans le vecteur, il ne change pas quand une autre macro est supprime.
+typedef uint32_t MacroId;
+
+// Comportement quand le hotkey est redclench pendant que la macro tourne encore
+enum class OverloadPolicy {
+    DropNew,    // Ignorer le nouveau dclenchement
+    Restart,    // Arrter l'excution en cours et repartir du dbut
+    Queue,      // Mettre en attente, jusqu' queueLimit excutions
+    Coalesce    // Au plus une excution en attente, les suivantes s'y fondent
+};
+
+// Compromis prcision/vitesse de la recherche d'une macro image (voir PyramidMatcher)
+enum class ImageSearchMode : uint8_t {
+    Exact,      // Toutes les positions  pleine rsolution
+    Balanced,   // Pyramide, candidats nombreux : rejoint la recherche exacte en pratique
+    Fast        // Pyramide plus profonde, peu de candidats
+};
 
 // Structure pour les macros
 struct BasicMacro {
+    MacroId id;
     std::wstring name;
     std::wstring hotkey;
     std::vector<std::wstring> actions;
     bool enabled;
     bool loop; // Excution en boucle
     bool holdMode; // Maintenir la touche
+    OverloadPolicy overloadPolicy; // Ignore en mode maintien
+    int queueLimit; // Pour OverloadPolicy::Queue
+    std::vector<MacroInstruction> program; // Actions compiles (voir MacroCompiler)
 };
 
 struct ImageMacro {
+    MacroId id;
     std::wstring name;
     std::wstring imagePath;
     std::wstring action;
     int confidence;
+    ImageSearchMode searchMode;
     bool enabled;
 };
 
 struct ComboMacro {
+    MacroId id;
     std::wstring name;
     std::wstring hotkey;
     std::vector<std::wstring> skills;
     int delayBetween;
     bool detectCooldown;
     bool enabled;
+    OverloadPolicy overloadPolicy;
+    int queueLimit;
+    std::vector<MacroInstruction> program; // Skills compils (voir MacroCompiler)
 };
 
+// Conversion UTF-16 -> UTF-8 (noms de fichiers, criture JSON)
+std::string WStringToString(const std::wstring& wstr);
+
 // Classe pour grer la sauvegarde/chargement JSON
 class MacroManager {
 public:
@@ -40,12 +77,46 @@ public:
     bool SaveToFile(const std::wstring& filename);
     bool LoadFromFile(const std::wstring& filename);
 
+    // Contenu crit par SaveToFile (UTF-8 avec BOM)
+    std::string ToJson() const;
+
+    // Snapshot binaire de filename (voir MacroSnapshot) : chargement rapide au
+    // dmarrage. LoadSnapshot choue si le snapshot ne correspond plus au JSON.
+    bool SaveSnapshot(const std::wstring& snapshotPath, const std::wstring& sourcePath) const;
+    bool LoadSnapshot(const std::wstring& snapshotPath, const std::wstring& sourcePath);
+
+    // Compiler les actions de toutes les macros en instructions
+    void CompileMacros();
+
+    // Attribuer un identifiant aux macros qui n'en ont pas encore (id == 0)
+    void AssignIds();
+
+    // Journal des modifications (voir MacroJournal), optionnel.
+    // Les Record* sont appels aprs la modification des vecteurs.
+    void AttachJournal(MacroJournal* journal) { m_journal = journal; }
+    void RecordAdded(MacroKind kind);                   // Dernire macro du vecteur
+    void RecordUpdated(MacroKind kind, size_t index);
+    void RecordDeleted(MacroKind kind, size_t index);
+    void RecordEnabled(MacroKind kind, size_t index);
+
+    // Nom JSON d'une politique ("drop", "restart", "queue", "coalesce")
+    static const char* OverloadPolicyName(OverloadPolicy policy);
+    static bool ParseOverloadPolicy(const std::string& name, OverloadPolicy& policy);
+
+    // Nom JSON d'un mode de recherche ("exact", "balanced", "fast")
+    static const char* ImageSearchModeName(ImageSearchMode mode);
+    static bool ParseImageSearchMode(const std::string& name, ImageSearchMode& mode);
+
     // Gestion des macros
     std::vector<BasicMacro> basicMacros;
     std::vector<ImageMacro> imageMacros;
     std::vector<ComboMacro> comboMacros;
 
+    // Dernier enregistrement du journal dj inclus dans ces macros : crit dans
+    // le JSON et le snapshot, le rejeu du journal reprend  l'enregistrement suivant
+    uint64_t journalSequence;
+
 private:
-    std::wstring WStringToJson(const std::wstring& str);
-    std::wstring JsonToWString(const std::wstring& json);
+    MacroJournal* m_journal;
+    MacroId m_nextId;
 };
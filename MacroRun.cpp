@@ -0,0 +1,24 @@
+#include "MacroRun.h"
+
+MacroRun::MacroRun(uint64_t id)
+    : m_id(id)
+    , m_state(State::Pending)
+{
+}
+
+void MacroRun::Join() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_finished.wait(lock, [this]() { return m_state.load() == State::Finished; });
+}
+
+void MacroRun::MarkRunning() {
+    m_state.store(State::Running);
+}
+
+void MacroRun::MarkFinished() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_state.store(State::Finished);
+    }
+    m_finished.notify_all();
+}
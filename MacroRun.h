@@ -0,0 +1,59 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include "CancellationToken.h"
+
+// État propre à une exécution de macro (une instance par déclenchement)
+class MacroRun {
+public:
+    enum class State { Pending, Running, Finished };
+
+    explicit MacroRun(uint64_t id);
+
+    uint64_t Id() const { return m_id; }
+    State GetState() const { return m_state.load(); }
+    bool IsActive() const { return m_state.load() != State::Finished; }
+
+    // Demande d'arrêt coopérative : réveille aussitôt l'attente en cours
+    // (Wait, maintien de touche, délai entre skills) et ne bloque pas l'appelant
+    void RequestStop() { m_cancel.Cancel(); }
+    bool StopRequested() const { return m_cancel.IsCancelled(); }
+
+    // Jeton à passer aux attentes de l'exécution
+    const CancellationToken& Token() const { return m_cancel; }
+
+    // Attendre la fin de l'exécution
+    void Join();
+
+    // Transitions appelées par le thread d'exécution
+    void MarkRunning();
+    void MarkFinished();
+
+private:
+    const uint64_t m_id;
+    std::atomic<State> m_state;
+    CancellationToken m_cancel;
+
+    std::mutex m_mutex;
+    std::condition_variable m_finished;
+};
+
+// Handle léger sur une exécution, retourné par MacroExecutor
+class RunHandle {
+public:
+    RunHandle() {}
+    explicit RunHandle(std::shared_ptr<MacroRun> run) : m_run(std::move(run)) {}
+
+    bool IsValid() const { return m_run != nullptr; }
+    uint64_t Id() const { return m_run ? m_run->Id() : 0; }
+    bool IsRunning() const { return m_run && m_run->IsActive(); }
+
+    void Stop() { if (m_run) m_run->RequestStop(); } // Non bloquant
+    void Join() { if (m_run) m_run->Join(); }
+
+private:
+    std::shared_ptr<MacroRun> m_run;
+};
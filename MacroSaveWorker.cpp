@@ -0,0 +1,141 @@
+#include "MacroSaveWorker.h"
+#include "AtomicFile.h"
+#include <algorithm>
+
+// Passées par référence à std::chrono::milliseconds : définition requise hors optimisation
+const int MacroSaveWorker::DebounceMs;
+const int MacroSaveWorker::MaxDelayMs;
+
+namespace {
+
+uint64_t HashContent(const std::string& data) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : data) {
+        hash = (hash ^ c) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+} // namespace
+
+MacroSaveWorker::MacroSaveWorker()
+    : m_generation(0)
+    , m_savedGeneration(0)
+    , m_flushRequested(false)
+    , m_shutdown(false)
+    , m_lastHash(0)
+    , m_hasLastHash(false)
+    , m_stats()
+    , m_journal(nullptr)
+    , m_thread(&MacroSaveWorker::WorkerLoop, this)
+{
+}
+
+MacroSaveWorker::~MacroSaveWorker() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_wake.notify_all();
+    m_thread.join();
+}
+
+void MacroSaveWorker::Schedule(const MacroManager& macros, const std::wstring& jsonPath, const std::wstring& snapshotPath) {
+    // Copie hors verrou : le worker peut être en train d'écrire
+    MacroManager copy;
+    copy.basicMacros = macros.basicMacros;
+    copy.imageMacros = macros.imageMacros;
+    copy.comboMacros = macros.comboMacros;
+    uint64_t journalSequence = m_journal ? m_journal->LastSequence() : 0;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.basicMacros.swap(copy.basicMacros);
+        m_pending.imageMacros.swap(copy.imageMacros);
+        m_pending.comboMacros.swap(copy.comboMacros);
+        m_pending.journalSequence = journalSequence;
+        m_jsonPath = jsonPath;
+        m_snapshotPath = snapshotPath;
+
+        Clock::time_point now = Clock::now();
+        if (m_generation == m_savedGeneration) m_firstChange = now;
+        m_lastChange = now;
+        m_generation++;
+        m_stats.scheduled++;
+    }
+    m_wake.notify_all();
+    // L'ancien état en attente est libéré ici, hors verrou
+}
+
+void MacroSaveWorker::Flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    uint64_t target = m_generation;
+    if (m_savedGeneration >= target) return;
+
+    m_flushRequested = true;
+    m_wake.notify_all();
+    m_saved.wait(lock, [this, target]() { return m_savedGeneration >= target; });
+    m_flushRequested = false;
+}
+
+MacroSaveWorker::Stats MacroSaveWorker::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void MacroSaveWorker::WorkerLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_wake.wait(lock, [this]() { return m_shutdown || m_generation != m_savedGeneration; });
+        if (m_generation == m_savedGeneration) break; // Arrêt demandé, rien en attente
+
+        // Regrouper les modifications rapprochées en une seule écriture
+        while (!m_shutdown && !m_flushRequested) {
+            Clock::time_point deadline = std::min(m_lastChange + std::chrono::milliseconds(DebounceMs),
+                                                  m_firstChange + std::chrono::milliseconds(MaxDelayMs));
+            if (Clock::now() >= deadline) break;
+            m_wake.wait_until(lock, deadline);
+        }
+
+        uint64_t generation = m_generation;
+        MacroManager macros;
+        macros.basicMacros.swap(m_pending.basicMacros);
+        macros.imageMacros.swap(m_pending.imageMacros);
+        macros.comboMacros.swap(m_pending.comboMacros);
+        macros.journalSequence = m_pending.journalSequence;
+        std::wstring jsonPath = m_jsonPath;
+        std::wstring snapshotPath = m_snapshotPath;
+
+        lock.unlock();
+        Save(macros, jsonPath, snapshotPath);
+        lock.lock();
+
+        m_savedGeneration = generation;
+        m_saved.notify_all();
+    }
+}
+
+void MacroSaveWorker::Save(const MacroManager& macros, const std::wstring& jsonPath, const std::wstring& snapshotPath) {
+    // Sérialisation en mémoire, sur ce thread ; le JSON porte journalSequence
+    std::string json = macros.ToJson();
+    uint64_t hash = HashContent(json);
+
+    bool unchanged = m_hasLastHash && hash == m_lastHash;
+    bool ok = unchanged || AtomicFile::Write(jsonPath, json);
+    if (ok && !unchanged) {
+        m_lastHash = hash;
+        m_hasLastHash = true;
+
+        // Le snapshot porte l'empreinte du JSON qui vient d'être écrit
+        macros.SaveSnapshot(snapshotPath, jsonPath);
+    }
+
+    // Le JSON sur disque inclut le journal jusqu'à journalSequence : un arrêt avant
+    // Rebase laisse ces enregistrements, ignorés au prochain rejeu
+    if (ok && m_journal) m_journal->Rebase(macros.journalSequence);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (unchanged) m_stats.unchanged++;
+    else if (ok) m_stats.written++;
+    else m_stats.failed++;
+}
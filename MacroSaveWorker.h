@@ -0,0 +1,74 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "MacroJournal.h"
+#include "MacroManager.h"
+
+// Sauvegarde des macros en arrière-plan.
+// Schedule() ne fait que copier l'état courant ; la sérialisation et
+// l'écriture ont lieu sur le thread du worker, une fois les modifications
+// calmées depuis DebounceMs (et au plus tard MaxDelayMs après la première).
+// Un contenu identique au dernier fichier écrit n'est pas réécrit.
+class MacroSaveWorker {
+public:
+    static const int DebounceMs = 300;
+    static const int MaxDelayMs = 2000;
+
+    struct Stats {
+        uint64_t scheduled;     // Appels à Schedule()
+        uint64_t written;       // Fichiers effectivement écrits
+        uint64_t unchanged;     // Sauvegardes sautées, contenu identique
+        uint64_t failed;
+    };
+
+    MacroSaveWorker();
+    ~MacroSaveWorker();  // Écrit ce qui est en attente
+
+    MacroSaveWorker(const MacroSaveWorker&) = delete;
+    MacroSaveWorker& operator=(const MacroSaveWorker&) = delete;
+
+    // Journal à remettre à zéro après chaque écriture complète du JSON (optionnel)
+    void SetJournal(MacroJournal* journal) { m_journal = journal; }
+
+    // Marquer les macros comme modifiées (thread UI)
+    void Schedule(const MacroManager& macros, const std::wstring& jsonPath, const std::wstring& snapshotPath);
+
+    // Écrire immédiatement ce qui est en attente et attendre la fin
+    void Flush();
+
+    Stats GetStats() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    void WorkerLoop();
+    void Save(const MacroManager& macros, const std::wstring& jsonPath, const std::wstring& snapshotPath);
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_saved;
+
+    // Dernier état demandé (protégé par m_mutex), journalSequence compris
+    MacroManager m_pending;
+    std::wstring m_jsonPath;
+    std::wstring m_snapshotPath;
+    uint64_t m_generation;          // Incrémenté à chaque Schedule()
+    uint64_t m_savedGeneration;     // Dernière génération traitée
+    Clock::time_point m_firstChange;
+    Clock::time_point m_lastChange;
+    bool m_flushRequested;
+    bool m_shutdown;
+
+    // Empreinte du dernier contenu écrit (thread du worker uniquement)
+    uint64_t m_lastHash;
+    bool m_hasLastHash;
+
+    Stats m_stats;
+    MacroJournal* m_journal;
+
+    std::thread m_thread;   // Déclaré en dernier : démarré une fois les membres initialisés
+};
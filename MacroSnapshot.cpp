@@ -0,0 +1,457 @@
+#include "MacroSnapshot.h"
+#include "AtomicFile.h"
+#include "MacroManager.h"
+#include <cstring>
+#include <unordered_map>
+
+// Les enregistrements sont copiés tels quels dans le fichier : aucun octet
+// de remplissage implicite, dont le contenu varierait d'une écriture à l'autre
+static_assert(sizeof(MacroSnapshot::BasicRecord) == 32, "BasicRecord : remplissage implicite");
+static_assert(sizeof(MacroSnapshot::ImageRecord) == 24, "ImageRecord : remplissage implicite");
+static_assert(sizeof(MacroSnapshot::ComboRecord) == 36, "ComboRecord : remplissage implicite");
+static_assert(sizeof(MacroSnapshot::InstructionRecord) == 12, "InstructionRecord : remplissage implicite");
+
+struct MacroSnapshot::Header {
+    char magic[8];              // "MFSNAP\0\0"
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t sourceSize;
+    uint64_t sourceWriteTime;
+    uint64_t journalSequence;   // Dernier enregistrement du journal inclus
+    uint64_t checksum;          // Sur tout ce qui suit l'en-tête
+    uint64_t fileSize;
+
+    // Sections : nombre d'éléments et position depuis le début du fichier
+    uint32_t stringCount;       // uint32[stringCount + 1] : début de chaque chaîne dans chars
+    uint32_t stringOffsetsPos;
+    uint32_t charCount;         // uint16[charCount] : chaînes UTF-16 concaténées
+    uint32_t charsPos;
+    uint32_t refCount;          // uint32[refCount] : identifiants des actions / skills
+    uint32_t refsPos;
+    uint32_t instructionCount;
+    uint32_t instructionsPos;
+    uint32_t basicCount;
+    uint32_t basicPos;
+    uint32_t imageCount;
+    uint32_t imagePos;
+    uint32_t comboCount;
+    uint32_t comboPos;
+};
+
+namespace {
+
+const char SNAPSHOT_MAGIC[8] = { 'M', 'F', 'S', 'N', 'A', 'P', 0, 0 };
+
+// FNV-1a appliqué par mots de 64 bits
+uint64_t Checksum(const unsigned char* data, size_t size) {
+    uint64_t hash = 14695981039346656037ULL;
+    const uint64_t prime = 1099511628211ULL;
+
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * prime;
+    }
+    for (; i < size; i++) {
+        hash = (hash ^ data[i]) * prime;
+    }
+    return hash;
+}
+
+// Construction du fichier en mémoire, sections alignées sur 8 octets
+class SnapshotBuilder {
+public:
+    uint32_t Intern(const std::wstring& str) {
+        auto it = m_ids.find(str);
+        if (it != m_ids.end()) return it->second;
+
+        uint32_t id = (uint32_t)m_stringOffsets.size() - 1;
+        for (size_t i = 0; i < str.size(); i++) {
+            uint32_t c = (uint32_t)str[i];
+            if (c >= 0x10000) {
+                c -= 0x10000;
+                m_chars.push_back((uint16_t)(0xD800 + (c >> 10)));
+                m_chars.push_back((uint16_t)(0xDC00 + (c & 0x3FF)));
+            } else {
+                m_chars.push_back((uint16_t)c);
+            }
+        }
+        m_stringOffsets.push_back((uint32_t)m_chars.size());
+        m_ids.emplace(str, id);
+        return id;
+    }
+
+    uint32_t AddRefs(const std::vector<std::wstring>& strings) {
+        uint32_t first = (uint32_t)m_refs.size();
+        for (const auto& str : strings) {
+            m_refs.push_back(Intern(str));
+        }
+        return first;
+    }
+
+    uint32_t AddProgram(const std::vector<MacroInstruction>& program, const std::vector<std::wstring>& source) {
+        uint32_t first = (uint32_t)m_instructions.size();
+        // Programme absent ou périmé : le compiler ici plutôt qu'au chargement
+        if (program.size() == source.size()) {
+            for (const auto& instruction : program) AddInstruction(instruction);
+        } else {
+            for (const auto& action : source) AddInstruction(MacroCompiler::CompileAction(action));
+        }
+        return first;
+    }
+
+    uint32_t AddInstruction(const MacroInstruction& instruction) {
+        MacroSnapshot::InstructionRecord r = {};
+        r.op = (uint8_t)instruction.op;
+        r.button = (uint8_t)instruction.button;
+        r.modifiers = instruction.modifiers;
+        r.vk = instruction.vk;
+        r.durationMs = instruction.durationMs;
+        m_instructions.push_back(r);
+        return (uint32_t)m_instructions.size() - 1;
+    }
+
+    std::vector<uint32_t> m_stringOffsets = { 0 };
+    std::vector<uint16_t> m_chars;
+    std::vector<uint32_t> m_refs;
+    std::vector<MacroSnapshot::InstructionRecord> m_instructions;
+
+private:
+    std::unordered_map<std::wstring, uint32_t> m_ids;
+};
+
+template <typename T>
+uint32_t AppendSection(std::vector<unsigned char>& file, const std::vector<T>& items) {
+    while (file.size() % 8 != 0) file.push_back(0);
+    uint32_t pos = (uint32_t)file.size();
+    if (!items.empty()) {
+        const unsigned char* bytes = (const unsigned char*)items.data();
+        file.insert(file.end(), bytes, bytes + items.size() * sizeof(T));
+    }
+    return pos;
+}
+
+// La plage [first, first + count) tient dans un tableau de total éléments
+bool RangeOk(uint32_t first, uint32_t count, uint32_t total) {
+    return first <= total && count <= total - first;
+}
+
+// Chaîne UTF-16 de la table ajoutée à out (std::wstring ou std::vector<wchar_t>)
+template <typename Out>
+void AppendWide(const uint16_t* chars, uint32_t length, Out& out) {
+    for (uint32_t i = 0; i < length; i++) {
+        uint32_t c = chars[i];
+        // wchar_t 32 bits : recomposer les paires de substitution
+        if (sizeof(wchar_t) > 2 && c >= 0xD800 && c <= 0xDBFF && i + 1 < length &&
+            chars[i + 1] >= 0xDC00 && chars[i + 1] <= 0xDFFF) {
+            c = 0x10000 + ((c - 0xD800) << 10) + (chars[++i] - 0xDC00);
+        }
+        out.push_back((wchar_t)c);
+    }
+}
+
+} // namespace
+
+MacroSnapshot::MacroSnapshot()
+    : m_header(nullptr)
+    , m_stringOffsets(nullptr)
+    , m_chars(nullptr)
+    , m_refs(nullptr)
+    , m_instructions(nullptr)
+    , m_basic(nullptr)
+    , m_image(nullptr)
+    , m_combo(nullptr)
+{
+}
+
+bool MacroSnapshot::Write(const std::wstring& path, const SnapshotSource& source, uint64_t journalSequence,
+                          const std::vector<BasicMacro>& basicMacros,
+                          const std::vector<ImageMacro>& imageMacros,
+                          const std::vector<ComboMacro>& comboMacros) {
+    SnapshotBuilder builder;
+
+    std::vector<BasicRecord> basic;
+    basic.reserve(basicMacros.size());
+    for (const auto& m : basicMacros) {
+        BasicRecord r = {};
+        r.name = builder.Intern(m.name);
+        r.hotkey = builder.Intern(m.hotkey);
+        r.firstAction = builder.AddRefs(m.actions);
+        r.actionCount = (uint32_t)m.actions.size();
+        r.firstInstruction = builder.AddProgram(m.program, m.actions);
+        r.instructionCount = (uint32_t)m.actions.size();
+        r.queueLimit = m.queueLimit;
+        r.enabled = m.enabled;
+        r.loop = m.loop;
+        r.holdMode = m.holdMode;
+        r.overloadPolicy = (uint8_t)m.overloadPolicy;
+        basic.push_back(r);
+    }
+
+    std::vector<ImageRecord> image;
+    image.reserve(imageMacros.size());
+    for (const auto& m : imageMacros) {
+        ImageRecord r = {};
+        r.name = builder.Intern(m.name);
+        r.imagePath = builder.Intern(m.imagePath);
+        r.action = builder.Intern(m.action);
+        r.instruction = builder.AddInstruction(MacroCompiler::CompileAction(m.action));
+        r.confidence = m.confidence;
+        r.enabled = m.enabled;
+        r.searchMode = (uint8_t)m.searchMode;
+        image.push_back(r);
+    }
+
+    std::vector<ComboRecord> combo;
+    combo.reserve(comboMacros.size());
+    for (const auto& m : comboMacros) {
+        ComboRecord r = {};
+        r.name = builder.Intern(m.name);
+        r.hotkey = builder.Intern(m.hotkey);
+        r.firstSkill = builder.AddRefs(m.skills);
+        r.skillCount = (uint32_t)m.skills.size();
+        r.firstInstruction = builder.AddProgram(m.program, m.skills);
+        r.instructionCount = (uint32_t)m.skills.size();
+        r.delayBetween = m.delayBetween;
+        r.queueLimit = m.queueLimit;
+        r.detectCooldown = m.detectCooldown;
+        r.enabled = m.enabled;
+        r.overloadPolicy = (uint8_t)m.overloadPolicy;
+        combo.push_back(r);
+    }
+
+    Header header = {};
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = Version;
+    header.headerSize = sizeof(Header);
+    header.sourceSize = source.size;
+    header.sourceWriteTime = source.writeTime;
+    header.journalSequence = journalSequence;
+
+    std::vector<unsigned char> file(sizeof(Header), 0);
+    header.stringCount = (uint32_t)builder.m_stringOffsets.size() - 1;
+    header.stringOffsetsPos = AppendSection(file, builder.m_stringOffsets);
+    header.charCount = (uint32_t)builder.m_chars.size();
+    header.charsPos = AppendSection(file, builder.m_chars);
+    header.refCount = (uint32_t)builder.m_refs.size();
+    header.refsPos = AppendSection(file, builder.m_refs);
+    header.instructionCount = (uint32_t)builder.m_instructions.size();
+    header.instructionsPos = AppendSection(file, builder.m_instructions);
+    header.basicCount = (uint32_t)basic.size();
+    header.basicPos = AppendSection(file, basic);
+    header.imageCount = (uint32_t)image.size();
+    header.imagePos = AppendSection(file, image);
+    header.comboCount = (uint32_t)combo.size();
+    header.comboPos = AppendSection(file, combo);
+
+    header.fileSize = file.size();
+    header.checksum = Checksum(file.data() + sizeof(Header), file.size() - sizeof(Header));
+    memcpy(file.data(), &header, sizeof(Header));
+
+    return AtomicFile::Write(path, file.data(), file.size());
+}
+
+bool MacroSnapshot::Open(const std::wstring& path, const SnapshotSource& source) {
+    Close();
+    if (!m_file.Open(path)) return false;
+
+    if (!Validate(source)) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MacroSnapshot::Close() {
+    m_file.Close();
+    m_header = nullptr;
+    m_stringOffsets = nullptr;
+    m_chars = nullptr;
+    m_refs = nullptr;
+    m_instructions = nullptr;
+    m_basic = nullptr;
+    m_image = nullptr;
+    m_combo = nullptr;
+}
+
+bool MacroSnapshot::Validate(const SnapshotSource& source) {
+    const unsigned char* data = m_file.Data();
+    size_t size = m_file.Size();
+    if (size < sizeof(Header)) return false;
+
+    const Header* header = (const Header*)data;
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) return false;
+    if (header->version != Version || header->headerSize != sizeof(Header)) return false;
+    if (header->fileSize != size) return false;
+
+    // Snapshot d'une autre version du JSON
+    if (header->sourceSize != source.size || header->sourceWriteTime != source.writeTime) return false;
+
+    if (header->checksum != Checksum(data + sizeof(Header), size - sizeof(Header))) return false;
+
+    // Chaque section doit tenir dans le fichier et être alignée
+    struct { uint32_t pos; uint64_t count; size_t itemSize; } sections[] = {
+        { header->stringOffsetsPos, (uint64_t)header->stringCount + 1, sizeof(uint32_t) },
+        { header->charsPos, header->charCount, sizeof(uint16_t) },
+        { header->refsPos, header->refCount, sizeof(uint32_t) },
+        { header->instructionsPos, header->instructionCount, sizeof(InstructionRecord) },
+        { header->basicPos, header->basicCount, sizeof(BasicRecord) },
+        { header->imagePos, header->imageCount, sizeof(ImageRecord) },
+        { header->comboPos, header->comboCount, sizeof(ComboRecord) }
+    };
+    for (const auto& section : sections) {
+        if (section.pos < sizeof(Header) || section.pos % 8 != 0) return false;
+        if (section.pos > size || section.count * section.itemSize > size - section.pos) return false;
+    }
+
+    m_header = header;
+    m_stringOffsets = (const uint32_t*)(data + header->stringOffsetsPos);
+    m_chars = (const uint16_t*)(data + header->charsPos);
+    m_refs = (const uint32_t*)(data + header->refsPos);
+    m_instructions = (const InstructionRecord*)(data + header->instructionsPos);
+    m_basic = (const BasicRecord*)(data + header->basicPos);
+    m_image = (const ImageRecord*)(data + header->imagePos);
+    m_combo = (const ComboRecord*)(data + header->comboPos);
+
+    // Références internes : les accès en place n'ont plus à être vérifiés
+    if (m_stringOffsets[0] != 0) return false;
+    for (uint32_t i = 0; i < header->stringCount; i++) {
+        if (m_stringOffsets[i + 1] < m_stringOffsets[i]) return false;
+    }
+    if (m_stringOffsets[header->stringCount] > header->charCount) return false;
+
+    for (uint32_t i = 0; i < header->refCount; i++) {
+        if (m_refs[i] >= header->stringCount) return false;
+    }
+    for (uint32_t i = 0; i < header->instructionCount; i++) {
+        const InstructionRecord& r = m_instructions[i];
+        if (r.op > (uint8_t)MacroOp::Wait || r.button > (uint8_t)MouseButton::X2) return false;
+    }
+    for (uint32_t i = 0; i < header->basicCount; i++) {
+        const BasicRecord& r = m_basic[i];
+        if (r.name >= header->stringCount || r.hotkey >= header->stringCount) return false;
+        if (!RangeOk(r.firstAction, r.actionCount, header->refCount)) return false;
+        if (!RangeOk(r.firstInstruction, r.instructionCount, header->instructionCount)) return false;
+        if (r.instructionCount != r.actionCount) return false;
+        if (r.overloadPolicy > (uint8_t)OverloadPolicy::Coalesce) return false;
+    }
+    for (uint32_t i = 0; i < header->imageCount; i++) {
+        const ImageRecord& r = m_image[i];
+        if (r.name >= header->stringCount || r.imagePath >= header->stringCount ||
+            r.action >= header->stringCount) return false;
+        if (r.instruction >= header->instructionCount) return false;
+        if (r.searchMode > (uint8_t)ImageSearchMode::Fast) return false;
+    }
+    for (uint32_t i = 0; i < header->comboCount; i++) {
+        const ComboRecord& r = m_combo[i];
+        if (r.name >= header->stringCount || r.hotkey >= header->stringCount) return false;
+        if (!RangeOk(r.firstSkill, r.skillCount, header->refCount)) return false;
+        if (!RangeOk(r.firstInstruction, r.instructionCount, header->instructionCount)) return false;
+        if (r.instructionCount != r.skillCount) return false;
+        if (r.overloadPolicy > (uint8_t)OverloadPolicy::Coalesce) return false;
+    }
+    return true;
+}
+
+uint32_t MacroSnapshot::BasicCount() const { return m_header ? m_header->basicCount : 0; }
+uint32_t MacroSnapshot::ImageCount() const { return m_header ? m_header->imageCount : 0; }
+uint32_t MacroSnapshot::ComboCount() const { return m_header ? m_header->comboCount : 0; }
+uint64_t MacroSnapshot::JournalSequence() const { return m_header ? m_header->journalSequence : 0; }
+
+const uint16_t* MacroSnapshot::StringData(uint32_t id, uint32_t& length) const {
+    length = m_stringOffsets[id + 1] - m_stringOffsets[id];
+    return m_chars + m_stringOffsets[id];
+}
+
+MacroInstruction MacroSnapshot::Instruction(uint32_t index) const {
+    const InstructionRecord& r = m_instructions[index];
+    MacroInstruction instruction;
+    instruction.op = (MacroOp)r.op;
+    instruction.button = (MouseButton)r.button;
+    instruction.modifiers = r.modifiers;
+    instruction.vk = r.vk;
+    instruction.durationMs = r.durationMs;
+    return instruction;
+}
+
+std::wstring MacroSnapshot::String(uint32_t id) const {
+    uint32_t length;
+    const uint16_t* chars = StringData(id, length);
+
+    std::wstring result;
+    result.reserve(length);
+    AppendWide(chars, length, result);
+    return result;
+}
+
+void MacroSnapshot::AppendString(uint32_t id, std::vector<wchar_t>& out) const {
+    uint32_t length;
+    const uint16_t* chars = StringData(id, length);
+    AppendWide(chars, length, out);
+}
+
+void MacroSnapshot::Materialize(std::vector<BasicMacro>& basicMacros,
+                                std::vector<ImageMacro>& imageMacros,
+                                std::vector<ComboMacro>& comboMacros) const {
+    basicMacros.clear();
+    imageMacros.clear();
+    comboMacros.clear();
+    basicMacros.reserve(BasicCount());
+    imageMacros.reserve(ImageCount());
+    comboMacros.reserve(ComboCount());
+
+    for (uint32_t i = 0; i < BasicCount(); i++) {
+        const BasicRecord& r = m_basic[i];
+        BasicMacro m = {};
+        m.name = String(r.name);
+        m.hotkey = String(r.hotkey);
+        m.actions.reserve(r.actionCount);
+        for (uint32_t j = 0; j < r.actionCount; j++) {
+            m.actions.push_back(String(m_refs[r.firstAction + j]));
+        }
+        m.enabled = r.enabled != 0;
+        m.loop = r.loop != 0;
+        m.holdMode = r.holdMode != 0;
+        m.overloadPolicy = (OverloadPolicy)r.overloadPolicy;
+        m.queueLimit = r.queueLimit;
+        m.program.reserve(r.instructionCount);
+        for (uint32_t j = 0; j < r.instructionCount; j++) {
+            m.program.push_back(Instruction(r.firstInstruction + j));
+        }
+        basicMacros.push_back(std::move(m));
+    }
+
+    for (uint32_t i = 0; i < ImageCount(); i++) {
+        const ImageRecord& r = m_image[i];
+        ImageMacro m = {};
+        m.name = String(r.name);
+        m.imagePath = String(r.imagePath);
+        m.action = String(r.action);
+        m.confidence = r.confidence;
+        m.searchMode = (ImageSearchMode)r.searchMode;
+        m.enabled = r.enabled != 0;
+        imageMacros.push_back(std::move(m));
+    }
+
+    for (uint32_t i = 0; i < ComboCount(); i++) {
+        const ComboRecord& r = m_combo[i];
+        ComboMacro m = {};
+        m.name = String(r.name);
+        m.hotkey = String(r.hotkey);
+        m.skills.reserve(r.skillCount);
+        for (uint32_t j = 0; j < r.skillCount; j++) {
+            m.skills.push_back(String(m_refs[r.firstSkill + j]));
+        }
+        m.delayBetween = r.delayBetween;
+        m.detectCooldown = r.detectCooldown != 0;
+        m.enabled = r.enabled != 0;
+        m.overloadPolicy = (OverloadPolicy)r.overloadPolicy;
+        m.queueLimit = r.queueLimit;
+        m.program.reserve(r.instructionCount);
+        for (uint32_t j = 0; j < r.instructionCount; j++) {
+            m.program.push_back(Instruction(r.firstInstruction + j));
+        }
+        comboMacros.push_back(std::move(m));
+    }
+}
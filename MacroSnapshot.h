@@ -0,0 +1,131 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MacroCompiler.h"
+#include "MappedFile.h"
+
+struct BasicMacro;
+struct ImageMacro;
+struct ComboMacro;
+
+// Identité du macros.json dont un snapshot est issu
+struct SnapshotSource {
+    uint64_t size;
+    uint64_t writeTime;
+};
+
+// Snapshot binaire versionné des macros, écrit à côté de macros.json.
+// Contient les instructions déjà compilées et une table de chaînes
+// dédoublonnées (UTF-16) ; il est lu par projection mémoire, les
+// enregistrements sont consultés en place sans allocation.
+// Chaque champ est écrit explicitement, octets de réserve à zéro : les
+// mêmes macros donnent toujours le même fichier.
+// Le JSON reste la source : un snapshot dont la source ne correspond plus,
+// de version différente ou dont la somme de contrôle est fausse est refusé.
+class MacroSnapshot {
+public:
+    static const uint32_t Version = 4;
+
+    // Enregistrements tels que stockés dans le fichier.
+    // Les chaînes sont des identifiants de la table, les listes des plages.
+    struct BasicRecord {
+        uint32_t name;
+        uint32_t hotkey;
+        uint32_t firstAction;       // Plage dans la table des références de chaînes
+        uint32_t actionCount;
+        uint32_t firstInstruction;  // Plage dans la table des instructions
+        uint32_t instructionCount;
+        int32_t queueLimit;
+        uint8_t enabled;
+        uint8_t loop;
+        uint8_t holdMode;
+        uint8_t overloadPolicy;
+    };
+
+    struct ImageRecord {
+        uint32_t name;
+        uint32_t imagePath;
+        uint32_t action;
+        uint32_t instruction;       // Action compilée, dans la table des instructions
+        int32_t confidence;
+        uint8_t enabled;
+        uint8_t searchMode;
+        uint8_t reserved[2];
+    };
+
+    struct ComboRecord {
+        uint32_t name;
+        uint32_t hotkey;
+        uint32_t firstSkill;
+        uint32_t skillCount;
+        uint32_t firstInstruction;
+        uint32_t instructionCount;
+        int32_t delayBetween;
+        int32_t queueLimit;
+        uint8_t detectCooldown;
+        uint8_t enabled;
+        uint8_t overloadPolicy;
+        uint8_t reserved;
+    };
+
+    // MacroInstruction sans octets de remplissage implicites
+    struct InstructionRecord {
+        uint8_t op;
+        uint8_t button;
+        uint8_t modifiers;
+        uint8_t reserved;
+        uint16_t vk;
+        uint16_t reserved2;
+        uint32_t durationMs;
+    };
+
+    MacroSnapshot();
+
+    // journalSequence : dernier enregistrement du journal inclus (voir MacroManager)
+    static bool Write(const std::wstring& path, const SnapshotSource& source, uint64_t journalSequence,
+                      const std::vector<BasicMacro>& basicMacros,
+                      const std::vector<ImageMacro>& imageMacros,
+                      const std::vector<ComboMacro>& comboMacros);
+
+    // Projeter et valider le fichier (version, bornes, somme de contrôle, source)
+    bool Open(const std::wstring& path, const SnapshotSource& source);
+    void Close();
+    bool IsOpen() const { return m_header != nullptr; }
+
+    // Accès en place, valides tant que le snapshot est ouvert
+    uint32_t BasicCount() const;
+    uint32_t ImageCount() const;
+    uint32_t ComboCount() const;
+    uint64_t JournalSequence() const;
+    const BasicRecord& Basic(uint32_t index) const { return m_basic[index]; }
+    const ImageRecord& Image(uint32_t index) const { return m_image[index]; }
+    const ComboRecord& Combo(uint32_t index) const { return m_combo[index]; }
+
+    const uint16_t* StringData(uint32_t id, uint32_t& length) const;
+    uint32_t StringRef(uint32_t index) const { return m_refs[index]; }
+    MacroInstruction Instruction(uint32_t index) const;
+
+    std::wstring String(uint32_t id) const;
+    void AppendString(uint32_t id, std::vector<wchar_t>& out) const;    // Sans allocation si out a la place
+
+    // Reconstruire les macros, programmes compilés compris
+    void Materialize(std::vector<BasicMacro>& basicMacros,
+                     std::vector<ImageMacro>& imageMacros,
+                     std::vector<ComboMacro>& comboMacros) const;
+
+private:
+    struct Header;
+
+    bool Validate(const SnapshotSource& source);
+
+    MappedFile m_file;
+    const Header* m_header;
+    const uint32_t* m_stringOffsets;
+    const uint16_t* m_chars;
+    const uint32_t* m_refs;
+    const InstructionRecord* m_instructions;
+    const BasicRecord* m_basic;
+    const ImageRecord* m_image;
+    const ComboRecord* m_combo;
+};
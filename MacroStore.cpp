@@ -0,0 +1,256 @@
+#include "MacroStore.h"
+#include "KeyTable.h"
+#include "MacroSnapshot.h"
+#include <cwchar>
+
+const uint32_t MacroStore::NO_ROW;
+
+MacroStore::MacroStore() {
+    for (int k = 0; k < 4; k++) m_kindBegin[k] = 0;
+    m_programBegin.push_back(0);
+    m_actionBegin.push_back(0);
+    m_text.push_back(L'\0');
+}
+
+std::shared_ptr<const MacroStore> MacroStore::Build(const MacroManager& macros) {
+    std::shared_ptr<MacroStore> store = std::make_shared<MacroStore>();
+
+    // Tailles exactes d'abord : chaque tableau est alloué une seule fois
+    size_t rows = macros.basicMacros.size() + macros.imageMacros.size() + macros.comboMacros.size();
+    size_t actions = 0;
+    size_t textChars = 0;
+    for (const auto& m : macros.basicMacros) {
+        actions += m.actions.size();
+        textChars += m.name.size() + m.hotkey.size() + 2;
+        for (const auto& action : m.actions) textChars += action.size() + 1;
+    }
+    for (const auto& m : macros.imageMacros) {
+        actions += 1;
+        textChars += m.name.size() + m.imagePath.size() + m.action.size() + 3;
+    }
+    for (const auto& m : macros.comboMacros) {
+        actions += m.skills.size();
+        textChars += m.name.size() + m.hotkey.size() + 2;
+        for (const auto& skill : m.skills) textChars += skill.size() + 1;
+    }
+    store->Reserve(rows, actions, actions, textChars);
+
+    store->m_kindBegin[(int)MacroKind::Basic] = (uint32_t)store->Size();
+    for (const auto& m : macros.basicMacros) {
+        uint8_t flags = (m.enabled ? FLAG_ENABLED : 0) | (m.loop ? FLAG_LOOP : 0) | (m.holdMode ? FLAG_HOLD_MODE : 0);
+        uint32_t name = store->AddText(m.name);
+        uint32_t hotkey = store->AddText(m.hotkey);
+        store->AddRow(MacroKind::Basic, m.id, flags, hotkey, m.overloadPolicy, m.queueLimit, 0, name);
+        store->m_imagePaths.push_back(0);
+        store->m_searchModes.push_back(ImageSearchMode::Exact);
+        for (const auto& action : m.actions) store->m_actions.push_back(store->AddText(action));
+        store->AddProgram(m.program, m.actions);
+    }
+
+    store->m_kindBegin[(int)MacroKind::Image] = (uint32_t)store->Size();
+    for (const auto& m : macros.imageMacros) {
+        uint8_t flags = m.enabled ? FLAG_ENABLED : 0;
+        uint32_t name = store->AddText(m.name);
+        store->AddRow(MacroKind::Image, m.id, flags, 0, OverloadPolicy::DropNew, 1, m.confidence, name);
+        store->m_imagePaths.push_back(store->AddText(m.imagePath));
+        store->m_searchModes.push_back(m.searchMode);
+        store->m_actions.push_back(store->AddText(m.action));
+        store->m_program.push_back(MacroCompiler::CompileAction(m.action));
+        store->EndRow();
+    }
+
+    store->m_kindBegin[(int)MacroKind::Combo] = (uint32_t)store->Size();
+    for (const auto& m : macros.comboMacros) {
+        uint8_t flags = (m.enabled ? FLAG_ENABLED : 0) | (m.detectCooldown ? FLAG_DETECT_COOLDOWN : 0);
+        uint32_t name = store->AddText(m.name);
+        uint32_t hotkey = store->AddText(m.hotkey);
+        store->AddRow(MacroKind::Combo, m.id, flags, hotkey, m.overloadPolicy, m.queueLimit, m.delayBetween, name);
+        store->m_imagePaths.push_back(0);
+        store->m_searchModes.push_back(ImageSearchMode::Exact);
+        for (const auto& skill : m.skills) store->m_actions.push_back(store->AddText(skill));
+        store->AddProgram(m.program, m.skills);
+    }
+    store->m_kindBegin[3] = (uint32_t)store->Size();
+
+    store->IndexIds();
+    return store;
+}
+
+std::shared_ptr<const MacroStore> MacroStore::FromSnapshot(const MacroSnapshot& snapshot) {
+    std::shared_ptr<MacroStore> store = std::make_shared<MacroStore>();
+
+    // Tailles lues dans les enregistrements (texte : borne haute, en unités UTF-16)
+    auto textSize = [&snapshot](uint32_t id) {
+        uint32_t length;
+        snapshot.StringData(id, length);
+        return (size_t)length + 1;
+    };
+    size_t rows = (size_t)snapshot.BasicCount() + snapshot.ImageCount() + snapshot.ComboCount();
+    size_t actions = 0;
+    size_t textChars = 0;
+    for (uint32_t i = 0; i < snapshot.BasicCount(); i++) {
+        const MacroSnapshot::BasicRecord& r = snapshot.Basic(i);
+        actions += r.actionCount;
+        textChars += textSize(r.name) + textSize(r.hotkey);
+        for (uint32_t j = 0; j < r.actionCount; j++) textChars += textSize(snapshot.StringRef(r.firstAction + j));
+    }
+    for (uint32_t i = 0; i < snapshot.ImageCount(); i++) {
+        const MacroSnapshot::ImageRecord& r = snapshot.Image(i);
+        actions += 1;
+        textChars += textSize(r.name) + textSize(r.imagePath) + textSize(r.action);
+    }
+    for (uint32_t i = 0; i < snapshot.ComboCount(); i++) {
+        const MacroSnapshot::ComboRecord& r = snapshot.Combo(i);
+        actions += r.skillCount;
+        textChars += textSize(r.name) + textSize(r.hotkey);
+        for (uint32_t j = 0; j < r.skillCount; j++) textChars += textSize(snapshot.StringRef(r.firstSkill + j));
+    }
+    store->Reserve(rows, actions, actions, textChars);
+
+    MacroId id = 1;
+    store->m_kindBegin[(int)MacroKind::Basic] = (uint32_t)store->Size();
+    for (uint32_t i = 0; i < snapshot.BasicCount(); i++) {
+        const MacroSnapshot::BasicRecord& r = snapshot.Basic(i);
+        uint8_t flags = (r.enabled ? FLAG_ENABLED : 0) | (r.loop ? FLAG_LOOP : 0) | (r.holdMode ? FLAG_HOLD_MODE : 0);
+        uint32_t name = store->AddText(snapshot, r.name);
+        uint32_t hotkey = store->AddText(snapshot, r.hotkey);
+        store->AddRow(MacroKind::Basic, id++, flags, hotkey, (OverloadPolicy)r.overloadPolicy, r.queueLimit, 0, name);
+        store->m_imagePaths.push_back(0);
+        store->m_searchModes.push_back(ImageSearchMode::Exact);
+        for (uint32_t j = 0; j < r.actionCount; j++) {
+            store->m_actions.push_back(store->AddText(snapshot, snapshot.StringRef(r.firstAction + j)));
+            store->m_program.push_back(snapshot.Instruction(r.firstInstruction + j));
+        }
+        store->EndRow();
+    }
+
+    store->m_kindBegin[(int)MacroKind::Image] = (uint32_t)store->Size();
+    for (uint32_t i = 0; i < snapshot.ImageCount(); i++) {
+        const MacroSnapshot::ImageRecord& r = snapshot.Image(i);
+        uint8_t flags = r.enabled ? FLAG_ENABLED : 0;
+        uint32_t name = store->AddText(snapshot, r.name);
+        store->AddRow(MacroKind::Image, id++, flags, 0, OverloadPolicy::DropNew, 1, r.confidence, name);
+        store->m_imagePaths.push_back(store->AddText(snapshot, r.imagePath));
+        store->m_searchModes.push_back((ImageSearchMode)r.searchMode);
+        store->m_actions.push_back(store->AddText(snapshot, r.action));
+        store->m_program.push_back(snapshot.Instruction(r.instruction));
+        store->EndRow();
+    }
+
+    store->m_kindBegin[(int)MacroKind::Combo] = (uint32_t)store->Size();
+    for (uint32_t i = 0; i < snapshot.ComboCount(); i++) {
+        const MacroSnapshot::ComboRecord& r = snapshot.Combo(i);
+        uint8_t flags = (r.enabled ? FLAG_ENABLED : 0) | (r.detectCooldown ? FLAG_DETECT_COOLDOWN : 0);
+        uint32_t name = store->AddText(snapshot, r.name);
+        uint32_t hotkey = store->AddText(snapshot, r.hotkey);
+        store->AddRow(MacroKind::Combo, id++, flags, hotkey, (OverloadPolicy)r.overloadPolicy, r.queueLimit,
+                      r.delayBetween, name);
+        store->m_imagePaths.push_back(0);
+        store->m_searchModes.push_back(ImageSearchMode::Exact);
+        for (uint32_t j = 0; j < r.skillCount; j++) {
+            store->m_actions.push_back(store->AddText(snapshot, snapshot.StringRef(r.firstSkill + j)));
+            store->m_program.push_back(snapshot.Instruction(r.firstInstruction + j));
+        }
+        store->EndRow();
+    }
+    store->m_kindBegin[3] = (uint32_t)store->Size();
+
+    store->IndexIds();
+    return store;
+}
+
+size_t MacroStore::Count(MacroKind kind) const {
+    return m_kindBegin[(int)kind + 1] - m_kindBegin[(int)kind];
+}
+
+MacroView MacroStore::At(MacroKind kind, size_t index) const {
+    if (index >= Count(kind)) return MacroView();
+    return MacroView(this, m_kindBegin[(int)kind] + (uint32_t)index);
+}
+
+MacroView MacroStore::Find(MacroId id) const {
+    if (id == 0 || id >= m_rowById.size() || m_rowById[id] == NO_ROW) return MacroView();
+    return MacroView(this, m_rowById[id]);
+}
+
+void MacroStore::Reserve(size_t rows, size_t actions, size_t instructions, size_t textChars) {
+    m_ids.reserve(rows);
+    m_kinds.reserve(rows);
+    m_flags.reserve(rows);
+    m_triggerVk.reserve(rows);
+    m_policies.reserve(rows);
+    m_queueLimits.reserve(rows);
+    m_params.reserve(rows);
+    m_programBegin.reserve(rows + 1);
+    m_actionBegin.reserve(rows + 1);
+    m_names.reserve(rows);
+    m_hotkeys.reserve(rows);
+    m_imagePaths.reserve(rows);
+    m_searchModes.reserve(rows);
+    m_actions.reserve(actions);
+    m_program.reserve(instructions);
+    m_text.reserve(m_text.size() + textChars);
+}
+
+uint32_t MacroStore::AddText(const std::wstring& text) {
+    if (text.empty()) return 0;
+    uint32_t offset = (uint32_t)m_text.size();
+    m_text.insert(m_text.end(), text.begin(), text.end());
+    m_text.push_back(L'\0');
+    return offset;
+}
+
+uint32_t MacroStore::AddText(const MacroSnapshot& snapshot, uint32_t id) {
+    uint32_t length;
+    snapshot.StringData(id, length);
+    if (length == 0) return 0;
+    uint32_t offset = (uint32_t)m_text.size();
+    snapshot.AppendString(id, m_text);
+    m_text.push_back(L'\0');
+    return offset;
+}
+
+void MacroStore::AddRow(MacroKind kind, MacroId id, uint8_t flags, uint32_t hotkey,
+                        OverloadPolicy policy, int queueLimit, int param, uint32_t name) {
+    // Hotkey résolu une fois ici, pas à chaque démarrage du monitoring
+    const wchar_t* hotkeyText = &m_text[hotkey];
+    int vk = hotkey == 0 ? 0 : KeyTable::Lookup(hotkeyText, std::wcslen(hotkeyText));
+
+    m_ids.push_back(id);
+    m_kinds.push_back(kind);
+    m_flags.push_back(flags);
+    m_triggerVk.push_back(vk > 0 && vk <= 0xFFFF ? (uint16_t)vk : 0);
+    m_policies.push_back(policy);
+    m_queueLimits.push_back(queueLimit > 0 ? (uint32_t)queueLimit : 1);
+    m_params.push_back(param);
+    m_names.push_back(name);
+    m_hotkeys.push_back(hotkey);
+}
+
+void MacroStore::AddProgram(const std::vector<MacroInstruction>& program, const std::vector<std::wstring>& actions) {
+    // Programme compilé au chargement/sauvegarde, ou compilé ici si la macro
+    // n'est pas encore passée par MacroCompiler
+    if (program.size() == actions.size()) {
+        m_program.insert(m_program.end(), program.begin(), program.end());
+    } else {
+        for (const auto& action : actions) m_program.push_back(MacroCompiler::CompileAction(action));
+    }
+    EndRow();
+}
+
+void MacroStore::EndRow() {
+    m_programBegin.push_back((uint32_t)m_program.size());
+    m_actionBegin.push_back((uint32_t)m_actions.size());
+}
+
+void MacroStore::IndexIds() {
+    // Table identifiant -> ligne (les identifiants sont attribués séquentiellement)
+    MacroId maxId = 0;
+    for (MacroId id : m_ids) {
+        if (id > maxId) maxId = id;
+    }
+    m_rowById.assign((size_t)maxId + 1, NO_ROW);
+    for (uint32_t row = 0; row < (uint32_t)Size(); row++) {
+        if (m_ids[row] != 0) m_rowById[m_ids[row]] = row;
+    }
+}
@@ -0,0 +1,165 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "MacroManager.h"
+
+class MacroStore;
+class MacroSnapshot;
+
+// Accès léger à une macro d'un MacroStore (store + ligne), copié par valeur.
+// Valide tant que le store l'est ; les chaînes pointent dans son arène.
+class MacroView {
+public:
+    MacroView() : m_store(nullptr), m_row(0) {}
+    MacroView(const MacroStore* store, uint32_t row) : m_store(store), m_row(row) {}
+
+    bool IsValid() const { return m_store != nullptr; }
+    uint32_t Row() const { return m_row; }
+
+    MacroId Id() const;
+    MacroKind Kind() const;
+    size_t Index() const;               // Position dans sa catégorie (index des vecteurs de MacroManager)
+
+    bool Enabled() const;
+    bool Loop() const;                  // Basic
+    bool HoldMode() const;              // Basic
+    bool DetectCooldown() const;        // Combo
+    uint16_t TriggerVk() const;         // Hotkey résolu (0 = aucun)
+    OverloadPolicy Policy() const;
+    uint32_t QueueLimit() const;        // Au moins 1
+    int DelayBetween() const;           // Combo
+    int Confidence() const;             // Image
+    ImageSearchMode SearchMode() const; // Image
+
+    // Chaînes terminées par zéro, utilisables telles quelles par l'API Win32
+    const wchar_t* Name() const;
+    const wchar_t* Hotkey() const;
+    const wchar_t* ImagePath() const;   // Image
+
+    // Actions (Basic), skills (Combo) ou action unique (Image)
+    size_t ActionCount() const;
+    const wchar_t* Action(size_t i) const;
+
+    // Instructions compilées, une par action
+    const MacroInstruction* Program() const;
+    size_t ProgramSize() const;
+
+private:
+    const MacroStore* m_store;
+    uint32_t m_row;
+};
+
+// Copie en lecture seule des macros, organisée en tableaux (structure of arrays).
+// Les champs parcourus à chaque démarrage du monitoring ou à chaque
+// déclenchement (activation, touche, politique, programme) sont contigus ;
+// les textes (noms, actions) sont regroupés dans une seule arène.
+// Une ligne par macro, groupées par catégorie (Basic, Image puis Combo) dans
+// l'ordre des vecteurs de MacroManager.
+// Construite d'un bloc par Build() puis jamais modifiée : elle peut être
+// partagée entre threads (shared_ptr) sans verrou.
+class MacroStore {
+public:
+    enum Flags : uint8_t {
+        FLAG_ENABLED         = 0x01,
+        FLAG_LOOP            = 0x02,
+        FLAG_HOLD_MODE       = 0x04,
+        FLAG_DETECT_COOLDOWN = 0x08
+    };
+
+    MacroStore();   // Store vide
+
+    // Les macros doivent avoir un identifiant (MacroManager::AssignIds)
+    static std::shared_ptr<const MacroStore> Build(const MacroManager& macros);
+
+    // Directement depuis les enregistrements d'un snapshot ouvert, sans créer
+    // de macros intermédiaires. Identifiants 1..N dans l'ordre des lignes, ceux
+    // qu'attribue AssignIds aux mêmes macros fraîchement chargées.
+    static std::shared_ptr<const MacroStore> FromSnapshot(const MacroSnapshot& snapshot);
+
+    size_t Size() const { return m_ids.size(); }
+    size_t Count(MacroKind kind) const;
+
+    MacroView At(MacroKind kind, size_t index) const;   // Index dans la catégorie
+    MacroView Find(MacroId id) const;                   // Vue invalide si absent
+
+    // Tableaux chauds, indexés par ligne
+    const MacroId* IdData() const { return m_ids.data(); }
+    const uint8_t* FlagsData() const { return m_flags.data(); }
+    const uint16_t* TriggerVkData() const { return m_triggerVk.data(); }
+    uint32_t FirstRow(MacroKind kind) const { return m_kindBegin[(int)kind]; }
+
+    // Taille de l'arène de texte, en caractères
+    size_t TextSize() const { return m_text.size(); }
+
+private:
+    friend class MacroView;
+
+    static const uint32_t NO_ROW = 0xFFFFFFFF;
+
+    void Reserve(size_t rows, size_t actions, size_t instructions, size_t textChars);
+    uint32_t AddText(const std::wstring& text);
+    uint32_t AddText(const MacroSnapshot& snapshot, uint32_t id);
+    // name et hotkey : positions dans m_text
+    void AddRow(MacroKind kind, MacroId id, uint8_t flags, uint32_t hotkey,
+                OverloadPolicy policy, int queueLimit, int param, uint32_t name);
+    void AddProgram(const std::vector<MacroInstruction>& program, const std::vector<std::wstring>& actions);
+    void EndRow();
+    void IndexIds();
+
+    // Données chaudes, une entrée par ligne
+    std::vector<MacroId> m_ids;
+    std::vector<MacroKind> m_kinds;
+    std::vector<uint8_t> m_flags;
+    std::vector<uint16_t> m_triggerVk;
+    std::vector<OverloadPolicy> m_policies;
+    std::vector<uint32_t> m_queueLimits;
+    std::vector<int32_t> m_params;          // delayBetween (Combo) / confidence (Image)
+    std::vector<uint32_t> m_programBegin;   // Ligne r : [m_programBegin[r], m_programBegin[r + 1])
+    std::vector<uint32_t> m_actionBegin;    // Ligne r : [m_actionBegin[r], m_actionBegin[r + 1])
+    uint32_t m_kindBegin[4];                // Lignes de la catégorie k : [m_kindBegin[k], m_kindBegin[k + 1])
+    std::vector<uint32_t> m_rowById;        // Identifiant -> ligne (NO_ROW si absent)
+
+    // Données froides
+    std::vector<MacroInstruction> m_program;
+    std::vector<uint32_t> m_names;          // Positions dans m_text
+    std::vector<uint32_t> m_hotkeys;
+    std::vector<uint32_t> m_imagePaths;
+    std::vector<ImageSearchMode> m_searchModes;
+    std::vector<uint32_t> m_actions;
+    std::vector<wchar_t> m_text;            // Arène : chaînes terminées par zéro, la position 0 est ""
+};
+
+inline MacroId MacroView::Id() const { return m_store->m_ids[m_row]; }
+inline MacroKind MacroView::Kind() const { return m_store->m_kinds[m_row]; }
+inline size_t MacroView::Index() const { return m_row - m_store->m_kindBegin[(int)Kind()]; }
+inline bool MacroView::Enabled() const { return (m_store->m_flags[m_row] & MacroStore::FLAG_ENABLED) != 0; }
+inline bool MacroView::Loop() const { return (m_store->m_flags[m_row] & MacroStore::FLAG_LOOP) != 0; }
+inline bool MacroView::HoldMode() const { return (m_store->m_flags[m_row] & MacroStore::FLAG_HOLD_MODE) != 0; }
+inline bool MacroView::DetectCooldown() const { return (m_store->m_flags[m_row] & MacroStore::FLAG_DETECT_COOLDOWN) != 0; }
+inline uint16_t MacroView::TriggerVk() const { return m_store->m_triggerVk[m_row]; }
+inline OverloadPolicy MacroView::Policy() const { return m_store->m_policies[m_row]; }
+inline uint32_t MacroView::QueueLimit() const { return m_store->m_queueLimits[m_row]; }
+inline int MacroView::DelayBetween() const { return m_store->m_params[m_row]; }
+inline int MacroView::Confidence() const { return m_store->m_params[m_row]; }
+inline ImageSearchMode MacroView::SearchMode() const { return m_store->m_searchModes[m_row]; }
+inline const wchar_t* MacroView::Name() const { return &m_store->m_text[m_store->m_names[m_row]]; }
+inline const wchar_t* MacroView::Hotkey() const { return &m_store->m_text[m_store->m_hotkeys[m_row]]; }
+inline const wchar_t* MacroView::ImagePath() const { return &m_store->m_text[m_store->m_imagePaths[m_row]]; }
+
+inline size_t MacroView::ActionCount() const {
+    return m_store->m_actionBegin[m_row + 1] - m_store->m_actionBegin[m_row];
+}
+
+inline const wchar_t* MacroView::Action(size_t i) const {
+    return &m_store->m_text[m_store->m_actions[m_store->m_actionBegin[m_row] + i]];
+}
+
+inline const MacroInstruction* MacroView::Program() const {
+    return m_store->m_program.data() + m_store->m_programBegin[m_row];
+}
+
+inline size_t MacroView::ProgramSize() const {
+    return m_store->m_programBegin[m_row + 1] - m_store->m_programBegin[m_row];
+}
@@ -1,7 +1,10 @@
 #include "MainWindow.h"
+#include "MacroSnapshot.h"
+#include "MappedFile.h"
 #include <windowsx.h>
 #include <commctrl.h>
 #include <commdlg.h>
+#include <map>
 #include <sstream>
 #include <cstdio>
 
@@ -34,9 +37,29 @@
 #define ID_BTN_REMOVE_SKILL 2015
 #define ID_EDIT_DELAY       2016
 #define ID_CHECK_COOLDOWN   2017
+#define ID_COMBO_SEARCH_MODE 2018
+
+// IDs des hotkeys globaux : HOTKEY_ID_BASE + identifiant de la macro
+#define HOTKEY_ID_BASE      1000
+#define HOTKEY_ID_MAX       0xBFFF  // Plage réservée aux applications
 
 #pragma warning(disable: 4312)
 
+namespace {
+
+// Période de capture pour les macros image (10 images/s)
+const int CAPTURE_INTERVAL_MS = 100;
+
+MacroKind KindOf(MacroCategory category) {
+    switch (category) {
+        case MacroCategory::IMAGE: return MacroKind::Image;
+        case MacroCategory::COMBO: return MacroKind::Combo;
+        default:                   return MacroKind::Basic;
+    }
+}
+
+} // namespace
+
 MainWindow::MainWindow()
     : m_hwnd(nullptr)
     , m_hInstance(nullptr)
@@ -50,8 +73,15 @@ MainWindow::MainWindow()
     , m_fontSmall(nullptr)
     , m_fontBold(nullptr)
     , m_macrosEnabled(true)
-    , m_monitorThread(nullptr)
+    , m_macrosLoaded(false)
     , m_monitorRunning(false)
+    , m_triggerDispatcher(m_macroExecutor)
+    , m_imageMonitor(m_macroExecutor.GetTemplateCache(),
+                     [this](const std::shared_ptr<const MacroStore>& store, MacroView macro,
+                            FramePipeline::Clock::time_point capturedAt) {
+                         m_macroExecutor.ExecuteDetected(store, macro, capturedAt);
+                     })
+    , m_store(std::make_shared<MacroStore>())
     , m_basicMacros(m_macroManager.basicMacros)
     , m_imageMacros(m_macroManager.imageMacros)
     , m_comboMacros(m_macroManager.comboMacros)
@@ -69,7 +99,7 @@ MainWindow::MainWindow()
 
 MainWindow::~MainWindow() {
     StopHotkeyMonitoring();
-    SaveMacros();
+    FlushMacros();
 
     if (m_fontTitle) DeleteObject(m_fontTitle);
     if (m_fontNormal) DeleteObject(m_fontNormal);
@@ -77,104 +107,137 @@ MainWindow::~MainWindow() {
     if (m_fontBold) DeleteObject(m_fontBold);
 }
 
-void MainWindow::SaveMacros() {
+std::wstring MainWindow::DataPath(const wchar_t* fileName) const {
     wchar_t path[MAX_PATH];
     GetCurrentDirectoryW(MAX_PATH, path);
-    std::wstring fullPath = std::wstring(path) + L"\\macros.json";
-    m_macroManager.SaveToFile(fullPath);
+    return std::wstring(path) + L"\\" + fileName;
 }
 
-void MainWindow::LoadMacros() {
-    wchar_t path[MAX_PATH];
-    GetCurrentDirectoryW(MAX_PATH, path);
-    std::wstring fullPath = std::wstring(path) + L"\\macros.json";
-    m_macroManager.LoadFromFile(fullPath);
-    RefreshMacroList();
+void MainWindow::RebuildStore() {
+    // Les exécutions en cours gardent l'ancien store jusqu'à leur fin
+    m_macroManager.AssignIds();
+    m_store = MacroStore::Build(m_macroManager);
+
+    // Le monitoring passe au nouveau store sans être arrêté :
+    // les exécutions en cours continuent, aucun déclenchement n'est perdu
+    m_triggerDispatcher.Publish(m_store);
+    m_imageMonitor.Publish(m_store);
+    if (m_monitorRunning) SyncHotkeys();
 }
 
-void MainWindow::StartHotkeyMonitoring() {
-    if (m_monitorRunning) return;
+void MainWindow::SaveMacros() {
+    RebuildStore();
 
-    m_monitorRunning = true;
+    // Chaque modification est déjà dans le journal (voir MacroManager::Record*).
+    // Le JSON complet n'est réécrit, en arrière-plan, qu'une fois le journal trop long.
+    if (m_journal.NeedsCompaction()) {
+        m_saveWorker.Schedule(m_macroManager, DataPath(L"macros.json"), DataPath(L"macros.snapshot"));
+    }
+}
 
-    // Enregistrer tous les hotkeys
-    int hotkeyId = 1000;
-    for (const auto& macro : m_basicMacros) {
-        if (macro.enabled) {
-            m_hotkeyManager.RegisterHotkey(hotkeyId++, macro.hotkey, macro.holdMode);
-        }
+void MainWindow::FlushMacros() {
+    // En quittant, ramener le JSON (source éditable) à jour avec le journal.
+    // Macros jamais chargées : aucune modification depuis le snapshot.
+    if (m_macrosLoaded && (m_journal.RecordCount() > 0 || !m_journal.IsOpen())) {
+        m_saveWorker.Schedule(m_macroManager, DataPath(L"macros.json"), DataPath(L"macros.snapshot"));
     }
+    m_saveWorker.Flush();
+}
 
-    for (const auto& macro : m_comboMacros) {
-        if (macro.enabled) {
-            m_hotkeyManager.RegisterHotkey(hotkeyId++, macro.hotkey, false);
-        }
+void MainWindow::LoadMacros() {
+    std::wstring journalPath = DataPath(L"macros.journal");
+
+    // Démarrage courant : snapshot à jour et rien à rejouer. Le store est construit
+    // en place depuis le fichier projeté ; les macros éditables ne sont chargées
+    // qu'à la première modification (EnsureMacrosLoaded).
+    MacroSnapshot snapshot;
+    SnapshotSource source = {};
+    if (MappedFile::Stat(DataPath(L"macros.json"), source.size, source.writeTime) &&
+        snapshot.Open(DataPath(L"macros.snapshot"), source) &&
+        !MacroJournal::HasRecordsAfter(journalPath, snapshot.JournalSequence())) {
+        m_macroManager.journalSequence = snapshot.JournalSequence();
+        m_store = MacroStore::FromSnapshot(snapshot);
+        m_triggerDispatcher.Publish(m_store);
+        m_imageMonitor.Publish(m_store);
+    } else {
+        EnsureMacrosLoaded();
     }
+    snapshot.Close();
+
+    // Rejouer les modifications journalisées après le journalSequence chargé
+    m_journal.Open(journalPath, m_macroManager);
+    m_macroManager.AttachJournal(&m_journal);
+    m_saveWorker.SetJournal(&m_journal);
 
-    // Créer le thread de monitoring
-    m_monitorThread = CreateThread(nullptr, 0, [](LPVOID param) -> DWORD {
-        MainWindow* pThis = (MainWindow*)param;
-        pThis->ProcessHotkeys();
-        return 0;
-    }, this, 0, nullptr);
+    if (m_macrosLoaded) SaveMacros(); // Compaction si le journal rejoué est déjà long
+    RefreshMacroList();
 }
 
-void MainWindow::StopHotkeyMonitoring() {
-    m_monitorRunning = false;
-    if (m_monitorThread) {
-        WaitForSingleObject(m_monitorThread, 1000);
-        CloseHandle(m_monitorThread);
-        m_monitorThread = nullptr;
+void MainWindow::EnsureMacrosLoaded() {
+    if (m_macrosLoaded) return;
+    m_macrosLoaded = true;
+
+    std::wstring fullPath = DataPath(L"macros.json");
+    std::wstring snapshotPath = DataPath(L"macros.snapshot");
+
+    // Snapshot binaire s'il correspond encore au JSON, sinon JSON puis nouveau snapshot.
+    // Identifiants attribués dans le même ordre que MacroStore::FromSnapshot.
+    if (!m_macroManager.LoadSnapshot(snapshotPath, fullPath)) {
+        if (m_macroManager.LoadFromFile(fullPath)) {
+            m_macroManager.SaveSnapshot(snapshotPath, fullPath);
+        }
     }
+    m_macroManager.AssignIds();
 }
 
-void MainWindow::ProcessHotkeys() {
-    while (m_monitorRunning) {
-        // Vérifier les macros basiques
-        for (const auto& macro : m_basicMacros) {
-            if (!macro.enabled) continue;
-
-            if (macro.holdMode) {
-                // Mode maintien : exécuter tant que la touche est maintenue
-                if (m_hotkeyManager.IsKeyHeld(macro.hotkey)) {
-                    if (!m_macroExecutor.IsExecuting()) {
-                        m_macroExecutor.ExecuteBasicMacro(macro);
-                    }
-                } else {
-                    if (m_macroExecutor.IsExecuting()) {
-                        m_macroExecutor.StopExecution();
-                    }
-                }
-            } else {
-                // Mode pression simple
-                static std::map<std::wstring, bool> keyStates;
-                bool isPressed = m_hotkeyManager.IsKeyPressed(macro.hotkey);
+void MainWindow::StartHotkeyMonitoring() {
+    if (m_monitorRunning) return;
 
-                if (isPressed && !keyStates[macro.hotkey]) {
-                    m_macroExecutor.ExecuteBasicMacro(macro);
-                }
-                keyStates[macro.hotkey] = isPressed;
-            }
-        }
+    m_monitorRunning = true;
 
-        // Vérifier les macros combo
-        for (const auto& macro : m_comboMacros) {
-            if (!macro.enabled) continue;
+    SyncHotkeys();
+    m_triggerDispatcher.Start();
 
-            static std::map<std::wstring, bool> comboKeyStates;
-            bool isPressed = m_hotkeyManager.IsKeyPressed(macro.hotkey);
+    // Les fronts de touches arrivent des hooks : plus de boucle de polling
+    m_keySource.Start([this](const KeyEdge& edge) {
+        OnKeyEdge(edge);
+    });
 
-            if (isPressed && !comboKeyStates[macro.hotkey]) {
-                m_macroExecutor.ExecuteComboMacro(macro);
+    // Détection des macros image, en continu sur les captures de l'écran
+    m_framePipeline.Start(m_screenCapture, CAPTURE_INTERVAL_MS, [this](const CapturedFrame& frame) {
+        m_imageMonitor.ProcessFrame(frame);
+    });
+}
+
+void MainWindow::StopHotkeyMonitoring() {
+    m_monitorRunning = false;
+    m_framePipeline.Stop();
+    m_keySource.Stop();
+    m_triggerDispatcher.Stop();
+    m_hotkeyManager.UnregisterAll();
+}
+
+void MainWindow::SyncHotkeys() {
+    // Identifiant stable par macro : une modification ne touche que ses propres hotkeys
+    std::map<int, UINT> wanted;
+    const MacroKind kinds[] = { MacroKind::Basic, MacroKind::Combo };
+    for (MacroKind kind : kinds) {
+        for (size_t i = 0; i < m_store->Count(kind); i++) {
+            MacroView macro = m_store->At(kind, i);
+            int hotkeyId = HOTKEY_ID_BASE + (int)macro.Id();
+            if (macro.Enabled() && macro.TriggerVk() != 0 && hotkeyId <= HOTKEY_ID_MAX) {
+                wanted[hotkeyId] = macro.TriggerVk();
             }
-            comboKeyStates[macro.hotkey] = isPressed;
         }
+    }
+    m_hotkeyManager.SyncHotkeys(wanted);
+}
 
-        // Image detection (à implémenter)
-        // TODO: Ajouter la détection d'image en utilisant OpenCV
+void MainWindow::OnKeyEdge(const KeyEdge& edge) {
+    if (!m_monitorRunning) return;
 
-        Sleep(10); // Éviter une utilisation CPU excessive
-    }
+    // Thread des hooks : on dépose le déclenchement sans bloquer ni allouer
+    m_triggerDispatcher.OnKeyEdge(edge);
 }
 
 
@@ -319,7 +382,7 @@ LRESULT MainWindow::HandleMessage(UINT uMsg, WPARAM wParam, LPARAM lParam) {
     switch (uMsg) {
         case WM_DESTROY:
             StopHotkeyMonitoring();
-            SaveMacros();
+            FlushMacros(); // Écrire les modifications encore en attente
             PostQuitMessage(0);
             return 0;
 
@@ -376,12 +439,7 @@ case WM_LBUTTONDOWN: {
     int yPos = 120 - m_scrollPos;
     int cardHeight = (m_currentCategory == MacroCategory::COMBO) ? 140 : 110;
 
-    size_t macroCount = 0;
-    switch (m_currentCategory) {
-        case MacroCategory::BASIC: macroCount = m_basicMacros.size(); break;
-        case MacroCategory::IMAGE: macroCount = m_imageMacros.size(); break;
-        case MacroCategory::COMBO: macroCount = m_comboMacros.size(); break;
-    }
+    size_t macroCount = m_store->Count(KindOf(m_currentCategory));
 
     for (size_t i = 0; i < macroCount; i++) {
         RECT cardRect = { 290, yPos, 1170, yPos + 100 };
@@ -427,12 +485,7 @@ case WM_LBUTTONDOWN: {
     int yPos = 120 - m_scrollPos;
     int cardHeight = (m_currentCategory == MacroCategory::COMBO) ? 140 : 110;
 
-    size_t macroCount = 0;
-    switch (m_currentCategory) {
-        case MacroCategory::BASIC: macroCount = m_basicMacros.size(); break;
-        case MacroCategory::IMAGE: macroCount = m_imageMacros.size(); break;
-        case MacroCategory::COMBO: macroCount = m_comboMacros.size(); break;
-    }
+    size_t macroCount = m_store->Count(KindOf(m_currentCategory));
 
     for (size_t i = 0; i < macroCount; i++) {
         RECT cardRect = { 290, yPos, 1170, yPos + 100 };
@@ -580,30 +633,14 @@ void MainWindow::PaintContent(HDC hdc, RECT& rect) {
 
     int yPos = 120 - m_scrollPos;
 
-    switch (m_currentCategory) {
-        case MacroCategory::BASIC:
-            for (size_t i = 0; i < m_basicMacros.size(); i++) {
-                PaintMacroCard(hdc, rect.left + 30, yPos, (int)i);
-                yPos += 110;
-            }
-            break;
-        case MacroCategory::IMAGE:
-            for (size_t i = 0; i < m_imageMacros.size(); i++) {
-                PaintMacroCard(hdc, rect.left + 30, yPos, (int)i);
-                yPos += 110;
-            }
-            break;
-        case MacroCategory::COMBO:
-            for (size_t i = 0; i < m_comboMacros.size(); i++) {
-                PaintMacroCard(hdc, rect.left + 30, yPos, (int)i);
-                yPos += 140;
-            }
-            break;
+    size_t macroCount = m_store->Count(KindOf(m_currentCategory));
+    int cardStep = m_currentCategory == MacroCategory::COMBO ? 140 : 110;
+    for (size_t i = 0; i < macroCount; i++) {
+        PaintMacroCard(hdc, rect.left + 30, yPos, (int)i);
+        yPos += cardStep;
     }
 
-    if ((m_currentCategory == MacroCategory::BASIC && m_basicMacros.empty()) ||
-        (m_currentCategory == MacroCategory::IMAGE && m_imageMacros.empty()) ||
-        (m_currentCategory == MacroCategory::COMBO && m_comboMacros.empty())) {
+    if (macroCount == 0) {
 
         SetTextColor(hdc, COLOR_TEXT_GRAY);
         SelectObject(hdc, m_fontNormal);
@@ -651,17 +688,17 @@ void MainWindow::PaintMacroCard(HDC hdc, int x, int y, int index) {
     SetTextColor(hdc, RGB(255, 255, 255));
     SelectObject(hdc, m_fontNormal);
 
-    std::wstring name = L"Macro " + std::to_wstring(index + 1);
-    if (m_currentCategory == MacroCategory::BASIC && index < (int)m_basicMacros.size()) {
-        name = m_basicMacros[index].name;
-    } else if (m_currentCategory == MacroCategory::IMAGE && index < (int)m_imageMacros.size()) {
-        name = m_imageMacros[index].name;
-    } else if (m_currentCategory == MacroCategory::COMBO && index < (int)m_comboMacros.size()) {
-        name = m_comboMacros[index].name;
+    // Nom lu directement dans l'arène du store, sans copie
+    MacroView macro = m_store->At(KindOf(m_currentCategory), index);
+    std::wstring fallback;
+    const wchar_t* name = macro.IsValid() ? macro.Name() : nullptr;
+    if (!name) {
+        fallback = L"Macro " + std::to_wstring(index + 1);
+        name = fallback.c_str();
     }
 
     RECT nameRect = { x + 84, y + 24, x + 500, y + 50 };
-    DrawTextW(hdc, name.c_str(), -1, &nameRect, DT_LEFT | DT_TOP);
+    DrawTextW(hdc, name, -1, &nameRect, DT_LEFT | DT_TOP);
 
     SetTextColor(hdc, COLOR_TEXT_GRAY);
     SelectObject(hdc, m_fontSmall);
@@ -681,6 +718,7 @@ void MainWindow::PaintMacroCard(HDC hdc, int x, int y, int index) {
 }
 
 void MainWindow::OnAddMacro() {
+    EnsureMacrosLoaded();
     switch (m_currentCategory) {
     case MacroCategory::BASIC:
         ShowBasicMacroDialog();
@@ -695,6 +733,7 @@ void MainWindow::OnAddMacro() {
 }
 
 void MainWindow::OnEditMacro(int index) {
+    EnsureMacrosLoaded();
     switch (m_currentCategory) {
     case MacroCategory::BASIC:
         if (index >= 0 && index < (int)m_basicMacros.size())
@@ -718,44 +757,60 @@ void MainWindow::OnDeleteMacro(int index) {
         MB_YESNO | MB_ICONQUESTION);
 
     if (result == IDYES) {
+        EnsureMacrosLoaded();
         switch (m_currentCategory) {
         case MacroCategory::BASIC:
-            if (index >= 0 && index < (int)m_basicMacros.size())
+            if (index >= 0 && index < (int)m_basicMacros.size()) {
                 m_basicMacros.erase(m_basicMacros.begin() + index);
+                m_macroManager.RecordDeleted(MacroKind::Basic, index);
+            }
             break;
         case MacroCategory::IMAGE:
-            if (index >= 0 && index < (int)m_imageMacros.size())
+            if (index >= 0 && index < (int)m_imageMacros.size()) {
                 m_imageMacros.erase(m_imageMacros.begin() + index);
+                m_macroManager.RecordDeleted(MacroKind::Image, index);
+            }
             break;
         case MacroCategory::COMBO:
-            if (index >= 0 && index < (int)m_comboMacros.size())
+            if (index >= 0 && index < (int)m_comboMacros.size()) {
                 m_comboMacros.erase(m_comboMacros.begin() + index);
+                m_macroManager.RecordDeleted(MacroKind::Combo, index);
+            }
             break;
         default:
             break;
         }
 
-        // Sauvegarder après suppression
+        // Sauvegarder après suppression (le monitoring suit le nouveau store)
         SaveMacros();
         InvalidateRect(m_hwnd, nullptr, TRUE);
     }
 }
 
 void MainWindow::OnToggleStatus(int index) {
+    EnsureMacrosLoaded();
     switch (m_currentCategory) {
     case MacroCategory::BASIC:
-        if (index >= 0 && index < (int)m_basicMacros.size())
+        if (index >= 0 && index < (int)m_basicMacros.size()) {
             m_basicMacros[index].enabled = !m_basicMacros[index].enabled;
+            m_macroManager.RecordEnabled(MacroKind::Basic, index);
+        }
         break;
     case MacroCategory::IMAGE:
-        if (index >= 0 && index < (int)m_imageMacros.size())
+        if (index >= 0 && index < (int)m_imageMacros.size()) {
             m_imageMacros[index].enabled = !m_imageMacros[index].enabled;
+            m_macroManager.RecordEnabled(MacroKind::Image, index);
+        }
         break;
     case MacroCategory::COMBO:
-        if (index >= 0 && index < (int)m_comboMacros.size())
+        if (index >= 0 && index < (int)m_comboMacros.size()) {
             m_comboMacros[index].enabled = !m_comboMacros[index].enabled;
+            m_macroManager.RecordEnabled(MacroKind::Combo, index);
+        }
         break;
     }
+
+    SaveMacros();
     InvalidateRect(m_hwnd, nullptr, TRUE);
 }
 
@@ -774,6 +829,8 @@ void MainWindow::ShowBasicMacroDialog(int editIndex) {
         data->basicMacro->enabled = true;
         data->basicMacro->loop = false;
         data->basicMacro->holdMode = false;
+        data->basicMacro->overloadPolicy = OverloadPolicy::DropNew;
+        data->basicMacro->queueLimit = 1;
     }
 
     // Créer la fenêtre de dialogue
@@ -980,20 +1037,22 @@ void MainWindow::ShowBasicMacroDialog(int editIndex) {
                     data->basicMacro->loop = (SendMessage(hCheckLoop, BM_GETCHECK, 0, 0) == BST_CHECKED);
                     data->basicMacro->holdMode = (SendMessage(hCheckHold, BM_GETCHECK, 0, 0) == BST_CHECKED);
 
+                    // Compiler les actions pour l'exécuteur
+                    data->basicMacro->program = MacroCompiler::CompileActions(data->basicMacro->actions);
+
                     // Ajouter à la liste si c'est une nouvelle macro
                     if (editIndex == -1) {
                         m_basicMacros.push_back(*data->basicMacro);
                         delete data->basicMacro;
                         data->basicMacro = nullptr;
+                        m_macroManager.RecordAdded(MacroKind::Basic);
+                    } else {
+                        m_macroManager.RecordUpdated(MacroKind::Basic, editIndex);
                     }
 
                     // Sauvegarder dans le JSON temporaire
                     SaveMacros();
 
-                    // Redémarrer le monitoring
-                    StopHotkeyMonitoring();
-                    StartHotkeyMonitoring();
-
                     // Fermer le dialogue
                     dialogActive = false;
                     DestroyWindow(hwndDlg);
@@ -1054,6 +1113,8 @@ void MainWindow::ShowComboMacroDialog(int editIndex) {
         data->comboMacro->delayBetween = 200;
         data->comboMacro->detectCooldown = true;
         data->comboMacro->enabled = true;
+        data->comboMacro->overloadPolicy = OverloadPolicy::DropNew;
+        data->comboMacro->queueLimit = 1;
     }
 
     HWND hwndDlg = CreateWindowExW(
@@ -1204,16 +1265,18 @@ void MainWindow::ShowComboMacroDialog(int editIndex) {
                     data->comboMacro->hotkey = hotkey;
                     data->comboMacro->delayBetween = _wtoi(delayText);
                     data->comboMacro->detectCooldown = (SendMessage(hCheckCooldown, BM_GETCHECK, 0, 0) == BST_CHECKED);
+                    data->comboMacro->program = MacroCompiler::CompileActions(data->comboMacro->skills);
 
                     if (editIndex == -1) {
                         m_comboMacros.push_back(*data->comboMacro);
                         delete data->comboMacro;
                         data->comboMacro = nullptr;
+                        m_macroManager.RecordAdded(MacroKind::Combo);
+                    } else {
+                        m_macroManager.RecordUpdated(MacroKind::Combo, editIndex);
                     }
 
                     SaveMacros();
-                    StopHotkeyMonitoring();
-                    StartHotkeyMonitoring();
 
                     dialogActive = false;
                     DestroyWindow(hwndDlg);
@@ -1270,6 +1333,7 @@ void MainWindow::ShowImageMacroDialog(int editIndex) {
         data->imageMacro->imagePath = L"";
         data->imageMacro->action = L"Press Q";
         data->imageMacro->confidence = 85;
+        data->imageMacro->searchMode = ImageSearchMode::Balanced;
         data->imageMacro->enabled = true;
     }
 
@@ -1357,15 +1421,30 @@ void MainWindow::ShowImageMacroDialog(int editIndex) {
     SendMessage(hSlider, TBM_SETRANGE, TRUE, MAKELPARAM(50, 100));
     SendMessage(hSlider, TBM_SETPOS, TRUE, data->imageMacro->confidence);
 
+    CreateWindowW(L"STATIC", L"Search Mode:",
+        WS_CHILD | WS_VISIBLE | SS_LEFT,
+        leftMargin, 350, 200, 20, hwndDlg, nullptr, m_hInstance, nullptr);
+
+    // Même ordre que ImageSearchMode
+    HWND hComboSearch = CreateWindowW(L"COMBOBOX", nullptr,
+        WS_CHILD | WS_VISIBLE | CBS_DROPDOWNLIST | WS_VSCROLL,
+        leftMargin, 375, controlWidth, 200, hwndDlg, (HMENU)ID_COMBO_SEARCH_MODE,
+        m_hInstance, nullptr);
+    SendMessage(hComboSearch, WM_SETFONT, (WPARAM)hFont, TRUE);
+    SendMessageW(hComboSearch, CB_ADDSTRING, 0, (LPARAM)L"Exact (every position, slowest)");
+    SendMessageW(hComboSearch, CB_ADDSTRING, 0, (LPARAM)L"Balanced (pyramid, recommended)");
+    SendMessageW(hComboSearch, CB_ADDSTRING, 0, (LPARAM)L"Fast (coarser pyramid)");
+    SendMessage(hComboSearch, CB_SETCURSEL, (WPARAM)data->imageMacro->searchMode, 0);
+
     HWND hBtnSave = CreateWindowW(L"BUTTON", L"💾 Save Macro",
         WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
-        leftMargin, 360, 250, 40, hwndDlg, (HMENU)ID_BTN_SAVE,
+        leftMargin, 420, 250, 40, hwndDlg, (HMENU)ID_BTN_SAVE,
         m_hInstance, nullptr);
     SendMessage(hBtnSave, WM_SETFONT, (WPARAM)m_fontNormal, TRUE);
 
     HWND hBtnCancel = CreateWindowW(L"BUTTON", L"❌ Cancel",
         WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
-        295, 360, 275, 40, hwndDlg, (HMENU)ID_BTN_CANCEL,
+        295, 420, 275, 40, hwndDlg, (HMENU)ID_BTN_CANCEL,
         m_hInstance, nullptr);
     SendMessage(hBtnCancel, WM_SETFONT, (WPARAM)m_fontNormal, TRUE);
 
@@ -1400,15 +1479,20 @@ void MainWindow::ShowImageMacroDialog(int editIndex) {
                     GetWindowTextW(hEditPath, path, MAX_PATH);
                     GetWindowTextW(hEditAction, action, 256);
                     int confidence = (int)SendMessage(hSlider, TBM_GETPOS, 0, 0);
+                    int searchMode = (int)SendMessage(hComboSearch, CB_GETCURSEL, 0, 0);
 
                     data->imageMacro->name = name;
                     data->imageMacro->imagePath = path;
                     data->imageMacro->action = action;
                     data->imageMacro->confidence = confidence;
+                    if (searchMode >= 0) data->imageMacro->searchMode = (ImageSearchMode)searchMode;
 
                     if (editIndex == -1) {
                         m_imageMacros.push_back(*data->imageMacro);
                         delete data->imageMacro;
+                        m_macroManager.RecordAdded(MacroKind::Image);
+                    } else {
+                        m_macroManager.RecordUpdated(MacroKind::Image, editIndex);
                     }
 
                     SaveMacros();
@@ -4,7 +4,15 @@
 #include <vector>
 #include "MacroManager.h"
 #include "HotkeyManager.h"
+#include "FramePipeline.h"
+#include "ImageMonitor.h"
 #include "MacroExecutor.h"
+#include "MacroJournal.h"
+#include "MacroSaveWorker.h"
+#include "MacroStore.h"
+#include "TriggerDispatcher.h"
+#include "Win32KeyHookSource.h"
+#include "Win32ScreenCapture.h"
 
 enum class MacroCategory {
     BASIC,
@@ -55,10 +63,15 @@ private:
 
     // Nouvelles fonctions
     void SaveMacros();
+    void RebuildStore();
+    void FlushMacros();
     void LoadMacros();
+    void EnsureMacrosLoaded();
+    std::wstring DataPath(const wchar_t* fileName) const;
     void StartHotkeyMonitoring();
     void StopHotkeyMonitoring();
-    void ProcessHotkeys();
+    void SyncHotkeys();
+    void OnKeyEdge(const KeyEdge& edge);
 
     HWND m_hwnd;
     HINSTANCE m_hInstance;
@@ -70,17 +83,36 @@ private:
     int m_hoverIndex;
 
     bool m_macrosEnabled;
+    bool m_macrosLoaded;            // Vecteurs de m_macroManager remplis (sinon m_store vient du snapshot)
 
     // Gestionnaires
     MacroManager m_macroManager;
     HotkeyManager m_hotkeyManager;
     MacroExecutor m_macroExecutor;
+    MacroJournal m_journal;         // Doit survivre au worker de sauvegarde (Rebase)
+    MacroSaveWorker m_saveWorker;
 
-    // Thread de monitoring
-    HANDLE m_monitorThread;
+    // Source des fronts de touches (hooks bas niveau) pour le monitoring
+    Win32KeyHookSource m_keySource;
     bool m_monitorRunning;
 
-    // Rfrences aux vecteurs de macros
+    // File des dclenchements : le thread des hooks ne fait que dposer,
+    // le dmarrage des macros a lieu sur les consommateurs du dispatcher.
+    // Chaque nouveau store lui est publi (index virtual key -> macros compris).
+    TriggerDispatcher m_triggerDispatcher;
+
+    // Dtection des macros image : capture de l'cran sur un thread, recherche
+    // sur un autre (triple tampon entre les deux). Le monitor reoit chaque
+    // nouveau store et lance la macro  l'apparition de son modle.
+    Win32ScreenCapture m_screenCapture;
+    ImageMonitor m_imageMonitor;
+    FramePipeline m_framePipeline;      // Dclar aprs : arrt avant la source et le monitor
+
+    // Copie en lecture seule des macros (affichage, monitoring, excution),
+    // reconstruite aprs chaque modification des vecteurs
+    std::shared_ptr<const MacroStore> m_store;
+
+    // Rfrences aux vecteurs de macros (dition)
     std::vector<BasicMacro>& m_basicMacros;
     std::vector<ImageMacro>& m_imageMacros;
     std::vector<ComboMacro>& m_comboMacros;
@@ -0,0 +1,25 @@
+#pragma once
+#include "InputSink.h"
+#include <atomic>
+#include <cstdint>
+
+// Sink sans effet qui se contente de compter les lots et les événements.
+// Sink par défaut hors Windows ; sert aussi aux mesures, où l'enregistrement
+// de chaque lot (RecordingInputSink) fausserait le résultat.
+class NullInputSink : public InputSink {
+public:
+    NullInputSink() : m_batches(0), m_events(0) {}
+
+    void Submit(const InputEvent* events, size_t count) override {
+        (void)events;
+        m_batches.fetch_add(1, std::memory_order_relaxed);
+        m_events.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    uint64_t BatchCount() const { return m_batches.load(std::memory_order_relaxed); }
+    uint64_t EventCount() const { return m_events.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> m_batches;
+    std::atomic<uint64_t> m_events;
+};
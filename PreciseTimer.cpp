@@ -0,0 +1,109 @@
+#include "PreciseTimer.h"
+#include <thread>
+#include <limits>
+
+namespace {
+
+// Marge finale attendue en spin/yield plutôt qu'en sommeil :
+// le sommeil Windows est arrondi au tick (~1 ms avec timeBeginPeriod(1))
+#ifdef _WIN32
+const std::chrono::microseconds SPIN_WINDOW(2000);
+#else
+const std::chrono::microseconds SPIN_WINDOW(200);
+#endif
+
+// Au-delà de ce retard (mise en veille, thread gelé), on se recale sur
+// l'instant présent plutôt que d'enchaîner toutes les étapes en rafale
+const std::chrono::milliseconds MAX_LATENESS(250);
+
+const int64_t BUCKET_LIMITS_US[TimingStats::BucketCount - 1] = { 10, 50, 100, 250, 500, 1000, 5000 };
+
+} // namespace
+
+TimingStats::TimingStats() {
+    Reset();
+}
+
+void TimingStats::Record(int64_t errorUs) {
+    int bucket = 0;
+    while (bucket < BucketCount - 1 && errorUs >= BUCKET_LIMITS_US[bucket]) bucket++;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_report.steps++;
+    if (errorUs < m_report.minErrorUs) m_report.minErrorUs = errorUs;
+    if (errorUs > m_report.maxErrorUs) m_report.maxErrorUs = errorUs;
+    m_sumErrorUs += errorUs;
+    m_report.meanErrorUs = (double)m_sumErrorUs / (double)m_report.steps;
+    m_report.buckets[bucket]++;
+}
+
+TimingStats::Report TimingStats::GetReport() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Report report = m_report;
+    if (report.steps == 0) {
+        report.minErrorUs = 0;
+        report.maxErrorUs = 0;
+    }
+    return report;
+}
+
+void TimingStats::Reset() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_report = Report();
+    m_report.minErrorUs = std::numeric_limits<int64_t>::max();
+    m_report.maxErrorUs = std::numeric_limits<int64_t>::min();
+    m_sumErrorUs = 0;
+}
+
+int64_t TimingStats::BucketLimitUs(int i) {
+    if (i < 0 || i >= BucketCount - 1) return -1;
+    return BUCKET_LIMITS_US[i];
+}
+
+DeadlineTimer::DeadlineTimer(TimingStats* stats, const CancellationToken* token, MacroClock* clock)
+    : m_clock(clock ? clock : &MacroClock::System())
+    , m_deadline(m_clock->Now())
+    , m_stats(stats)
+    , m_token(token)
+{
+}
+
+void DeadlineTimer::Restart() {
+    m_deadline = m_clock->Now();
+}
+
+bool DeadlineTimer::WaitFor(uint32_t ms) {
+    m_deadline += std::chrono::milliseconds(ms);
+    if (!m_clock->SleepUntil(m_deadline, m_token)) {
+        return false; // Annulé : l'erreur de timing n'a pas de sens ici
+    }
+
+    Clock::time_point now = m_clock->Now();
+    if (m_stats) {
+        m_stats->Record(std::chrono::duration_cast<std::chrono::microseconds>(now - m_deadline).count());
+    }
+
+    if (now - m_deadline > MAX_LATENESS) {
+        m_deadline = now;
+    }
+    return true;
+}
+
+bool DeadlineTimer::SleepUntil(Clock::time_point deadline, const CancellationToken* token) {
+    // Sommeil grossier jusqu'à la fenêtre de spin
+    Clock::time_point coarse = deadline - SPIN_WINDOW;
+    if (Clock::now() < coarse) {
+        if (token) {
+            if (token->WaitUntil(coarse)) return false;
+        } else {
+            std::this_thread::sleep_until(coarse);
+        }
+    }
+
+    // Fin d'attente précise
+    while (Clock::now() < deadline) {
+        if (token && token->IsCancelled()) return false;
+        std::this_thread::yield();
+    }
+    return !(token && token->IsCancelled());
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include "CancellationToken.h"
+#include "MacroClock.h"
+
+// Statistiques d'erreur de timing : réveil réel - échéance prévue, en microsecondes
+class TimingStats {
+public:
+    static const int BucketCount = 8;
+
+    struct Report {
+        uint64_t steps;
+        int64_t minErrorUs;
+        int64_t maxErrorUs;
+        double meanErrorUs;
+        uint64_t buckets[BucketCount]; // Répartition selon BucketLimitUs()
+    };
+
+    TimingStats();
+
+    // Enregistrer l'erreur d'une étape
+    void Record(int64_t errorUs);
+
+    Report GetReport() const;
+    void Reset();
+
+    // Borne haute (exclue) de la classe i, en µs ; la dernière classe est ouverte (-1)
+    static int64_t BucketLimitUs(int i);
+
+private:
+    mutable std::mutex m_mutex;
+    Report m_report;
+    int64_t m_sumErrorUs;
+};
+
+// Attente sur échéances absolues d'une horloge monotone.
+// Chaque WaitFor() avance l'échéance de la durée nominale au lieu de repartir
+// de "maintenant" : l'erreur d'une étape ne se reporte pas sur les suivantes.
+// Avec un jeton d'annulation, toute attente se termine dès Cancel().
+// Le temps vient de l'horloge fournie (système par défaut, virtuelle en simulation).
+class DeadlineTimer {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    explicit DeadlineTimer(TimingStats* stats = nullptr, const CancellationToken* token = nullptr,
+                           MacroClock* clock = nullptr);
+
+    // Repartir de l'instant présent
+    void Restart();
+
+    // Avancer l'échéance de ms millisecondes et attendre qu'elle soit atteinte.
+    // Retourne false si l'attente a été interrompue par le jeton.
+    bool WaitFor(uint32_t ms);
+
+    Clock::time_point Deadline() const { return m_deadline; }
+
+    // Sommeil grossier (réveillable) puis fin d'attente en spin/yield, en temps réel.
+    // Retourne false si le jeton a été annulé avant l'échéance.
+    static bool SleepUntil(Clock::time_point deadline, const CancellationToken* token = nullptr);
+
+private:
+    MacroClock* m_clock;
+    Clock::time_point m_deadline;
+    TimingStats* m_stats;
+    const CancellationToken* m_token;
+};
@@ -0,0 +1,239 @@
+#include "PyramidMatcher.h"
+#include "MacroManager.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Voisinage affiné autour de la position projetée depuis le niveau supérieur :
+// absorbe l'arrondi de la réduction et le flou qu'elle introduit
+const int REFINE_RADIUS = 2;
+
+// Moyenne 2x2 arrondie ; une dernière ligne ou colonne impaire est ignorée
+void Reduce(const GrayImage& source, GrayImage& target) {
+    target.Resize(source.width / 2, source.height / 2);
+    for (int y = 0; y < target.height; y++) {
+        const uint8_t* top = source.Row(2 * y);
+        const uint8_t* bottom = source.Row(2 * y + 1);
+        uint8_t* pixels = target.Row(y);
+        for (int x = 0; x < target.width; x++) {
+            pixels[x] = (uint8_t)((top[2 * x] + top[2 * x + 1] + bottom[2 * x] + bottom[2 * x + 1] + 2) >> 2);
+        }
+    }
+}
+
+void Crop(const GrayImage& source, int x, int y, int w, int h, GrayImage& target) {
+    target.Resize(w, h);
+    for (int row = 0; row < h; row++) {
+        std::copy(source.Row(y + row) + x, source.Row(y + row) + x + w, target.Row(row));
+    }
+}
+
+// Corrélation normalisée centrée de deux images de même taille (0 si l'une est uniforme)
+double Correlation(const GrayImage& a, const GrayImage& b) {
+    const double n = (double)a.pixels.size();
+    double sumA = 0, sumB = 0, sumAA = 0, sumBB = 0, sumAB = 0;
+    for (size_t i = 0; i < a.pixels.size(); i++) {
+        const double va = a.pixels[i], vb = b.pixels[i];
+        sumA += va;
+        sumB += vb;
+        sumAA += va * va;
+        sumBB += vb * vb;
+        sumAB += va * vb;
+    }
+    const double varianceA = sumAA - sumA * sumA / n;
+    const double varianceB = sumBB - sumB * sumB / n;
+    if (varianceA <= 0 || varianceB <= 0) return 0;
+    return (sumAB - sumA * sumB / n) / std::sqrt(varianceA * varianceB);
+}
+
+// Score attendu au niveau level pour un objet identique au modèle, dans le pire
+// placement : décalé d'une demi-cellule de la grille de réduction. Les détails
+// plus fins que la cellule s'y mélangent (repliement) et le score chute.
+double Robustness(const GrayImage& image, const GrayImage& reduced, int level) {
+    static const int SHIFTS[3][2] = { { 1, 0 }, { 0, 1 }, { 1, 1 } };
+    const int shift = (1 << level) / 2;
+    double worst = 1;
+    GrayImage shifted, coarse, aligned;
+    for (const auto& s : SHIFTS) {
+        Crop(image, s[0] * shift, s[1] * shift, image.width - s[0] * shift, image.height - s[1] * shift, shifted);
+        for (int k = 0; k < level; k++) {
+            Reduce(shifted, coarse);
+            std::swap(shifted, coarse);
+        }
+        if (shifted.IsEmpty()) return 0;
+        Crop(reduced, 0, 0, shifted.width, shifted.height, aligned);
+        worst = std::min(worst, Correlation(shifted, aligned));
+    }
+    return worst;
+}
+
+void AddStats(MatchResult& total, const MatchResult& part) {
+    total.positions += part.positions;
+    total.completed += part.completed;
+}
+
+} // namespace
+
+// ============= MatchPyramid =============
+
+const int MatchPyramid::MAX_LEVELS;
+
+MatchPyramid::MatchPyramid()
+    : m_levels(0)
+{
+}
+
+void MatchPyramid::Prepare(const GrayImage& image, int levels, bool fullTables) {
+    m_levels = 0;
+    if (image.IsEmpty()) return;
+
+    m_frames[0].Prepare(image, fullTables);
+    m_levels = 1;
+    const GrayImage* previous = &image;
+    while (m_levels < std::min(levels, MAX_LEVELS) && previous->width >= 2 && previous->height >= 2) {
+        Reduce(*previous, m_reduced[m_levels]);
+        m_frames[m_levels].Prepare(m_reduced[m_levels]);
+        previous = &m_reduced[m_levels];
+        m_levels++;
+    }
+}
+
+// ============= PyramidSettings =============
+
+PyramidSettings PyramidSettings::For(ImageSearchMode mode) {
+    switch (mode) {
+        case ImageSearchMode::Exact:
+            return PyramidSettings{ 1, 0, 1, 0.0f, 0.0f };
+        case ImageSearchMode::Fast:
+            return PyramidSettings{ 4, 4, 8, 0.1f, 0.35f };
+        default:
+            return PyramidSettings{ 4, 6, 16, 0.1f, 0.5f };
+    }
+}
+
+// ============= PyramidMatcher =============
+
+PyramidMatcher::PyramidMatcher()
+    : m_settings(PyramidSettings::For(ImageSearchMode::Balanced))
+    , m_levels(0)
+{
+}
+
+bool PyramidMatcher::SetTemplate(const GrayImage& image, const PyramidSettings& settings) {
+    m_levels = 0;
+    m_settings = settings;
+    if (!m_matchers[0].SetTemplate(image)) return false;
+    m_robustness[0] = 1;
+    m_levels = 1;
+
+    GrayImage reduced[2];
+    const GrayImage* previous = &image;
+    const int maxLevels = std::min(settings.levels, MatchPyramid::MAX_LEVELS);
+    while (m_levels < maxLevels && std::min(previous->width, previous->height) / 2 >= settings.minSide) {
+        GrayImage& current = reduced[m_levels % 2];
+        Reduce(*previous, current);
+        if (!m_matchers[m_levels].SetTemplate(current)) break;
+        m_robustness[m_levels] = (float)Robustness(image, current, m_levels);
+        previous = &current;
+        m_levels++;
+    }
+    return true;
+}
+
+size_t PyramidMatcher::MemoryBytes() const {
+    size_t bytes = sizeof(*this);
+    for (const TemplateMatcher& matcher : m_matchers) bytes += matcher.MemoryBytes() - sizeof(matcher);
+    return bytes;
+}
+
+bool PyramidMatcher::SetKernel(TemplateMatcher::Kernel kernel) {
+    if (!TemplateMatcher::IsSupported(kernel)) return false;
+    for (TemplateMatcher& matcher : m_matchers) matcher.SetKernel(kernel);
+    return true;
+}
+
+float PyramidMatcher::LevelScore(float minScore, int level) const {
+    if (level == 0) return minScore;
+    return m_robustness[level] * minScore - m_settings.levelMargin;
+}
+
+int PyramidMatcher::CoarsestLevel(float minScore, int available) const {
+    int coarsest = std::min(m_levels, available) - 1;
+    while (coarsest > 0 && LevelScore(minScore, coarsest) < m_settings.minCoarseScore) coarsest--;
+    return coarsest;
+}
+
+bool PyramidMatcher::ScansFullResolution(float minScore) const {
+    return HasTemplate() && CoarsestLevel(minScore, m_levels) == 0;
+}
+
+MatchResult PyramidMatcher::FindBest(const MatchPyramid& pyramid, float minScore) const {
+    if (pyramid.Levels() == 0) return MatchResult{};
+    const MatchFrame& full = pyramid.Level(0);
+    return FindBestIn(pyramid, MatchRect{ 0, 0, full.Width(), full.Height() }, minScore);
+}
+
+MatchResult PyramidMatcher::FindBestIn(const MatchPyramid& pyramid, MatchRect region, float minScore) const {
+    MatchResult result = {};
+    if (!HasTemplate() || pyramid.Levels() == 0) return result;
+
+    const int coarsest = CoarsestLevel(minScore, pyramid.Levels());
+    if (coarsest == 0) return m_matchers[0].FindBestIn(pyramid.Level(0), region, minScore);
+
+    // Positions réduites dont l'affinage peut atteindre region, plus une de marge
+    const int x0 = std::max(region.x, 0);
+    const int y0 = std::max(region.y, 0);
+    const int x1 = region.x + region.width;
+    const int y1 = region.y + region.height;
+    if (x1 <= x0 || y1 <= y0) return result;
+    const int first = (x0 >> coarsest) - 1;
+    const int top = (y0 >> coarsest) - 1;
+    const MatchRect scaled = { first, top,
+                               ((x1 + (1 << coarsest) - 1) >> coarsest) + 1 - first,
+                               ((y1 + (1 << coarsest) - 1) >> coarsest) + 1 - top };
+
+    const MatchFrame& coarse = pyramid.Level(coarsest);
+    std::vector<MatchCandidate> candidates;
+    AddStats(result, m_matchers[coarsest].FindCandidates(coarse, scaled, LevelScore(minScore, coarsest),
+                                                         m_settings.candidates, candidates));
+
+    std::vector<MatchCandidate> refined;
+    for (int level = coarsest - 1; level >= 0 && !candidates.empty(); level--) {
+        const MatchFrame& frame = pyramid.Level(level);
+        const float levelScore = std::max(0.0f, LevelScore(minScore, level));
+        refined.clear();
+        for (const MatchCandidate& candidate : candidates) {
+            MatchRect around = { 2 * candidate.x - REFINE_RADIUS, 2 * candidate.y - REFINE_RADIUS,
+                                 2 * REFINE_RADIUS + 2, 2 * REFINE_RADIUS + 2 };
+            MatchResult best = m_matchers[level].FindBestIn(frame, around, levelScore);
+            AddStats(result, best);
+            if (!best.found) continue;
+
+            // Deux candidats voisins convergent souvent vers la même position
+            bool known = false;
+            for (const MatchCandidate& other : refined) {
+                if (other.x == best.x && other.y == best.y) {
+                    known = true;
+                    break;
+                }
+            }
+            if (!known) refined.push_back(MatchCandidate{ best.x, best.y, best.score });
+        }
+        candidates.swap(refined);
+    }
+
+    // À score égal, la première position dans l'ordre de lecture, comme la recherche exhaustive
+    for (const MatchCandidate& candidate : candidates) {
+        bool better = !result.found || candidate.score > result.score ||
+                      (candidate.score == result.score &&
+                       (candidate.y < result.y || (candidate.y == result.y && candidate.x < result.x)));
+        if (better) {
+            result.found = true;
+            result.x = candidate.x;
+            result.y = candidate.y;
+            result.score = candidate.score;
+        }
+    }
+    return result;
+}
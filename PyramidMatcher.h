@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include "GrayImage.h"
+#include "TemplateMatcher.h"
+
+enum class ImageSearchMode : uint8_t;
+
+// Pyramide d'une image capturée : le niveau 0 est l'image elle-même, le niveau k
+// sa réduction par moyenne 2x2 du niveau k - 1. Chaque niveau est préparé pour
+// la recherche ; construite une fois par capture, partagée par tous les modèles.
+class MatchPyramid {
+public:
+    static const int MAX_LEVELS = 4;    // Jusqu'au huitième de la résolution
+
+    MatchPyramid();
+    MatchPyramid(const MatchPyramid&) = delete;
+    MatchPyramid& operator=(const MatchPyramid&) = delete;
+
+    // Niveaux 0 à levels - 1 (moins si l'image devient trop petite).
+    // L'image doit rester valide et inchangée tant que la pyramide sert.
+    // fullTables = false : niveau 0 sans tables de sommes (voir MatchFrame), quand
+    // aucun modèle n'y est cherché partout (PyramidMatcher::ScansFullResolution).
+    void Prepare(const GrayImage& image, int levels, bool fullTables = true);
+
+    int Levels() const { return m_levels; }
+    const MatchFrame& Level(int level) const { return m_frames[level]; }
+
+private:
+    GrayImage m_reduced[MAX_LEVELS];    // [0] inutilisé : le niveau 0 est l'image d'origine
+    MatchFrame m_frames[MAX_LEVELS];
+    int m_levels;
+};
+
+// Réglage précision/vitesse d'une recherche pyramidale
+struct PyramidSettings {
+    int levels;             // Niveaux utilisés au plus (1 = recherche exhaustive)
+    int minSide;            // Côté minimal du modèle au niveau le plus grossier
+    size_t candidates;      // Candidats gardés au niveau le plus grossier
+    float levelMargin;      // Marge sous le score attendu aux niveaux réduits
+    float minCoarseScore;   // Seuil le plus bas admis au niveau grossier (sinon niveau moins réduit)
+
+    static PyramidSettings For(ImageSearchMode mode);
+};
+
+// Recherche du grossier au fin : toutes les positions sont examinées au niveau le
+// plus réduit, où elles sont 4^k fois moins nombreuses et chacune 4^k fois moins
+// coûteuse ; les meilleurs candidats sont ensuite affinés niveau par niveau dans
+// un voisinage de quelques pixels, jusqu'à la pleine résolution.
+// Un modèle aux détails fins perd son score en réduction, selon son placement sur
+// la grille : SetTemplate mesure ce score dans le pire placement pour chaque
+// niveau, et la recherche ne descend pas là où un objet présent serait manqué.
+// Le score rendu est celui de la pleine résolution, comme TemplateMatcher ; seul
+// un objet dont le score réduit tombe sous le seuil abaissé peut être manqué.
+class PyramidMatcher {
+public:
+    PyramidMatcher();
+
+    // Le nombre de niveaux retenu dépend de la taille et du contenu du modèle :
+    // un niveau dont le modèle serait trop petit ou uniforme n'est pas utilisé
+    bool SetTemplate(const GrayImage& image, const PyramidSettings& settings);
+
+    bool HasTemplate() const { return m_levels > 0; }
+    int Levels() const { return m_levels; }
+
+    // La recherche au seuil minScore examine toutes les positions de la pleine
+    // résolution (modèle sans niveau réduit fiable) : tables du niveau 0 requises
+    bool ScansFullResolution(float minScore) const;
+
+    // Mémoire occupée, tous niveaux compris
+    size_t MemoryBytes() const;
+
+    bool SetKernel(TemplateMatcher::Kernel kernel);
+
+    // Même contrat que TemplateMatcher::FindBest ; positions et completed
+    // cumulent tous les niveaux
+    MatchResult FindBest(const MatchPyramid& pyramid, float minScore) const;
+
+    // Idem, limité aux positions de region (pleine résolution) ; un objet à cheval
+    // sur le bord peut être rendu juste à l'extérieur, affiné depuis l'intérieur
+    MatchResult FindBestIn(const MatchPyramid& pyramid, MatchRect region, float minScore) const;
+
+private:
+    float LevelScore(float minScore, int level) const;
+
+    // Niveau le plus réduit où un objet présent passerait encore le seuil abaissé
+    int CoarsestLevel(float minScore, int available) const;
+
+    PyramidSettings m_settings;
+    int m_levels;
+    TemplateMatcher m_matchers[MatchPyramid::MAX_LEVELS];
+    float m_robustness[MatchPyramid::MAX_LEVELS];   // Score attendu par niveau (voir SetTemplate)
+};
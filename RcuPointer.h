@@ -0,0 +1,112 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Publication d'une valeur immuable, à la manière de RCU (read-copy-update).
+// L'écrivain construit une nouvelle valeur à part puis la publie d'un coup ;
+// les lecteurs prennent la valeur courante sans verrou ni attente (deux
+// opérations atomiques par section de lecture) et la voient entière.
+// L'ancienne valeur n'est libérée qu'après la fin des sections de lecture qui
+// ont pu la voir (période de grâce, attendue par Publish). Un lecteur qui doit
+// la garder plus longtemps en prend une référence avec Share().
+template <typename T>
+class RcuPointer {
+    struct Node {
+        std::shared_ptr<const T> value;
+    };
+
+public:
+    RcuPointer()
+        : m_current(new Node())
+        , m_phase(0)
+    {
+        m_readers[0].count.store(0, std::memory_order_relaxed);
+        m_readers[1].count.store(0, std::memory_order_relaxed);
+    }
+
+    ~RcuPointer() {
+        delete m_current.load();
+    }
+
+    RcuPointer(const RcuPointer&) = delete;
+    RcuPointer& operator=(const RcuPointer&) = delete;
+
+    // Section de lecture : la valeur lue reste valide jusqu'à la destruction du garde.
+    // Ne bloque pas, n'alloue pas ; utilisable depuis n'importe quel thread.
+    class ReadGuard {
+    public:
+        explicit ReadGuard(const RcuPointer& cell)
+            : m_counter(&cell.m_readers[cell.m_phase.load(std::memory_order_acquire) & 1].count)
+        {
+            m_counter->fetch_add(1, std::memory_order_seq_cst);
+            m_node = cell.m_current.load(std::memory_order_seq_cst);
+        }
+
+        ~ReadGuard() {
+            m_counter->fetch_sub(1, std::memory_order_release);
+        }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        const T* Get() const { return m_node->value.get(); }
+        const T* operator->() const { return m_node->value.get(); }
+
+        // Référence pour garder la valeur au-delà de la section de lecture
+        const std::shared_ptr<const T>& Share() const { return m_node->value; }
+
+    private:
+        std::atomic<uint32_t>* m_counter;
+        const Node* m_node;
+    };
+
+    // Remplacer la valeur (écrivains sérialisés entre eux). Attend la fin des
+    // lectures de l'ancienne valeur ; les lecteurs, eux, ne sont jamais bloqués.
+    void Publish(std::shared_ptr<const T> value) {
+        Node* node = new Node();
+        node->value = std::move(value);
+
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        Node* old = m_current.exchange(node, std::memory_order_seq_cst);
+        Synchronize();
+        delete old; // Libère la valeur si aucun lecteur ne l'a partagée
+    }
+
+    // Valeur courante, côté écrivain
+    std::shared_ptr<const T> Load() const {
+        ReadGuard guard(*this);
+        return guard.Share();
+    }
+
+private:
+    struct alignas(64) Counter {
+        std::atomic<uint32_t> count;
+    };
+
+    // Période de grâce : les nouveaux lecteurs sont dirigés vers l'autre
+    // compteur, puis chaque compteur est attendu à zéro. Un lecteur qui tient
+    // l'ancienne valeur a incrémenté l'un d'eux avant l'échange de pointeur :
+    // il est forcément attendu. Les lecteurs continus ne peuvent pas affamer
+    // l'écrivain, puisque le compteur attendu ne reçoit plus d'entrées.
+    void Synchronize() {
+        uint32_t phase = m_phase.load(std::memory_order_relaxed);
+        m_phase.store(phase ^ 1, std::memory_order_seq_cst);
+        WaitForReaders(phase & 1);
+        m_phase.store(phase, std::memory_order_seq_cst);
+        WaitForReaders((phase ^ 1) & 1);
+    }
+
+    void WaitForReaders(uint32_t index) {
+        while (m_readers[index].count.load(std::memory_order_seq_cst) != 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    std::atomic<Node*> m_current;
+    std::atomic<uint32_t> m_phase;
+    mutable Counter m_readers[2];
+    std::mutex m_writeMutex;
+};
@@ -0,0 +1,32 @@
+#include "RecordingInputSink.h"
+
+RecordingInputSink::RecordingInputSink(MacroClock* clock)
+    : m_clock(clock ? *clock : MacroClock::System())
+{
+}
+
+void RecordingInputSink::Submit(const InputEvent* events, size_t count) {
+    Batch batch;
+    batch.time = m_clock.Now();
+    batch.events.assign(events, events + count);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_batches.push_back(std::move(batch));
+}
+
+std::vector<RecordingInputSink::Batch> RecordingInputSink::GetBatches() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_batches;
+}
+
+size_t RecordingInputSink::EventCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t count = 0;
+    for (const auto& batch : m_batches) count += batch.events.size();
+    return count;
+}
+
+void RecordingInputSink::Clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_batches.clear();
+}
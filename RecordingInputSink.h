@@ -0,0 +1,32 @@
+#pragma once
+#include "InputSink.h"
+#include "MacroClock.h"
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+// Sink sans effet qui enregistre chaque lot reçu, avec son horodatage.
+// Sert à vérifier le regroupement et l'ordre des événements hors Windows.
+// Avec l'horloge de simulation de l'exécuteur, la chronologie est exacte.
+class RecordingInputSink : public InputSink {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    explicit RecordingInputSink(MacroClock* clock = nullptr);
+
+    struct Batch {
+        Clock::time_point time;
+        std::vector<InputEvent> events;
+    };
+
+    void Submit(const InputEvent* events, size_t count) override;
+
+    std::vector<Batch> GetBatches() const;
+    size_t EventCount() const;
+    void Clear();
+
+private:
+    MacroClock& m_clock;
+    mutable std::mutex m_mutex;
+    std::vector<Batch> m_batches;
+};
@@ -0,0 +1,51 @@
+#include "Semaphore.h"
+#include <cerrno>
+
+#ifdef _WIN32
+
+Semaphore::Semaphore() {
+    m_handle = CreateSemaphoreW(nullptr, 0, 0x7FFFFFFF, nullptr);
+}
+
+Semaphore::~Semaphore() {
+    if (m_handle) CloseHandle(m_handle);
+}
+
+void Semaphore::Post() {
+    ReleaseSemaphore(m_handle, 1, nullptr);
+}
+
+void Semaphore::Wait() {
+    WaitForSingleObject(m_handle, INFINITE);
+}
+
+bool Semaphore::TryWait() {
+    return WaitForSingleObject(m_handle, 0) == WAIT_OBJECT_0;
+}
+
+#else
+
+Semaphore::Semaphore() {
+    sem_init(&m_sem, 0, 0);
+}
+
+Semaphore::~Semaphore() {
+    sem_destroy(&m_sem);
+}
+
+void Semaphore::Post() {
+    sem_post(&m_sem);
+}
+
+void Semaphore::Wait() {
+    // Recommencer si interrompu par un signal
+    while (sem_wait(&m_sem) != 0 && errno == EINTR) {}
+}
+
+bool Semaphore::TryWait() {
+    int result;
+    while ((result = sem_trywait(&m_sem)) != 0 && errno == EINTR) {}
+    return result == 0;
+}
+
+#endif
@@ -0,0 +1,29 @@
+#pragma once
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <semaphore.h>
+#endif
+
+// Sémaphore compteur du système : Post() ne bloque jamais et ne prend aucun verrou
+// applicatif, ce qui permet de réveiller un consommateur depuis un thread de hook.
+class Semaphore {
+public:
+    Semaphore();
+    ~Semaphore();
+
+    Semaphore(const Semaphore&) = delete;
+    Semaphore& operator=(const Semaphore&) = delete;
+
+    void Post();
+    void Wait();
+    bool TryWait();     // Sans attendre : false si le compteur est à zéro
+
+private:
+#ifdef _WIN32
+    HANDLE m_handle;
+#else
+    sem_t m_sem;
+#endif
+};
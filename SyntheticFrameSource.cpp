@@ -0,0 +1,120 @@
+#include "SyntheticFrameSource.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+void FillRect(GrayImage& image, int x, int y, int w, int h, uint8_t value) {
+    for (int row = y; row < y + h; row++) {
+        uint8_t* pixels = image.Row(row);
+        for (int col = x; col < x + w; col++) pixels[col] = value;
+    }
+}
+
+// Glyphes 6x9 en pixels sombres
+void DrawText(GrayImage& image, SyntheticFrameSource::Random& random, int x, int y, int glyphs) {
+    for (int g = 0; g < glyphs; g++) {
+        for (int gy = 0; gy < 9; gy++) {
+            for (int gx = 0; gx < 6; gx++) {
+                if (random.Below(3) == 0) image.Row(y + gy)[x + g * 7 + gx] = (uint8_t)(20 + random.Below(30));
+            }
+        }
+    }
+}
+
+} // namespace
+
+SyntheticFrameSource::SyntheticFrameSource(int width, int height, uint32_t seed)
+    : m_width(width)
+    , m_height(height)
+    , m_random(seed)
+{
+    Generate(m_screen, m_targets, m_random, m_width, m_height);
+}
+
+bool SyntheticFrameSource::Capture(GrayImage& frame) {
+    frame.Resize(m_screen.width, m_screen.height);
+    std::copy(m_screen.pixels.begin(), m_screen.pixels.end(), frame.pixels.begin());
+    return true;
+}
+
+void SyntheticFrameSource::Next() {
+    Generate(m_screen, m_targets, m_random, m_width, m_height);
+}
+
+void SyntheticFrameSource::Animate(int regions) {
+    for (int i = 0; i < regions; i++) {
+        const int glyphs = 4 + m_random.Below(8);
+        const int x = m_random.Below(m_width - glyphs * 7 - 4);
+        const int y = m_random.Below(m_height - 13);
+        FillRect(m_screen, x, y, glyphs * 7 + 4, 13, (uint8_t)(150 + m_random.Below(100)));
+        DrawText(m_screen, m_random, x + 2, y + 2, glyphs);
+    }
+}
+
+void SyntheticFrameSource::HideTarget(size_t index) {
+    if (index >= m_targets.size()) return;
+    const Target& target = m_targets[index];
+    FillRect(m_screen, target.x, target.y, target.pattern.width, target.pattern.height, 200);
+}
+
+void SyntheticFrameSource::ShowTarget(size_t index) {
+    if (index >= m_targets.size()) return;
+    Target& target = m_targets[index];
+    const int w = target.pattern.width, h = target.pattern.height;
+    target.x = 100 + m_random.Below(m_width - 200 - w);
+    target.y = 100 + m_random.Below(m_height - 200 - h);
+    for (int y = 0; y < h; y++) {
+        const uint8_t* pixels = target.pattern.Row(y);
+        std::copy(pixels, pixels + w, m_screen.Row(target.y + y) + target.x);
+    }
+}
+
+void SyntheticFrameSource::Generate(GrayImage& screen, std::vector<Target>& targets, Random& random,
+                                   int width, int height) {
+    const int density = std::max(1, (width / 1920) * (height / 1080));
+    screen.Resize(width, height);
+    for (int y = 0; y < height; y++) FillRect(screen, 0, y, width, 1, (uint8_t)(40 + y * 60 / height));
+
+    for (int i = 0; i < 60 * density; i++) {
+        int w = 200 + random.Below(700), h = 120 + random.Below(500);
+        int x = random.Below(width - w), y = random.Below(height - h);
+        FillRect(screen, x, y, w, h, (uint8_t)(150 + random.Below(100)));
+        FillRect(screen, x, y, w, 24, (uint8_t)(60 + random.Below(60)));        // Barre de titre
+        for (int b = 0; b < 4; b++) {
+            FillRect(screen, x + 10 + b * 48, y + h - 34, 40, 24, (uint8_t)(90 + random.Below(120)));
+        }
+    }
+
+    for (int line = 0; line < 300 * density; line++) {
+        int x = random.Below(width - 400), y = random.Below(height - 12);
+        DrawText(screen, random, x, y, 10 + random.Below(50));
+    }
+
+    static const int SIZES[][2] = { { 24, 24 }, { 32, 32 }, { 48, 48 }, { 64, 40 } };
+    targets.clear();
+    for (int i = 0; i < 4; i++) {
+        Target target;
+        const int w = SIZES[i][0], h = SIZES[i][1];
+        target.x = 100 + random.Below(width - 200 - w);
+        target.y = 100 + random.Below(height - 200 - h);
+        for (int y = 0; y < h; y++) {
+            uint8_t* pixels = screen.Row(target.y + y) + target.x;
+            for (int x = 0; x < w; x++) {
+                double value = 128 + 90 * std::sin(x * (0.2 + 0.05 * i)) * std::cos(y * (0.15 + 0.07 * i));
+                pixels[x] = (uint8_t)(value + random.Below(24));
+            }
+        }
+        target.pattern.Resize(w, h);
+        for (int y = 0; y < h; y++) {
+            const uint8_t* pixels = screen.Row(target.y + y) + target.x;
+            std::copy(pixels, pixels + w, target.pattern.Row(y));
+        }
+        targets.push_back(target);
+    }
+
+    for (uint8_t& pixel : screen.pixels) {
+        int value = pixel + 6 + random.Below(5) - 2;
+        pixel = (uint8_t)(value < 0 ? 0 : (value > 255 ? 255 : value));
+    }
+}
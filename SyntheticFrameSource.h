@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "FrameSource.h"
+
+// Écran synthétique reproductible, pour les mesures et les essais hors bureau :
+// fond en dégradé, fenêtres et boutons unis, lignes de texte, et des icônes
+// texturées (les modèles) à des positions connues. Les modèles sont découpés
+// avant un léger bruit et un décalage de luminosité appliqués à l'écran, comme
+// entre deux rendus d'une même interface.
+class SyntheticFrameSource : public FrameSource {
+public:
+    // Générateur reproductible (xorshift32) : mêmes images d'une exécution à l'autre
+    class Random {
+    public:
+        explicit Random(uint32_t seed) : m_state(seed ? seed : 1) {}
+
+        uint32_t Next() {
+            m_state ^= m_state << 13;
+            m_state ^= m_state >> 17;
+            m_state ^= m_state << 5;
+            return m_state;
+        }
+
+        int Below(int n) { return (int)(Next() % (uint32_t)n); }
+
+    private:
+        uint32_t m_state;
+    };
+
+    // Modèle découpé dans l'écran, à une position connue
+    struct Target {
+        int x;
+        int y;
+        GrayImage pattern;
+    };
+
+    SyntheticFrameSource(int width = 1920, int height = 1080, uint32_t seed = 2024);
+
+    // Copie de l'écran courant
+    bool Capture(GrayImage& frame) override;
+
+    // Écran suivant, tiré du même générateur
+    void Next();
+
+    // Écran presque immobile : quelques petites zones de texte redessinées
+    // (horloge, saisie, compteurs), le reste de l'écran inchangé
+    void Animate(int regions);
+
+    // Icône effacée (zone unie), puis redessinée à une nouvelle position
+    void HideTarget(size_t index);
+    void ShowTarget(size_t index);
+
+    const GrayImage& Screen() const { return m_screen; }
+    const std::vector<Target>& Targets() const { return m_targets; }
+    Random& Generator() { return m_random; }
+
+    // Quatre icônes de 24x24 à 64x40 ; densité de fenêtres et de texte
+    // proportionnelle à la surface (1080p de référence)
+    static void Generate(GrayImage& screen, std::vector<Target>& targets, Random& random,
+                         int width = 1920, int height = 1080);
+
+private:
+    int m_width;
+    int m_height;
+    Random m_random;
+    GrayImage m_screen;
+    std::vector<Target> m_targets;
+};
@@ -0,0 +1,111 @@
+#include "TemplateCache.h"
+#include "ImageFile.h"
+#include "MacroManager.h"
+#include "MappedFile.h"
+#include <iterator>
+
+const size_t TemplateCache::DefaultBudget;
+
+TemplateCache::TemplateCache(size_t budget)
+    : m_budget(budget)
+    , m_residentBytes(0)
+    , m_stats()
+{
+}
+
+std::shared_ptr<const CachedTemplate> TemplateCache::Get(const std::wstring& path, ImageSearchMode mode) {
+    uint64_t fileSize = 0, writeTime = 0;
+    const bool exists = !path.empty() && MappedFile::Stat(path, fileSize, writeTime);
+    const Key key(path, mode);
+
+    bool stale = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.lookups++;
+        auto found = m_index.find(key);
+        if (found != m_index.end()) {
+            const CachedTemplate& cached = *found->second->second;
+            if (exists && cached.fileSize == fileSize && cached.writeTime == writeTime) {
+                m_stats.hits++;
+                m_entries.splice(m_entries.begin(), m_entries, found->second);
+                return found->second->second;
+            }
+            // Fichier modifié ou supprimé : le modèle décodé ne vaut plus
+            stale = true;
+            Erase(found->second);
+        }
+        if (!exists) {
+            m_stats.failures++;
+            return nullptr;
+        }
+    }
+
+    // Décodage hors verrou : deux threads peuvent charger le même modèle, le dernier reste
+    std::shared_ptr<const CachedTemplate> loaded = Load(path, mode, fileSize, writeTime);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.loads++;
+    if (stale) m_stats.reloads++;
+    if (!loaded) {
+        m_stats.failures++;
+        return nullptr;
+    }
+
+    auto found = m_index.find(key);
+    if (found != m_index.end()) Erase(found->second);
+    if (loaded->bytes <= m_budget) {
+        m_entries.emplace_front(key, loaded);
+        m_index[key] = m_entries.begin();
+        m_residentBytes += loaded->bytes;
+        Trim();
+    }
+    return loaded;
+}
+
+std::shared_ptr<const CachedTemplate> TemplateCache::Load(const std::wstring& path, ImageSearchMode mode,
+                                                          uint64_t fileSize, uint64_t writeTime) {
+    std::shared_ptr<CachedTemplate> loaded = std::make_shared<CachedTemplate>();
+    if (!ImageFile::LoadGray(path, loaded->image) ||
+        !loaded->matcher.SetTemplate(loaded->image, PyramidSettings::For(mode))) return nullptr;
+
+    loaded->fileSize = fileSize;
+    loaded->writeTime = writeTime;
+    loaded->bytes = sizeof(CachedTemplate) - sizeof(PyramidMatcher) + loaded->image.pixels.capacity() +
+                    loaded->matcher.MemoryBytes() + path.capacity() * sizeof(wchar_t);
+    return loaded;
+}
+
+void TemplateCache::SetBudget(size_t budget) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_budget = budget;
+    Trim();
+}
+
+void TemplateCache::Clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_index.clear();
+    m_residentBytes = 0;
+}
+
+TemplateCache::Stats TemplateCache::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats = m_stats;
+    stats.entries = m_entries.size();
+    stats.residentBytes = m_residentBytes;
+    stats.budget = m_budget;
+    return stats;
+}
+
+void TemplateCache::Erase(std::list<Entry>::iterator entry) {
+    m_residentBytes -= entry->second->bytes;
+    m_index.erase(entry->first);
+    m_entries.erase(entry);
+}
+
+void TemplateCache::Trim() {
+    while (m_residentBytes > m_budget && !m_entries.empty()) {
+        Erase(std::prev(m_entries.end()));
+        m_stats.evictions++;
+    }
+}
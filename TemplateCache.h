@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include "GrayImage.h"
+#include "PyramidMatcher.h"
+
+// Modèle d'une macro image prêt pour la recherche : image décodée et matcher
+// préparé (poids centrés, normes, tables de la borne, niveaux de la pyramide).
+// Immuable une fois en cache, partagé entre les exécutions.
+struct CachedTemplate {
+    GrayImage image;
+    PyramidMatcher matcher;
+
+    uint64_t fileSize;      // Identité du fichier décodé (MappedFile::Stat)
+    uint64_t writeTime;
+    size_t bytes;           // Mémoire occupée, pour le budget
+};
+
+// Cache des modèles, par chemin et mode de recherche (les niveaux de la
+// pyramide en dépendent). Chargement au premier usage ; chaque accès compare
+// taille et date du fichier à celles du modèle décodé, et recharge s'il a
+// changé. Au-delà du budget mémoire, les modèles les moins récemment utilisés
+// sont oubliés (ceux en cours d'usage restent valides jusqu'à leur libération).
+// Utilisable depuis plusieurs threads ; le décodage a lieu hors verrou.
+class TemplateCache {
+public:
+    static const size_t DefaultBudget = 64 * 1024 * 1024;
+
+    struct Stats {
+        uint64_t lookups;       // Appels à Get()
+        uint64_t hits;          // Servis sans décodage
+        uint64_t loads;         // Décodages (premiers chargements et rechargements)
+        uint64_t reloads;       // Dont : fichier modifié depuis le décodage précédent
+        uint64_t failures;      // Fichier absent, illisible ou modèle inutilisable
+        uint64_t evictions;     // Modèles oubliés pour tenir le budget
+        size_t entries;
+        size_t residentBytes;
+        size_t budget;
+    };
+
+    explicit TemplateCache(size_t budget = DefaultBudget);
+
+    TemplateCache(const TemplateCache&) = delete;
+    TemplateCache& operator=(const TemplateCache&) = delete;
+
+    // Modèle à jour pour path ; nullptr si le fichier est illisible ou le modèle uniforme
+    std::shared_ptr<const CachedTemplate> Get(const std::wstring& path, ImageSearchMode mode);
+
+    // Un modèle plus gros que le budget est rendu mais pas gardé
+    void SetBudget(size_t budget);
+    void Clear();
+
+    Stats GetStats() const;
+
+private:
+    typedef std::pair<std::wstring, ImageSearchMode> Key;
+    typedef std::pair<Key, std::shared_ptr<const CachedTemplate>> Entry;
+
+    static std::shared_ptr<const CachedTemplate> Load(const std::wstring& path, ImageSearchMode mode,
+                                                      uint64_t fileSize, uint64_t writeTime);
+
+    // Retirer une entrée / les plus anciennes jusqu'au budget (verrou tenu)
+    void Erase(std::list<Entry>::iterator entry);
+    void Trim();
+
+    mutable std::mutex m_mutex;
+    std::list<Entry> m_entries;                             // Plus récemment utilisé en tête
+    std::map<Key, std::list<Entry>::iterator> m_index;
+    size_t m_budget;
+    size_t m_residentBytes;
+    Stats m_stats;
+};
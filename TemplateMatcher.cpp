@@ -0,0 +1,576 @@
+#include "TemplateMatcher.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MATCHER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Côté maximal d'un modèle : les sommes d'un rectangle tiennent sur 32 bits
+const int MAX_TEMPLATE_SIDE = 2048;
+
+// Produits par appel du noyau : |poids x pixel| <= 510 x 255, le cumul tient sur 32 bits
+const int MAX_BLOCK_TAPS = 16384;
+
+// Zone uniforme : variance inférieure à 1/4 de niveau de gris au carré
+const double FLAT_VARIANCE = 0.25;
+
+// Modèles corrélés par blocs de positions, sans borne (pixels ; noyaux vectoriels
+// seulement : en scalaire la borne reste plus rentable)
+const int DENSE_MAX_TAPS = 1024;
+
+int32_t DotScalar(const uint8_t* frame, size_t frameStride, const int16_t* weights, int width, int rows) {
+    int32_t sum = 0;
+    for (int r = 0; r < rows; r++) {
+        for (int i = 0; i < width; i++) sum += frame[i] * weights[i];
+        frame += frameStride;
+        weights += width;
+    }
+    return sum;
+}
+
+// Produits de positions consécutives : dots[j] pour le modèle placé en frame + j.
+// Poids en lignes de largeur paire (colonne nulle ajoutée si besoin).
+void RowDotScalar(const uint8_t* frame, size_t frameStride, const int16_t* weights, int width, int rows,
+                  int first, int count, int32_t* dots) {
+    const int evenWidth = width + (width & 1);
+    for (int j = first; j < count; j++) {
+        int32_t sum = 0;
+        const uint8_t* row = frame + j;
+        const int16_t* w = weights;
+        for (int r = 0; r < rows; r++) {
+            for (int i = 0; i < width; i++) sum += row[i] * w[i];
+            row += frameStride;
+            w += evenWidth;
+        }
+        dots[j] = sum;
+    }
+}
+
+#ifdef MATCHER_X86
+
+__attribute__((target("sse2")))
+int32_t DotSse2(const uint8_t* frame, size_t frameStride, const int16_t* weights, int width, int rows) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = zero;
+    int32_t tail = 0;
+
+    for (int r = 0; r < rows; r++) {
+        int i = 0;
+        for (; i + 16 <= width; i += 16) {
+            __m128i pixels = _mm_loadu_si128((const __m128i*)(frame + i));
+            __m128i low = _mm_unpacklo_epi8(pixels, zero);
+            __m128i high = _mm_unpackhi_epi8(pixels, zero);
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(low, _mm_loadu_si128((const __m128i*)(weights + i))));
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(high, _mm_loadu_si128((const __m128i*)(weights + i + 8))));
+        }
+        for (; i + 8 <= width; i += 8) {
+            __m128i pixels = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(frame + i)), zero);
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(pixels, _mm_loadu_si128((const __m128i*)(weights + i))));
+        }
+        for (; i < width; i++) tail += frame[i] * weights[i];
+        frame += frameStride;
+        weights += width;
+    }
+
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0x4E));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0xB1));
+    return _mm_cvtsi128_si32(acc) + tail;
+}
+
+// Une colonne de poids par paire : chaque voie 32 bits est une position,
+// madd y somme pixel(c) x poids(c) + pixel(c + 1) x poids(c + 1)
+__attribute__((target("sse2")))
+void RowDotSse2(const uint8_t* frame, size_t frameStride, const int16_t* weights, int width, int rows,
+                int first, int count, int32_t* dots) {
+    const __m128i zero = _mm_setzero_si128();
+    const int evenWidth = width + (width & 1);
+    int j = first;
+    for (; j + 8 <= count; j += 8) {
+        __m128i accLow = zero, accHigh = zero;
+        const uint8_t* row = frame + j;
+        const int16_t* w = weights;
+        for (int r = 0; r < rows; r++) {
+            for (int c = 0; c < width; c += 2) {
+                __m128i a = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(row + c)), zero);
+                __m128i b = zero;
+                if (c + 1 < width) b = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(row + c + 1)), zero);
+                int32_t pair;
+                memcpy(&pair, w + c, sizeof(pair));
+                const __m128i weightPair = _mm_set1_epi32(pair);
+                accLow = _mm_add_epi32(accLow, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), weightPair));
+                accHigh = _mm_add_epi32(accHigh, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), weightPair));
+            }
+            row += frameStride;
+            w += evenWidth;
+        }
+        _mm_storeu_si128((__m128i*)(dots + j), accLow);
+        _mm_storeu_si128((__m128i*)(dots + j + 4), accHigh);
+    }
+    RowDotScalar(frame, frameStride, weights, width, rows, j, count, dots);
+}
+
+__attribute__((target("avx2")))
+int32_t DotAvx2(const uint8_t* frame, size_t frameStride, const int16_t* weights, int width, int rows) {
+    __m256i acc = _mm256_setzero_si256();
+    __m128i acc128 = _mm_setzero_si128();
+    int32_t tail = 0;
+
+    for (int r = 0; r < rows; r++) {
+        int i = 0;
+        for (; i + 32 <= width; i += 32) {
+            __m256i pixels = _mm256_loadu_si256((const __m256i*)(frame + i));
+            __m256i low = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(pixels));
+            __m256i high = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(pixels, 1));
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(low, _mm256_loadu_si256((const __m256i*)(weights + i))));
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(high, _mm256_loadu_si256((const __m256i*)(weights + i + 16))));
+        }
+        for (; i + 16 <= width; i += 16) {
+            __m256i pixels = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(frame + i)));
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(pixels, _mm256_loadu_si256((const __m256i*)(weights + i))));
+        }
+        for (; i + 8 <= width; i += 8) {
+            __m128i pixels = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i*)(frame + i)));
+            acc128 = _mm_add_epi32(acc128, _mm_madd_epi16(pixels, _mm_loadu_si128((const __m128i*)(weights + i))));
+        }
+        for (; i < width; i++) tail += frame[i] * weights[i];
+        frame += frameStride;
+        weights += width;
+    }
+
+    acc128 = _mm_add_epi32(acc128, _mm256_castsi256_si128(acc));
+    acc128 = _mm_add_epi32(acc128, _mm256_extracti128_si256(acc, 1));
+    acc128 = _mm_add_epi32(acc128, _mm_shuffle_epi32(acc128, 0x4E));
+    acc128 = _mm_add_epi32(acc128, _mm_shuffle_epi32(acc128, 0xB1));
+    return _mm_cvtsi128_si32(acc128) + tail;
+}
+
+__attribute__((target("avx2")))
+void RowDotAvx2(const uint8_t* frame, size_t frameStride, const int16_t* weights, int width, int rows,
+                int first, int count, int32_t* dots) {
+    const __m256i zero = _mm256_setzero_si256();
+    const int evenWidth = width + (width & 1);
+    int j = first;
+    for (; j + 16 <= count; j += 16) {
+        __m256i accLow = zero, accHigh = zero;
+        const uint8_t* row = frame + j;
+        const int16_t* w = weights;
+        for (int r = 0; r < rows; r++) {
+            for (int c = 0; c < width; c += 2) {
+                __m256i a = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(row + c)));
+                __m256i b = zero;
+                if (c + 1 < width) b = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(row + c + 1)));
+                int32_t pair;
+                memcpy(&pair, w + c, sizeof(pair));
+                const __m256i weightPair = _mm256_set1_epi32(pair);
+                accLow = _mm256_add_epi32(accLow, _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), weightPair));
+                accHigh = _mm256_add_epi32(accHigh, _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), weightPair));
+            }
+            row += frameStride;
+            w += evenWidth;
+        }
+        // unpack travaille par moitié de registre : accLow porte les positions 0-3 et 8-11,
+        // accHigh 4-7 et 12-15
+        _mm256_storeu_si256((__m256i*)(dots + j), _mm256_permute2x128_si256(accLow, accHigh, 0x20));
+        _mm256_storeu_si256((__m256i*)(dots + j + 8), _mm256_permute2x128_si256(accLow, accHigh, 0x31));
+    }
+    RowDotScalar(frame, frameStride, weights, width, rows, j, count, dots);
+}
+
+#endif
+
+} // namespace
+
+// ============= MatchFrame =============
+
+MatchFrame::MatchFrame()
+    : m_image(nullptr)
+    , m_tables(false)
+    , m_stride(0)
+{
+}
+
+void MatchFrame::Prepare(const GrayImage& image, bool tables) {
+    m_image = &image;
+    m_tables = tables;
+    m_stride = (size_t)image.width + 1;
+    if (!tables) return;    // Tables gardées allouées pour les images suivantes
+    m_sums.resize(m_stride * ((size_t)image.height + 1));
+    m_squares.resize(m_sums.size());
+
+    std::fill(m_sums.begin(), m_sums.begin() + m_stride, 0);
+    std::fill(m_squares.begin(), m_squares.begin() + m_stride, 0);
+
+    // Arithmétique modulo 2^32 : exacte pour tout rectangle dont la somme tient sur 32 bits
+    for (int y = 0; y < image.height; y++) {
+        const uint8_t* pixels = image.Row(y);
+        const uint32_t* sumsAbove = &m_sums[(size_t)y * m_stride];
+        const uint64_t* squaresAbove = &m_squares[(size_t)y * m_stride];
+        uint32_t* sums = &m_sums[(size_t)(y + 1) * m_stride];
+        uint64_t* squares = &m_squares[(size_t)(y + 1) * m_stride];
+
+        uint32_t rowSum = 0;
+        uint64_t rowSquares = 0;
+        sums[0] = 0;
+        squares[0] = 0;
+        for (int x = 0; x < image.width; x++) {
+            rowSum += pixels[x];
+            rowSquares += (uint32_t)pixels[x] * pixels[x];
+            sums[x + 1] = sumsAbove[x + 1] + rowSum;
+            squares[x + 1] = squaresAbove[x + 1] + rowSquares;
+        }
+    }
+}
+
+uint32_t MatchFrame::Sum(int x, int y, int w, int h) const {
+    if (!m_tables) {
+        uint32_t sum = 0;
+        for (int row = y; row < y + h; row++) {
+            const uint8_t* pixels = m_image->Row(row) + x;
+            for (int i = 0; i < w; i++) sum += pixels[i];
+        }
+        return sum;
+    }
+    const uint32_t* top = &m_sums[(size_t)y * m_stride + x];
+    const uint32_t* bottom = &m_sums[(size_t)(y + h) * m_stride + x];
+    return bottom[w] - top[w] - bottom[0] + top[0];
+}
+
+uint64_t MatchFrame::SumSquares(int x, int y, int w, int h) const {
+    if (!m_tables) {
+        uint64_t sum = 0;
+        for (int row = y; row < y + h; row++) {
+            const uint8_t* pixels = m_image->Row(row) + x;
+            uint32_t rowSum = 0;    // Au plus 2048 x 255², sur 32 bits
+            for (int i = 0; i < w; i++) rowSum += (uint32_t)pixels[i] * pixels[i];
+            sum += rowSum;
+        }
+        return sum;
+    }
+    const uint64_t* top = &m_squares[(size_t)y * m_stride + x];
+    const uint64_t* bottom = &m_squares[(size_t)(y + h) * m_stride + x];
+    return bottom[w] - top[w] - bottom[0] + top[0];
+}
+
+// ============= TemplateMatcher =============
+
+bool TemplateMatcher::IsSupported(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::Scalar:
+            return true;
+#ifdef MATCHER_X86
+        case Kernel::Sse2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse2") != 0;
+        case Kernel::Avx2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") != 0;
+#endif
+        default:
+            return false;
+    }
+}
+
+TemplateMatcher::Kernel TemplateMatcher::BestKernel() {
+    if (IsSupported(Kernel::Avx2)) return Kernel::Avx2;
+    if (IsSupported(Kernel::Sse2)) return Kernel::Sse2;
+    return Kernel::Scalar;
+}
+
+const char* TemplateMatcher::KernelName(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::Sse2: return "sse2";
+        case Kernel::Avx2: return "avx2";
+        default: return "scalar";
+    }
+}
+
+TemplateMatcher::DotFunction TemplateMatcher::DotFor(Kernel kernel) {
+    switch (kernel) {
+#ifdef MATCHER_X86
+        case Kernel::Sse2: return DotSse2;
+        case Kernel::Avx2: return DotAvx2;
+#endif
+        default: return DotScalar;
+    }
+}
+
+TemplateMatcher::RowDotFunction TemplateMatcher::RowDotFor(Kernel kernel) {
+    switch (kernel) {
+#ifdef MATCHER_X86
+        case Kernel::Sse2: return RowDotSse2;
+        case Kernel::Avx2: return RowDotAvx2;
+#endif
+        default: return RowDotScalar;
+    }
+}
+
+TemplateMatcher::TemplateMatcher()
+    : m_width(0)
+    , m_height(0)
+    , m_kernel(BestKernel())
+    , m_dot(DotFor(m_kernel))
+    , m_rowDot(RowDotFor(m_kernel))
+    , m_weightMean(0)
+    , m_centeredEnergy(0)
+    , m_blockRows(1)
+{
+}
+
+bool TemplateMatcher::SetKernel(Kernel kernel) {
+    if (!IsSupported(kernel)) return false;
+    m_kernel = kernel;
+    m_dot = DotFor(kernel);
+    m_rowDot = RowDotFor(kernel);
+    return true;
+}
+
+bool TemplateMatcher::SetTemplate(const GrayImage& image) {
+    m_width = 0;
+    m_height = 0;
+    if (image.IsEmpty() || image.width > MAX_TEMPLATE_SIDE || image.height > MAX_TEMPLATE_SIDE) return false;
+
+    const size_t n = image.pixels.size();
+    uint64_t total = 0;
+    for (uint8_t p : image.pixels) total += p;
+    const double mean = (double)total / (double)n;
+
+    // Poids entiers (demi-niveaux de gris) : les noyaux calculent sans flottants
+    m_weights.resize(n);
+    int64_t weightSum = 0;
+    double weightSquares = 0;
+    for (size_t i = 0; i < n; i++) {
+        int16_t weight = (int16_t)std::lround(2.0 * (image.pixels[i] - mean));
+        m_weights[i] = weight;
+        weightSum += weight;
+        weightSquares += (double)weight * weight;
+    }
+    m_weightMean = (double)weightSum / (double)n;
+    m_centeredEnergy = weightSquares - (double)weightSum * (double)weightSum / (double)n;
+    if (m_centeredEnergy < 4.0 * FLAT_VARIANCE * (double)n) return false;
+
+    m_restSum.assign((size_t)image.height + 1, 0);
+    m_restSquares.assign((size_t)image.height + 1, 0);
+    m_inverseRestCount.assign((size_t)image.height + 1, 0);
+    for (int k = image.height - 1; k >= 0; k--) {
+        int64_t rowSum = 0;
+        double rowSquares = 0;
+        const int16_t* row = &m_weights[(size_t)k * image.width];
+        for (int i = 0; i < image.width; i++) {
+            rowSum += row[i];
+            rowSquares += (double)row[i] * row[i];
+        }
+        m_restSum[k] = m_restSum[k + 1] + rowSum;
+        m_restSquares[k] = m_restSquares[k + 1] + rowSquares;
+        m_inverseRestCount[k] = 1.0 / ((double)(image.height - k) * image.width);
+    }
+
+    const int evenWidth = image.width + (image.width & 1);
+    m_evenWeights.assign((size_t)evenWidth * image.height, 0);
+    for (int y = 0; y < image.height; y++) {
+        std::copy(&m_weights[(size_t)y * image.width], &m_weights[(size_t)(y + 1) * image.width],
+                  &m_evenWeights[(size_t)y * evenWidth]);
+    }
+
+    m_blockRows = std::max(1, MAX_BLOCK_TAPS / image.width);
+    m_width = image.width;
+    m_height = image.height;
+    return true;
+}
+
+size_t TemplateMatcher::MemoryBytes() const {
+    return sizeof(*this) + (m_weights.capacity() + m_evenWeights.capacity()) * sizeof(int16_t) +
+           m_restSum.capacity() * sizeof(int64_t) +
+           (m_restSquares.capacity() + m_inverseRestCount.capacity()) * sizeof(double);
+}
+
+int64_t TemplateMatcher::Dot(const MatchFrame& frame, int x, int y, int first, int last) const {
+    const GrayImage& image = frame.Image();
+    if (last - first <= m_blockRows) {
+        return m_dot(image.Row(y + first) + x, (size_t)image.width, &m_weights[(size_t)first * m_width],
+                     m_width, last - first);
+    }
+    int64_t sum = 0;
+    for (int row = first; row < last; row += m_blockRows) {
+        int rows = std::min(m_blockRows, last - row);
+        sum += m_dot(image.Row(y + row) + x, (size_t)image.width,
+                     &m_weights[(size_t)row * m_width], m_width, rows);
+    }
+    return sum;
+}
+
+int TemplateMatcher::FirstCheckpoint(float minScore) const {
+    // La borne sur les lignes restantes vaut au plus la part d'énergie du modèle
+    // qu'elles portent ; marge de 0,1 pour la corrélation déjà accumulée
+    const double target = (double)minScore - 0.1;
+    if (target <= 0) return m_height;
+    for (int k = 1; k < m_height; k++) {
+        if (std::sqrt(m_restSquares[k] / m_restSquares[0]) <= target) return k;
+    }
+    return m_height;
+}
+
+MatchResult TemplateMatcher::FindBest(const MatchFrame& frame, float minScore) const {
+    MatchRect all = { 0, 0, frame.Width(), frame.Height() };
+    return FindBestIn(frame, all, minScore);
+}
+
+template <typename Accept>
+void TemplateMatcher::Scan(const MatchFrame& frame, MatchRect region, float minScore, MatchResult& stats,
+                           Accept accept) const {
+    if (!HasTemplate() || frame.Width() < m_width || frame.Height() < m_height) return;
+
+    const int x0 = std::max(region.x, 0);
+    const int y0 = std::max(region.y, 0);
+    const int x1 = std::min(region.x + region.width, frame.Width() - m_width + 1);
+    const int y1 = std::min(region.y + region.height, frame.Height() - m_height + 1);
+
+    const int w = m_width;
+    const int h = m_height;
+    const double inverseCount = 1.0 / ((double)w * h);
+    const double flatEnergy = FLAT_VARIANCE * (double)w * h;
+    double threshold = minScore;
+    if (w * h <= DENSE_MAX_TAPS && m_kernel != Kernel::Scalar) {
+        // Produits d'une ligne de positions d'un coup ; rejet sans racine :
+        // (dot - offset)² < seuil² x énergies, avec la même marge que la borne
+        const GrayImage& image = frame.Image();
+        std::vector<int32_t> dots((size_t)std::max(0, x1 - x0));
+        for (int y = y0; y < y1; y++) {
+            m_rowDot(image.Row(y) + x0, (size_t)image.width, m_evenWeights.data(), w, h, 0, x1 - x0, dots.data());
+            for (int x = x0; x < x1; x++) {
+                stats.positions++;
+
+                const double sum = frame.Sum(x, y, w, h);
+                const double energy = (double)frame.SumSquares(x, y, w, h) - sum * sum * inverseCount;
+                if (energy <= flatEnergy) continue;
+
+                stats.completed++;
+                const double numerator = (double)dots[x - x0] - m_weightMean * sum;
+                if (threshold > 0) {
+                    if (numerator <= 0) continue;
+                    if (numerator * numerator < threshold * threshold * m_centeredEnergy * energy * (1 - 1e-6)) continue;
+                }
+                const double score = numerator / std::sqrt(m_centeredEnergy * energy);
+                if (score >= threshold) threshold = accept(x, y, score);
+            }
+        }
+        return;
+    }
+
+    const int firstCheckpoint = FirstCheckpoint(minScore);
+    const int step = std::max(1, h / 8);
+
+    for (int y = y0; y < y1; y++) {
+        for (int x = x0; x < x1; x++) {
+            stats.positions++;
+
+            const double sum = frame.Sum(x, y, w, h);
+            const double energy = (double)frame.SumSquares(x, y, w, h) - sum * sum * inverseCount;
+            if (energy <= flatEnergy) continue;
+
+            // score = (dot - moyenne des poids x somme) / denominator
+            const double denominator = std::sqrt(m_centeredEnergy * energy);
+            const double offset = m_weightMean * sum;
+            const double needed = threshold * denominator + offset - 1e-6 * (denominator + std::fabs(offset));
+
+            int64_t dot = 0;
+            int done = 0;
+            int next = firstCheckpoint;
+            bool pruned = false;
+            for (;;) {
+                dot += Dot(frame, x, y, done, next);
+                done = next;
+                if (done >= h) break;
+
+                // Borne sur les lignes restantes : Cauchy-Schwarz, image centrée sur sa moyenne
+                const double restMean = frame.Sum(x, y + done, w, h - done) * m_inverseRestCount[done];
+                const double restEnergy = std::max(0.0, (double)frame.SumSquares(x, y + done, w, h - done) -
+                                                        restMean * restMean * (double)(h - done) * w);
+                const double bound = (double)dot + std::sqrt(m_restSquares[done] * restEnergy) +
+                                     restMean * (double)m_restSum[done];
+                if (bound < needed) {
+                    pruned = true;
+                    break;
+                }
+                next = std::min(h, done + step);
+            }
+            if (pruned) continue;
+
+            stats.completed++;
+            const double score = ((double)dot - offset) / denominator;
+            if (score >= threshold) threshold = accept(x, y, score);
+        }
+    }
+}
+
+MatchResult TemplateMatcher::FindBestIn(const MatchFrame& frame, MatchRect region, float minScore) const {
+    MatchResult result = {};
+    double best = 0;
+    Scan(frame, region, minScore, result, [&result, &best](int x, int y, double score) {
+        // Seuil relevé au meilleur score : à égalité, la première position est gardée
+        if (!result.found || score > best) {
+            result.found = true;
+            result.x = x;
+            result.y = y;
+            result.score = (float)score;
+            best = score;
+        }
+        return best;
+    });
+    return result;
+}
+
+MatchResult TemplateMatcher::FindCandidates(const MatchFrame& frame, MatchRect region, float minScore,
+                                            size_t maxCount, std::vector<MatchCandidate>& candidates) const {
+    MatchResult result = {};
+    std::vector<MatchCandidate> hits;
+    Scan(frame, region, minScore, result, [&hits, minScore](int x, int y, double score) {
+        hits.push_back(MatchCandidate{ x, y, (float)score });
+        return (double)minScore;
+    });
+
+    // Meilleurs d'abord, ordre de lecture à score égal (tri stable)
+    std::stable_sort(hits.begin(), hits.end(), [](const MatchCandidate& a, const MatchCandidate& b) {
+        return a.score > b.score;
+    });
+
+    candidates.clear();
+    const int spacingX = std::max(1, m_width / 2);
+    const int spacingY = std::max(1, m_height / 2);
+    for (const MatchCandidate& hit : hits) {
+        if (candidates.size() >= maxCount) break;
+        bool near = false;
+        for (const MatchCandidate& kept : candidates) {
+            if (std::abs(hit.x - kept.x) < spacingX && std::abs(hit.y - kept.y) < spacingY) {
+                near = true;
+                break;
+            }
+        }
+        if (!near) candidates.push_back(hit);
+    }
+
+    if (!candidates.empty()) {
+        result.found = true;
+        result.x = candidates[0].x;
+        result.y = candidates[0].y;
+        result.score = candidates[0].score;
+    }
+    return result;
+}
+
+float TemplateMatcher::ScoreAt(const MatchFrame& frame, int x, int y) const {
+    if (!HasTemplate() || x < 0 || y < 0 || x + m_width > frame.Width() || y + m_height > frame.Height()) return -1;
+
+    const double n = (double)m_width * m_height;
+    const double sum = frame.Sum(x, y, m_width, m_height);
+    const double energy = (double)frame.SumSquares(x, y, m_width, m_height) - sum * sum / n;
+    if (energy <= FLAT_VARIANCE * n) return -1;
+
+    const double dot = (double)Dot(frame, x, y, 0, m_height);
+    return (float)((dot - m_weightMean * sum) / std::sqrt(m_centeredEnergy * energy));
+}
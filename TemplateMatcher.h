@@ -0,0 +1,151 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "GrayImage.h"
+
+// Image capturée préparée pour la recherche : tables de sommes (integral
+// images) des pixels et de leurs carrés. Construite une fois par image,
+// partagée par tous les modèles recherchés dedans.
+class MatchFrame {
+public:
+    MatchFrame();
+
+    // L'image doit rester valide et inchangée tant que la MatchFrame sert.
+    // Sans tables, Sum et SumSquares parcourent les pixels du rectangle : pour
+    // une image où l'on n'examine que quelques voisinages (affinage d'une pyramide).
+    void Prepare(const GrayImage& image, bool tables = true);
+    bool HasTables() const { return m_tables; }
+
+    const GrayImage& Image() const { return *m_image; }
+    int Width() const { return m_image ? m_image->width : 0; }
+    int Height() const { return m_image ? m_image->height : 0; }
+
+    // Somme des pixels (et des carrés) du rectangle [x, x + w) x [y, y + h)
+    uint32_t Sum(int x, int y, int w, int h) const;
+    uint64_t SumSquares(int x, int y, int w, int h) const;
+
+private:
+    const GrayImage* m_image;
+    bool m_tables;
+    size_t m_stride;                    // Largeur + 1
+    std::vector<uint32_t> m_sums;
+    std::vector<uint64_t> m_squares;
+};
+
+// Positions (coin supérieur gauche du modèle) examinées par une recherche
+struct MatchRect {
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+struct MatchResult {
+    bool found;
+    int x;
+    int y;
+    float score;            // Corrélation croisée normalisée, de -1 à 1
+
+    size_t positions;       // Positions examinées
+    size_t completed;       // Positions corrélées entièrement (les autres sont écartées tôt)
+};
+
+struct MatchCandidate {
+    int x;
+    int y;
+    float score;
+};
+
+// Recherche d'un modèle par corrélation croisée normalisée (NCC, centrée) :
+// score = cov(image, modèle) / (écart-type image * écart-type modèle), insensible
+// aux variations uniformes de luminosité et de contraste.
+//
+// Le produit scalaire ligne à ligne passe par un noyau SSE2 ou AVX2 (choisi à
+// l'exécution selon le processeur), ou scalaire ailleurs ; tous calculent en
+// entiers et donnent exactement les mêmes scores.
+// Une position est abandonnée dès que la borne de Cauchy-Schwarz sur les lignes
+// restantes (tirée des tables de sommes) ne permet plus d'atteindre le seuil :
+// la plupart des positions ne sont corrélées que sur une fraction du modèle.
+// Avec SSE2/AVX2, les petits modèles (niveaux réduits d'une pyramide) sont corrélés
+// partout, par blocs de positions consécutives : la borne coûterait plus que le produit.
+class TemplateMatcher {
+public:
+    enum class Kernel { Scalar, Sse2, Avx2 };
+
+    static bool IsSupported(Kernel kernel);
+    static Kernel BestKernel();
+    static const char* KernelName(Kernel kernel);
+
+    TemplateMatcher();
+
+    // false si le modèle est vide, trop grand ou uniforme (NCC indéfinie)
+    bool SetTemplate(const GrayImage& image);
+
+    bool HasTemplate() const { return m_width > 0; }
+    int Width() const { return m_width; }
+    int Height() const { return m_height; }
+
+    // Mémoire occupée, poids et tables de la borne compris
+    size_t MemoryBytes() const;
+
+    // Pour les mesures ; false (et noyau inchangé) si non pris en charge
+    bool SetKernel(Kernel kernel);
+    Kernel GetKernel() const { return m_kernel; }
+
+    // Meilleure position de toute l'image dont le score atteint minScore (0 à 1).
+    // À score égal, la première position dans l'ordre de lecture.
+    MatchResult FindBest(const MatchFrame& frame, float minScore) const;
+
+    // Idem, limité aux positions de region (rognée à l'image)
+    MatchResult FindBestIn(const MatchFrame& frame, MatchRect region, float minScore) const;
+
+    // Positions de region dont le score atteint minScore, meilleures d'abord et au
+    // plus maxCount. Une position à moins d'un demi-modèle d'une meilleure est
+    // écartée : un même objet ne donne qu'un candidat. Le résultat porte le meilleur.
+    MatchResult FindCandidates(const MatchFrame& frame, MatchRect region, float minScore, size_t maxCount,
+                               std::vector<MatchCandidate>& candidates) const;
+
+    // Score exact à une position (-1 si hors image ou zone uniforme)
+    float ScoreAt(const MatchFrame& frame, int x, int y) const;
+
+private:
+    typedef int32_t (*DotFunction)(const uint8_t* frame, size_t frameStride,
+                                   const int16_t* weights, int width, int rows);
+    typedef void (*RowDotFunction)(const uint8_t* frame, size_t frameStride, const int16_t* weights,
+                                   int width, int rows, int first, int count, int32_t* dots);
+
+    static DotFunction DotFor(Kernel kernel);
+    static RowDotFunction RowDotFor(Kernel kernel);
+
+    // Produit image x poids sur les lignes [first, last) du modèle, position (x, y)
+    int64_t Dot(const MatchFrame& frame, int x, int y, int first, int last) const;
+
+    // Lignes corrélées avant le premier test de la borne : assez pour qu'elle
+    // puisse descendre sous minScore
+    int FirstCheckpoint(float minScore) const;
+
+    // Parcours commun des recherches : accept(x, y, score) est appelé pour chaque
+    // position dont le score atteint le seuil courant et renvoie le nouveau seuil
+    template <typename Accept>
+    void Scan(const MatchFrame& frame, MatchRect region, float minScore, MatchResult& stats, Accept accept) const;
+
+    int m_width;
+    int m_height;
+    Kernel m_kernel;
+    DotFunction m_dot;
+    RowDotFunction m_rowDot;
+
+    // Poids : 2 x (pixel - moyenne) arrondi, ligne par ligne
+    std::vector<int16_t> m_weights;
+    std::vector<int16_t> m_evenWeights;     // Idem, lignes de largeur paire (petits modèles)
+    double m_weightMean;                // Moyenne des poids arrondis
+    double m_centeredEnergy;            // Somme des carrés des poids centrés
+
+    // Pour la borne : somme et somme des carrés des poids des lignes [k, hauteur)
+    std::vector<int64_t> m_restSum;
+    std::vector<double> m_restSquares;
+    std::vector<double> m_inverseRestCount;
+
+    int m_blockRows;                    // Lignes par appel du noyau (sans débordement 32 bits)
+};
@@ -0,0 +1,348 @@
+#include "TriggerDispatcher.h"
+
+namespace {
+
+int64_t ToNs(TriggerDispatcher::Clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+TriggerDispatcher::Clock::time_point FromNs(int64_t ns) {
+    return TriggerDispatcher::Clock::time_point(
+        std::chrono::duration_cast<TriggerDispatcher::Clock::duration>(std::chrono::nanoseconds(ns)));
+}
+
+} // namespace
+
+TriggerDispatcher::Slot::Slot()
+    : held(false)
+    , policy(OverloadPolicy::DropNew)
+    , queueLimit(1)
+    , triggers(0)
+    , dropped(0)
+    , coalesced(0)
+    , restarted(0)
+{
+}
+
+TriggerDispatcher::TriggerDispatcher(MacroExecutor& executor, size_t consumerCount)
+    : m_executor(executor)
+    , m_consumerCount(consumerCount > 0 ? consumerCount : 1)
+    , m_shared(std::make_shared<Shared>())
+    , m_running(false)
+    , m_posted(0)
+    , m_dropped(0)
+    , m_dispatched(0)
+    , m_publications(0)
+    , m_maxDepth(0)
+{
+    m_shared->executor = &m_executor;
+    m_shared->active = false;
+}
+
+TriggerDispatcher::~TriggerDispatcher() {
+    Stop();
+}
+
+TriggerDispatcher::Slot* TriggerDispatcher::MacroSet::FindSlot(MacroId id) const {
+    MacroView macro = store->Find(id);
+    return macro.IsValid() ? slots[macro.Row()].get() : nullptr;
+}
+
+void TriggerDispatcher::Publish(std::shared_ptr<const MacroStore> store) {
+    std::lock_guard<std::mutex> publishLock(m_publishMutex);
+    std::shared_ptr<const MacroSet> previous = m_shared->current.Load();
+
+    // Nouvel ensemble construit à part : les lecteurs voient l'ancien jusqu'à la publication
+    std::shared_ptr<MacroSet> set = std::make_shared<MacroSet>();
+    set->index.Build(*store);
+    set->slots.resize(store->Size());
+
+    const MacroKind kinds[] = { MacroKind::Basic, MacroKind::Combo };
+    for (MacroKind kind : kinds) {
+        for (size_t i = 0; i < store->Count(kind); i++) {
+            MacroView macro = store->At(kind, i);
+            if (!macro.Enabled()) continue;
+
+            // Même macro (même identifiant) : reprendre son état
+            std::shared_ptr<Slot> slot;
+            if (previous) {
+                MacroView before = previous->store->Find(macro.Id());
+                if (before.IsValid()) slot = previous->slots[before.Row()];
+            }
+            if (!slot) slot = std::make_shared<Slot>();
+
+            {
+                std::lock_guard<std::mutex> lock(slot->mutex);
+                slot->policy = macro.Policy();
+                slot->queueLimit = macro.QueueLimit();
+            }
+            set->slots[macro.Row()] = slot;
+        }
+    }
+    set->store = std::move(store);
+
+    // Attend que plus aucun lecteur ne tienne l'ancien ensemble
+    m_shared->current.Publish(set);
+    m_publications++;
+
+    // Macros retirées ou désactivées : arrêter l'exécution, oublier les attentes
+    if (!previous) return;
+    for (size_t row = 0; row < previous->slots.size(); row++) {
+        const std::shared_ptr<Slot>& slot = previous->slots[row];
+        if (!slot || set->FindSlot(previous->store->IdData()[row]) == slot.get()) continue;
+
+        std::lock_guard<std::mutex> lock(slot->mutex);
+        slot->pending.clear();
+        slot->run.Stop();
+    }
+}
+
+void TriggerDispatcher::Start() {
+    if (m_running) return;
+
+    // Déclenchements restés en file d'un monitoring précédent
+    DropPending();
+    m_keys.Reset();
+
+    m_shared->active = true;
+    m_running = true;
+    for (size_t i = 0; i < m_consumerCount; i++) {
+        m_consumers.emplace_back(&TriggerDispatcher::ConsumerLoop, this);
+    }
+}
+
+void TriggerDispatcher::Stop() {
+    if (!m_running) return;
+
+    m_running = false;
+    for (size_t i = 0; i < m_consumers.size(); i++) {
+        m_ready.Post();
+    }
+    for (auto& consumer : m_consumers) {
+        consumer.join();
+    }
+    m_consumers.clear();
+    DropPending();
+
+    // Plus aucune exécution en attente ne doit démarrer
+    m_shared->active = false;
+    RcuPointer<MacroSet>::ReadGuard set(m_shared->current);
+    if (!set.Get()) return;
+    for (const auto& slot : set->slots) {
+        if (!slot) continue;
+        std::lock_guard<std::mutex> lock(slot->mutex);
+        slot->pending.clear();
+    }
+}
+
+size_t TriggerDispatcher::OnKeyEdge(const KeyEdge& edge) {
+    if (!m_running) return 0;
+    if (!m_keys.ApplyEdge(edge)) return 0;
+
+    // Seules les macros liées à cette touche sont visitées
+    RcuPointer<MacroSet>::ReadGuard set(m_shared->current);
+    if (!set.Get()) return 0;
+
+    size_t count = 0;
+    const HotkeyBinding* bindings = set->index.Find(edge.vk, count);
+
+    size_t posted = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (Post(bindings[i], edge.down)) posted++;
+    }
+    return posted;
+}
+
+bool TriggerDispatcher::Post(const HotkeyBinding& binding, bool down) {
+    if (!m_running) {
+        m_dropped++;
+        return false;
+    }
+
+    // Mode maintien : publier l'état de la touche avant le déclenchement,
+    // le consommateur se cale sur cet état plutôt que sur l'ordre de traitement
+    if (binding.holdMode) {
+        RcuPointer<MacroSet>::ReadGuard set(m_shared->current);
+        Slot* slot = set.Get() ? set->FindSlot(binding.macroId) : nullptr;
+        if (slot) slot->held.store(down, std::memory_order_release);
+    }
+
+    TriggerRecord record;
+    record.macroId = binding.macroId;
+    record.edge = down ? TriggerRecord::Edge::Press : TriggerRecord::Edge::Release;
+    record.holdMode = binding.holdMode;
+
+    // En simulation, le déclenchement prend son tour dans l'échéancier avant d'être déposé
+    MacroClock& clock = m_executor.GetClock();
+    record.timestampNs = ToNs(clock.Now());
+    record.activity = clock.BeginActivity();
+
+    if (!m_queue.TryPush(record)) {
+        clock.DropActivity(record.activity);
+        m_dropped++;
+        return false;
+    }
+    m_ready.Post();
+
+    // Producteur unique : pas de course sur le maximum
+    size_t depth = m_queue.SizeApprox();
+    if (depth > m_maxDepth.load(std::memory_order_relaxed)) {
+        m_maxDepth.store(depth, std::memory_order_relaxed);
+    }
+    m_posted++;
+    return true;
+}
+
+TriggerDispatcher::Stats TriggerDispatcher::GetStats() const {
+    Stats stats;
+    stats.depth = m_queue.SizeApprox();
+    stats.maxDepth = m_maxDepth.load();
+    stats.posted = m_posted.load();
+    stats.dropped = m_dropped.load();
+    stats.dispatched = m_dispatched.load();
+    stats.publications = m_publications.load();
+    return stats;
+}
+
+TriggerDispatcher::MacroCounters TriggerDispatcher::GetMacroCounters(MacroId id) const {
+    MacroCounters counters = {};
+    RcuPointer<MacroSet>::ReadGuard set(m_shared->current);
+    Slot* slot = set.Get() ? set->FindSlot(id) : nullptr;
+    if (slot) {
+        counters.triggers = slot->triggers.load();
+        counters.dropped = slot->dropped.load();
+        counters.coalesced = slot->coalesced.load();
+        counters.restarted = slot->restarted.load();
+    }
+    return counters;
+}
+
+void TriggerDispatcher::ConsumerLoop() {
+    while (true) {
+        m_ready.Wait();
+        if (!m_running) break;
+
+        TriggerRecord record;
+        if (m_queue.TryPop(record)) {
+            MacroClock& clock = m_executor.GetClock();
+            clock.EnterActivity(record.activity);
+            Dispatch(record);
+            m_dispatched++;
+            clock.LeaveActivity();
+        }
+    }
+}
+
+void TriggerDispatcher::DropPending() {
+    TriggerRecord record;
+    while (m_queue.TryPop(record)) {
+        m_executor.GetClock().DropActivity(record.activity);
+    }
+}
+
+void TriggerDispatcher::Dispatch(const TriggerRecord& record) {
+    // Version courante des macros ; une macro retirée depuis le dépôt est ignorée
+    RcuPointer<MacroSet>::ReadGuard set(m_shared->current);
+    if (!set.Get()) return;
+    MacroView macro = set->store->Find(record.macroId);
+    if (!macro.IsValid() || !set->slots[macro.Row()]) return;
+
+    const std::shared_ptr<Slot>& slot = set->slots[macro.Row()];
+    std::lock_guard<std::mutex> lock(slot->mutex);
+    Clock::time_point triggeredAt = FromNs(record.timestampNs);
+
+    if (record.holdMode) {
+        // Mode maintien : exécuter tant que la touche est maintenue.
+        // Appui et relâchement peuvent être dépilés par deux consommateurs :
+        // on applique le dernier état publié, pas le front de l'enregistrement.
+        if (slot->held.load(std::memory_order_acquire)) {
+            if (!slot->run.IsRunning()) {
+                StartRun(m_shared, set->store, slot, record.macroId, triggeredAt);
+            }
+        } else {
+            slot->run.Stop();
+        }
+        return;
+    }
+
+    if (record.edge != TriggerRecord::Edge::Press) return;
+    slot->triggers++;
+
+    if (!slot->run.IsRunning() && slot->pending.empty()) {
+        StartRun(m_shared, set->store, slot, record.macroId, triggeredAt);
+        return;
+    }
+
+    // Attente restée sans exécution en cours (rappel passé avant elle) : la
+    // démarrer maintenant, le nouveau déclenchement suit la politique
+    if (!slot->run.IsRunning()) {
+        Clock::time_point waiting = slot->pending.front();
+        slot->pending.pop_front();
+        StartRun(m_shared, set->store, slot, record.macroId, waiting);
+    }
+    ApplyPolicy(*slot, triggeredAt);
+}
+
+void TriggerDispatcher::ApplyPolicy(Slot& slot, Clock::time_point triggeredAt) {
+    // Les exécutions en attente sont démarrées par OnRunFinished
+    switch (slot.policy) {
+        case OverloadPolicy::DropNew:
+            slot.dropped++;
+            break;
+
+        case OverloadPolicy::Restart:
+            // Interrompre sans chevauchement : la nouvelle exécution part à la fin de l'actuelle
+            slot.run.Stop();
+            if (!slot.pending.empty()) slot.coalesced++;
+            slot.pending.clear();
+            slot.pending.push_back(triggeredAt);
+            slot.restarted++;
+            break;
+
+        case OverloadPolicy::Queue:
+            if (slot.pending.size() < slot.queueLimit) {
+                slot.pending.push_back(triggeredAt);
+            } else {
+                slot.dropped++;
+            }
+            break;
+
+        case OverloadPolicy::Coalesce:
+            if (slot.pending.empty()) {
+                slot.pending.push_back(triggeredAt);
+            } else {
+                slot.coalesced++;
+            }
+            break;
+    }
+}
+
+void TriggerDispatcher::StartRun(const std::shared_ptr<Shared>& shared, const std::shared_ptr<const MacroStore>& store,
+                                 const std::shared_ptr<Slot>& slot, MacroId id, Clock::time_point triggeredAt) {
+    // Le rappel garde le slot et l'état partagé en vie, même après Stop() ou
+    // la destruction du dispatcher. Toujours installé, même en DropNew : la
+    // politique peut changer en cours d'exécution (Publish) et laisser des
+    // attentes ; sans attente, il ne fait rien.
+    MacroExecutor::FinishedCallback onFinished = [shared, slot, id]() { OnRunFinished(shared, slot, id); };
+
+    // L'exécution garde sa version du store : une publication ne l'interrompt pas
+    slot->run = shared->executor->ExecuteMacro(store, store->Find(id), triggeredAt, std::move(onFinished));
+}
+
+void TriggerDispatcher::OnRunFinished(const std::shared_ptr<Shared>& shared, const std::shared_ptr<Slot>& slot, MacroId id) {
+    std::lock_guard<std::mutex> lock(slot->mutex);
+
+    // Une exécution a pu repartir entre MarkFinished et ce rappel : son propre rappel prendra le relais
+    if (!shared->active || slot->pending.empty() || slot->run.IsRunning()) return;
+
+    // L'attente part avec la version courante de la macro, si elle existe encore
+    RcuPointer<MacroSet>::ReadGuard set(shared->current);
+    if (!set.Get() || set->FindSlot(id) != slot.get()) {
+        slot->pending.clear();
+        return;
+    }
+
+    Clock::time_point triggeredAt = slot->pending.front();
+    slot->pending.pop_front();
+    StartRun(shared, set->store, slot, id, triggeredAt);
+}
@@ -0,0 +1,155 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "BoundedQueue.h"
+#include "HotkeyDispatchIndex.h"
+#include "MacroExecutor.h"
+#include "MacroStore.h"
+#include "RcuPointer.h"
+#include "Semaphore.h"
+
+// Déclenchement transmis du monitoring à l'exécution (copié tel quel dans la file)
+struct TriggerRecord {
+    enum class Edge : uint8_t { Press, Release };
+
+    MacroId macroId;
+    Edge edge;
+    bool holdMode;
+    int64_t timestampNs;    // Instant du front (horloge de l'exécuteur)
+    MacroClock::Activity activity;  // Tour dans l'échéancier en simulation (voir VirtualClock)
+};
+
+// Découple le thread des hooks du démarrage des macros.
+// Le thread des hooks (producteur unique) ne fait que déposer un TriggerRecord
+// dans une file bornée sans verrou ; des threads consommateurs dépilent et
+// démarrent / arrêtent les exécutions. Post() ne bloque pas et n'alloue pas.
+//
+// Les macros (MacroStore), l'index des hotkeys et l'état par macro forment un
+// ensemble immuable publié par Publish() à la manière de RCU : le thread des
+// hooks et les consommateurs le lisent sans verrou, et une nouvelle
+// publication peut avoir lieu pendant le monitoring. Les déclenchements
+// désignent les macros par identifiant : ceux déjà en file visent la version
+// courante au moment où ils sont traités.
+class TriggerDispatcher {
+public:
+    typedef DeadlineTimer::Clock Clock;
+
+    static const size_t QueueCapacity = 256;
+
+    struct Stats {
+        size_t depth;           // Déclenchements en attente
+        size_t maxDepth;        // Profondeur maximale observée
+        uint64_t posted;
+        uint64_t dropped;       // File pleine ou dispatcher arrêté
+        uint64_t dispatched;
+        uint64_t publications;  // Appels à Publish()
+    };
+
+    // Compteurs d'une macro depuis sa première publication
+    struct MacroCounters {
+        uint64_t triggers;      // Appuis reçus
+        uint64_t dropped;       // Ignorés (DropNew, ou Queue plein)
+        uint64_t coalesced;     // Fondus dans une exécution déjà en attente
+        uint64_t restarted;     // Exécutions interrompues par Restart
+    };
+
+    explicit TriggerDispatcher(MacroExecutor& executor, size_t consumerCount = 2);
+    ~TriggerDispatcher();
+
+    TriggerDispatcher(const TriggerDispatcher&) = delete;
+    TriggerDispatcher& operator=(const TriggerDispatcher&) = delete;
+
+    // Publier un nouvel ensemble de macros (thread UI), arrêté ou non.
+    // L'état d'une macro toujours activée (exécution en cours, attente,
+    // compteurs) est conservé ; les macros retirées ou désactivées sont arrêtées.
+    void Publish(std::shared_ptr<const MacroStore> store);
+
+    // En simulation (VirtualClock), Stop() doit être appelé par un thread non attaché
+    void Start();
+    void Stop();
+
+    // Appelé par le producteur unique (thread des hooks) pour chaque front de touche :
+    // déclenche les macros liées à la touche. Retourne le nombre de déclenchements déposés.
+    size_t OnKeyEdge(const KeyEdge& edge);
+
+    // Déposer un déclenchement (producteur unique).
+    // Retourne false si le déclenchement est perdu (file pleine).
+    bool Post(const HotkeyBinding& binding, bool down);
+
+    Stats GetStats() const;
+    MacroCounters GetMacroCounters(MacroId id) const;
+
+    // Latence front de touche -> début d'exécution sur un worker
+    TimingStats::Report GetLatencyReport() const { return m_executor.GetStartLatencyReport(); }
+
+private:
+    // État d'une macro côté exécution, repris d'une publication à la suivante
+    struct Slot {
+        std::mutex mutex;               // Sérialise les décisions start/stop de la macro
+        std::atomic<bool> held;         // Dernier état de la touche (mode maintien), écrit par le producteur
+        RunHandle run;
+        std::deque<Clock::time_point> pending;  // Exécutions en attente (instant du déclenchement)
+        OverloadPolicy policy;
+        size_t queueLimit;
+
+        std::atomic<uint64_t> triggers;
+        std::atomic<uint64_t> dropped;
+        std::atomic<uint64_t> coalesced;
+        std::atomic<uint64_t> restarted;
+
+        Slot();
+    };
+
+    // Ensemble publié : jamais modifié après Publish() (seul le contenu des slots,
+    // protégé par leur mutex, évolue)
+    struct MacroSet {
+        std::shared_ptr<const MacroStore> store;
+        HotkeyDispatchIndex index;
+        std::vector<std::shared_ptr<Slot>> slots;   // Par ligne du store ; nul si la macro n'est pas déclenchable
+
+        Slot* FindSlot(MacroId id) const;
+    };
+
+    // Partagé avec les rappels de fin d'exécution, qui peuvent survenir
+    // après Stop() ou la destruction du dispatcher
+    struct Shared {
+        MacroExecutor* executor;
+        RcuPointer<MacroSet> current;
+        std::atomic<bool> active;       // Passé à false sous le verrou de chaque slot
+    };
+
+    void ConsumerLoop();
+    void Dispatch(const TriggerRecord& record);
+    void DropPending();     // Vider la file (consommateurs arrêtés)
+
+    // Appelés avec slot.mutex verrouillé
+    static void ApplyPolicy(Slot& slot, Clock::time_point triggeredAt);
+    static void StartRun(const std::shared_ptr<Shared>& shared, const std::shared_ptr<const MacroStore>& store,
+                         const std::shared_ptr<Slot>& slot, MacroId id, Clock::time_point triggeredAt);
+
+    // Rappel de fin d'exécution (thread du worker) : démarrer l'exécution en attente
+    static void OnRunFinished(const std::shared_ptr<Shared>& shared, const std::shared_ptr<Slot>& slot, MacroId id);
+
+    MacroExecutor& m_executor;
+    const size_t m_consumerCount;
+
+    std::shared_ptr<Shared> m_shared;
+    std::mutex m_publishMutex;          // Sérialise Publish() (reprise des slots)
+    KeyStateTable m_keys;               // Thread des hooks uniquement
+
+    BoundedQueue<TriggerRecord, QueueCapacity> m_queue;
+    Semaphore m_ready;
+    std::vector<std::thread> m_consumers;
+    std::atomic<bool> m_running;
+
+    std::atomic<uint64_t> m_posted;
+    std::atomic<uint64_t> m_dropped;
+    std::atomic<uint64_t> m_dispatched;
+    std::atomic<uint64_t> m_publications;
+    std::atomic<size_t> m_maxDepth;
+};
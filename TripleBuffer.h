@@ -0,0 +1,55 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Échange de la dernière valeur entre un producteur et un consommateur, sans
+// verrou : trois valeurs préallouées et réutilisées. Le producteur écrit dans
+// la sienne puis la publie en l'échangeant avec celle du milieu ; le
+// consommateur échange la sienne avec celle du milieu quand elle est nouvelle.
+// Aucun des deux n'attend l'autre : une valeur publiée puis remplacée avant
+// d'être prise est simplement sautée.
+template <typename T>
+class TripleBuffer {
+    static const uint8_t INDEX_MASK = 3;
+    static const uint8_t FRESH = 4;     // Valeur du milieu publiée et pas encore prise
+
+public:
+    TripleBuffer()
+        : m_middle(1)
+        , m_back(2)
+        , m_front(0)
+    {
+    }
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Producteur : valeur à remplir, à lui seul jusqu'à Publish()
+    T& Back() { return m_slots[m_back]; }
+
+    // Producteur : publier Back() ; retourne true si la valeur publiée
+    // précédemment n'avait pas été prise (sautée)
+    bool Publish() {
+        uint8_t previous = m_middle.exchange((uint8_t)(m_back | FRESH), std::memory_order_acq_rel);
+        m_back = previous & INDEX_MASK;
+        return (previous & FRESH) != 0;
+    }
+
+    // Consommateur : prendre la dernière valeur publiée ; false (Front() inchangée)
+    // si rien de nouveau depuis le dernier appel
+    bool Update() {
+        if ((m_middle.load(std::memory_order_relaxed) & FRESH) == 0) return false;
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    // Consommateur : valeur prise, à lui seul jusqu'au prochain Update()
+    T& Front() { return m_slots[m_front]; }
+    const T& Front() const { return m_slots[m_front]; }
+
+private:
+    T m_slots[3];
+    alignas(64) std::atomic<uint8_t> m_middle;
+    alignas(64) uint8_t m_back;     // Producteur seulement
+    alignas(64) uint8_t m_front;    // Consommateur seulement
+};
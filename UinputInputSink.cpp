@@ -0,0 +1,110 @@
+#include "UinputInputSink.h"
+#include "InputBatcher.h"
+#include "LinuxKeyMap.h"
+#include <cstring>
+#include <fcntl.h>
+#include <linux/uinput.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace {
+
+uint16_t ButtonCode(MouseButton button) {
+    switch (button) {
+        case MouseButton::Right:  return BTN_RIGHT;
+        case MouseButton::Middle: return BTN_MIDDLE;
+        case MouseButton::X1:     return BTN_SIDE;
+        case MouseButton::X2:     return BTN_EXTRA;
+        default:                  return BTN_LEFT;
+    }
+}
+
+} // namespace
+
+UinputInputSink::UinputInputSink()
+    : m_fd(-1)
+{
+}
+
+UinputInputSink::~UinputInputSink() {
+    Close();
+}
+
+bool UinputInputSink::Open(const std::string& devicePath) {
+    if (m_fd >= 0) return true;
+
+    m_fd = open(devicePath.c_str(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+    if (m_fd < 0) return false;
+
+    // Touches connues de KeyTable et boutons souris ; REL_X/REL_Y pour être
+    // reconnu comme souris par l'environnement graphique
+    bool ok = ioctl(m_fd, UI_SET_EVBIT, EV_KEY) == 0 &&
+              ioctl(m_fd, UI_SET_EVBIT, EV_SYN) == 0 &&
+              ioctl(m_fd, UI_SET_EVBIT, EV_REL) == 0 &&
+              ioctl(m_fd, UI_SET_RELBIT, REL_X) == 0 &&
+              ioctl(m_fd, UI_SET_RELBIT, REL_Y) == 0;
+    LinuxKeyMap::ForEachCode([this, &ok](uint16_t code) {
+        ok = ok && ioctl(m_fd, UI_SET_KEYBIT, code) == 0;
+    });
+
+    struct uinput_setup setup;
+    memset(&setup, 0, sizeof(setup));
+    setup.id.bustype = BUS_VIRTUAL;
+    setup.id.vendor = 0x4D46;   // "MF"
+    setup.id.product = 0x0001;
+    strncpy(setup.name, "MacroFlow virtual input", UINPUT_MAX_NAME_SIZE - 1);
+
+    ok = ok && ioctl(m_fd, UI_DEV_SETUP, &setup) == 0 &&
+               ioctl(m_fd, UI_DEV_CREATE) == 0;
+    if (!ok) {
+        close(m_fd);
+        m_fd = -1;
+    }
+    return ok;
+}
+
+void UinputInputSink::Close() {
+    if (m_fd < 0) return;
+    ioctl(m_fd, UI_DEV_DESTROY);
+    close(m_fd);
+    m_fd = -1;
+}
+
+void UinputInputSink::Submit(const InputEvent* events, size_t count) {
+    if (m_fd < 0) return;
+
+    // Lot + EV_SYN final, sur la pile
+    struct input_event inputs[InputBatcher::MaxBatch + 1];
+    size_t n = 0;
+
+    for (size_t i = 0; i < count && n < InputBatcher::MaxBatch; i++) {
+        const InputEvent& e = events[i];
+        uint16_t code;
+        bool down;
+        if (e.type == InputEvent::Type::KeyDown || e.type == InputEvent::Type::KeyUp) {
+            code = LinuxKeyMap::ToLinux(e.vk);
+            down = (e.type == InputEvent::Type::KeyDown);
+        } else {
+            code = ButtonCode(e.button);
+            down = (e.type == InputEvent::Type::MouseDown);
+        }
+        if (code == 0) continue;
+
+        // Horodatage laissé à zéro : le noyau le renseigne
+        struct input_event& input = inputs[n++];
+        memset(&input, 0, sizeof(input));
+        input.type = EV_KEY;
+        input.code = code;
+        input.value = down ? 1 : 0;
+    }
+    if (n == 0) return;
+
+    memset(&inputs[n], 0, sizeof(inputs[n]));
+    inputs[n].type = EV_SYN;
+    inputs[n].code = SYN_REPORT;
+    n++;
+
+    // Un seul write : le noyau traite le lot sans l'entrelacer avec un autre
+    ssize_t written = write(m_fd, inputs, n * sizeof(inputs[0]));
+    (void)written;
+}
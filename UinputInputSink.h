@@ -0,0 +1,23 @@
+#pragma once
+#include "InputSink.h"
+#include <string>
+
+// Injection via /dev/uinput (Linux) : un clavier + souris virtuel.
+// Chaque lot part en un seul write() terminé par un EV_SYN : les accords
+// (CTRL+SHIFT+X) arrivent d'un bloc aux lecteurs du périphérique.
+// Demande un accès en écriture à /dev/uinput (groupe input ou root).
+class UinputInputSink : public InputSink {
+public:
+    UinputInputSink();
+    ~UinputInputSink();
+
+    // Créer le périphérique virtuel ; false si uinput est inaccessible
+    bool Open(const std::string& devicePath = "/dev/uinput");
+    void Close();
+    bool IsOpen() const { return m_fd >= 0; }
+
+    void Submit(const InputEvent* events, size_t count) override;
+
+private:
+    int m_fd;
+};
@@ -0,0 +1,92 @@
+#include "Utf8.h"
+#include <cstdint>
+
+void Utf8::AppendToWide(const char* str, size_t length, std::wstring& out) {
+    const unsigned char* p = (const unsigned char*)str;
+    const unsigned char* end = p + length;
+
+    // Au plus un caractère par octet
+    out.reserve(out.size() + length);
+
+    while (p < end) {
+        // Cas courant : texte ASCII recopié tel quel
+        if (*p < 0x80) {
+            out += (wchar_t)*p++;
+            continue;
+        }
+
+        uint32_t code = *p++;
+        int extra = 0;
+
+        if (code >= 0xF0 && code < 0xF8) { code &= 0x07; extra = 3; }
+        else if (code >= 0xE0 && code < 0xF0) { code &= 0x0F; extra = 2; }
+        else if (code >= 0xC0 && code < 0xE0) { code &= 0x1F; extra = 1; }
+        else { code = 0xFFFD; }
+
+        if (end - p < extra) {
+            code = 0xFFFD;
+            extra = 0;
+            p = end;
+        }
+        for (int i = 0; i < extra; i++) {
+            if ((p[i] & 0xC0) != 0x80) { code = 0xFFFD; extra = i; break; }
+            code = (code << 6) | (p[i] & 0x3F);
+        }
+        p += extra;
+
+        if (sizeof(wchar_t) == 2 && code >= 0x10000) {
+            code -= 0x10000;
+            out += (wchar_t)(0xD800 + (code >> 10));
+            out += (wchar_t)(0xDC00 + (code & 0x3FF));
+        } else {
+            out += (wchar_t)code;
+        }
+    }
+}
+
+void Utf8::AppendFromWide(const wchar_t* str, size_t length, std::string& out) {
+    out.reserve(out.size() + length);
+
+    for (size_t i = 0; i < length; i++) {
+        uint32_t c = (uint32_t)str[i];
+
+        if (c < 0x80) {
+            out += (char)c;
+            continue;
+        }
+
+        // Paire de substitution UTF-16
+        if (c >= 0xD800 && c <= 0xDBFF && i + 1 < length &&
+            (uint32_t)str[i + 1] >= 0xDC00 && (uint32_t)str[i + 1] <= 0xDFFF) {
+            c = 0x10000 + ((c - 0xD800) << 10) + ((uint32_t)str[++i] - 0xDC00);
+        } else if ((c >= 0xD800 && c <= 0xDFFF) || c > 0x10FFFF) {
+            c = 0xFFFD;
+        }
+
+        if (c < 0x800) {
+            out += (char)(0xC0 | (c >> 6));
+            out += (char)(0x80 | (c & 0x3F));
+        } else if (c < 0x10000) {
+            out += (char)(0xE0 | (c >> 12));
+            out += (char)(0x80 | ((c >> 6) & 0x3F));
+            out += (char)(0x80 | (c & 0x3F));
+        } else {
+            out += (char)(0xF0 | (c >> 18));
+            out += (char)(0x80 | ((c >> 12) & 0x3F));
+            out += (char)(0x80 | ((c >> 6) & 0x3F));
+            out += (char)(0x80 | (c & 0x3F));
+        }
+    }
+}
+
+std::wstring Utf8::ToWide(const std::string& str) {
+    std::wstring result;
+    AppendToWide(str.data(), str.size(), result);
+    return result;
+}
+
+std::string Utf8::FromWide(const std::wstring& str) {
+    std::string result;
+    AppendFromWide(str.data(), str.size(), result);
+    return result;
+}
@@ -0,0 +1,14 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// Conversions UTF-8 <-> wstring (UTF-16 sous Windows, UTF-32 ailleurs),
+// sans dépendre de l'API Win32. Les séquences invalides deviennent U+FFFD.
+class Utf8 {
+public:
+    static void AppendToWide(const char* str, size_t length, std::wstring& out);
+    static void AppendFromWide(const wchar_t* str, size_t length, std::string& out);
+
+    static std::wstring ToWide(const std::string& str);
+    static std::string FromWide(const std::wstring& str);
+};
@@ -0,0 +1,39 @@
+#include "Win32InputSink.h"
+#include "InputBatcher.h"
+#include <windows.h>
+
+void Win32InputSink::Submit(const InputEvent* events, size_t count) {
+    INPUT inputs[InputBatcher::MaxBatch];
+    UINT n = 0;
+
+    for (size_t i = 0; i < count && n < InputBatcher::MaxBatch; i++) {
+        const InputEvent& e = events[i];
+        INPUT& input = inputs[n++];
+        ZeroMemory(&input, sizeof(INPUT));
+
+        if (e.type == InputEvent::Type::KeyDown || e.type == InputEvent::Type::KeyUp) {
+            input.type = INPUT_KEYBOARD;
+            input.ki.wVk = e.vk;
+            if (e.type == InputEvent::Type::KeyUp) input.ki.dwFlags = KEYEVENTF_KEYUP;
+            continue;
+        }
+
+        bool down = (e.type == InputEvent::Type::MouseDown);
+        input.type = INPUT_MOUSE;
+        switch (e.button) {
+            case MouseButton::Left:   input.mi.dwFlags = down ? MOUSEEVENTF_LEFTDOWN : MOUSEEVENTF_LEFTUP; break;
+            case MouseButton::Right:  input.mi.dwFlags = down ? MOUSEEVENTF_RIGHTDOWN : MOUSEEVENTF_RIGHTUP; break;
+            case MouseButton::Middle: input.mi.dwFlags = down ? MOUSEEVENTF_MIDDLEDOWN : MOUSEEVENTF_MIDDLEUP; break;
+            case MouseButton::X1:
+            case MouseButton::X2:
+                // Boutons latéraux : le bouton est précisé dans mouseData
+                input.mi.dwFlags = down ? MOUSEEVENTF_XDOWN : MOUSEEVENTF_XUP;
+                input.mi.mouseData = (e.button == MouseButton::X1) ? XBUTTON1 : XBUTTON2;
+                break;
+        }
+    }
+
+    if (n > 0) {
+        SendInput(n, inputs, sizeof(INPUT));
+    }
+}
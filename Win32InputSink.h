@@ -0,0 +1,9 @@
+#pragma once
+#include "InputSink.h"
+
+// Injection via SendInput : chaque lot part en un seul appel système,
+// ce qui rend les accords (CTRL+SHIFT+X) atomiques vis-à-vis des autres entrées
+class Win32InputSink : public InputSink {
+public:
+    void Submit(const InputEvent* events, size_t count) override;
+};
@@ -0,0 +1,133 @@
+#include "Win32KeyHookSource.h"
+
+Win32KeyHookSource* Win32KeyHookSource::s_active = nullptr;
+
+Win32KeyHookSource::Win32KeyHookSource()
+    : m_threadId(0)
+    , m_keyboardHook(nullptr)
+    , m_mouseHook(nullptr)
+{
+}
+
+Win32KeyHookSource::~Win32KeyHookSource() {
+    Stop();
+}
+
+bool Win32KeyHookSource::Start(Callback callback) {
+    if (m_thread.joinable() || s_active) return false;
+
+    m_callback = std::move(callback);
+    m_down.reset();
+    s_active = this;
+
+    // Attendre que les hooks soient posés pour pouvoir signaler un échec
+    bool installed = false;
+    HANDLE ready = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    m_thread = std::thread(&Win32KeyHookSource::HookThread, this, &installed, ready);
+    WaitForSingleObject(ready, INFINITE);
+    CloseHandle(ready);
+
+    if (!installed) {
+        m_thread.join();
+        s_active = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void Win32KeyHookSource::Stop() {
+    if (!m_thread.joinable()) return;
+
+    PostThreadMessageW(m_threadId, WM_QUIT, 0, 0);
+    m_thread.join();
+    s_active = nullptr;
+}
+
+void Win32KeyHookSource::HookThread(bool* installed, HANDLE readyEvent) {
+    m_threadId = GetCurrentThreadId();
+
+    // Forcer la création de la file de messages avant de signaler "prêt"
+    MSG msg;
+    PeekMessageW(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+
+    HINSTANCE module = GetModuleHandleW(nullptr);
+    m_keyboardHook = SetWindowsHookExW(WH_KEYBOARD_LL, KeyboardProc, module, 0);
+    m_mouseHook = SetWindowsHookExW(WH_MOUSE_LL, MouseProc, module, 0);
+
+    *installed = (m_keyboardHook != nullptr && m_mouseHook != nullptr);
+    SetEvent(readyEvent);
+
+    if (*installed) {
+        // Les hooks bas niveau sont appelés depuis cette boucle de messages
+        while (GetMessageW(&msg, nullptr, 0, 0) > 0) {
+            TranslateMessage(&msg);
+            DispatchMessageW(&msg);
+        }
+    }
+
+    if (m_keyboardHook) UnhookWindowsHookEx(m_keyboardHook);
+    if (m_mouseHook) UnhookWindowsHookEx(m_mouseHook);
+    m_keyboardHook = nullptr;
+    m_mouseHook = nullptr;
+}
+
+void Win32KeyHookSource::Emit(uint16_t vk, bool down) {
+    if (vk >= m_down.size()) return;
+
+    // Ne remonter que les changements d'état (ignore l'auto-répétition)
+    if (m_down.test(vk) == down) return;
+    m_down.set(vk, down);
+
+    if (m_callback) {
+        KeyEdge edge;
+        edge.vk = vk;
+        edge.down = down;
+        m_callback(edge);
+    }
+}
+
+LRESULT CALLBACK Win32KeyHookSource::KeyboardProc(int code, WPARAM wParam, LPARAM lParam) {
+    if (code == HC_ACTION && s_active) {
+        const KBDLLHOOKSTRUCT* info = (const KBDLLHOOKSTRUCT*)lParam;
+
+        // Ignorer les touches simulées par SendInput
+        if (!(info->flags & LLKHF_INJECTED)) {
+            bool down = (wParam == WM_KEYDOWN || wParam == WM_SYSKEYDOWN);
+            uint16_t vk = (uint16_t)info->vkCode;
+            s_active->Emit(vk, down);
+
+            // Les hotkeys utilisent les codes génériques (SHIFT, CTRL, ALT)
+            switch (vk) {
+                case VK_LSHIFT: case VK_RSHIFT:     s_active->Emit(VK_SHIFT, down); break;
+                case VK_LCONTROL: case VK_RCONTROL: s_active->Emit(VK_CONTROL, down); break;
+                case VK_LMENU: case VK_RMENU:       s_active->Emit(VK_MENU, down); break;
+            }
+        }
+    }
+    return CallNextHookEx(nullptr, code, wParam, lParam);
+}
+
+LRESULT CALLBACK Win32KeyHookSource::MouseProc(int code, WPARAM wParam, LPARAM lParam) {
+    if (code == HC_ACTION && s_active) {
+        const MSLLHOOKSTRUCT* info = (const MSLLHOOKSTRUCT*)lParam;
+
+        if (!(info->flags & LLMHF_INJECTED)) {
+            switch (wParam) {
+                case WM_LBUTTONDOWN: s_active->Emit(VK_LBUTTON, true); break;
+                case WM_LBUTTONUP:   s_active->Emit(VK_LBUTTON, false); break;
+                case WM_RBUTTONDOWN: s_active->Emit(VK_RBUTTON, true); break;
+                case WM_RBUTTONUP:   s_active->Emit(VK_RBUTTON, false); break;
+                case WM_MBUTTONDOWN: s_active->Emit(VK_MBUTTON, true); break;
+                case WM_MBUTTONUP:   s_active->Emit(VK_MBUTTON, false); break;
+                case WM_XBUTTONDOWN:
+                case WM_XBUTTONUP: {
+                    bool down = (wParam == WM_XBUTTONDOWN);
+                    uint16_t vk = (HIWORD(info->mouseData) == XBUTTON1) ? VK_XBUTTON1 : VK_XBUTTON2;
+                    s_active->Emit(vk, down);
+                    break;
+                }
+            }
+        }
+    }
+    return CallNextHookEx(nullptr, code, wParam, lParam);
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "KeyEventSource.h"
+#include <windows.h>
+#include <bitset>
+#include <thread>
+
+// Source basée sur les hooks bas niveau clavier et souris (WH_KEYBOARD_LL / WH_MOUSE_LL).
+// Les hooks vivent sur un thread dédié qui dort dans GetMessage : aucun travail
+// tant qu'aucune touche ne change d'état. Seuls les fronts sont remontés
+// (pas l'auto-répétition), et les entrées injectées par nos macros sont ignorées.
+class Win32KeyHookSource : public KeyEventSource {
+public:
+    Win32KeyHookSource();
+    ~Win32KeyHookSource();
+
+    bool Start(Callback callback) override;
+    void Stop() override;
+
+private:
+    static LRESULT CALLBACK KeyboardProc(int code, WPARAM wParam, LPARAM lParam);
+    static LRESULT CALLBACK MouseProc(int code, WPARAM wParam, LPARAM lParam);
+
+    void HookThread(bool* installed, HANDLE readyEvent);
+    void Emit(uint16_t vk, bool down);
+
+    // Une seule source active à la fois : les procédures de hook n'ont pas de contexte
+    static Win32KeyHookSource* s_active;
+
+    Callback m_callback;
+    std::thread m_thread;
+    DWORD m_threadId;
+    HHOOK m_keyboardHook;
+    HHOOK m_mouseHook;
+    std::bitset<256> m_down;    // Accédé uniquement depuis le thread des hooks
+};
@@ -0,0 +1,81 @@
+#include "Win32ScreenCapture.h"
+
+Win32ScreenCapture::Win32ScreenCapture()
+    : m_memory(nullptr)
+    , m_bitmap(nullptr)
+    , m_previous(nullptr)
+    , m_width(0)
+    , m_height(0)
+{
+}
+
+Win32ScreenCapture::~Win32ScreenCapture() {
+    Release();
+}
+
+void Win32ScreenCapture::Release() {
+    if (m_memory && m_previous) SelectObject(m_memory, m_previous);
+    if (m_bitmap) DeleteObject(m_bitmap);
+    if (m_memory) DeleteDC(m_memory);
+    m_memory = nullptr;
+    m_bitmap = nullptr;
+    m_previous = nullptr;
+    m_width = 0;
+    m_height = 0;
+}
+
+bool Win32ScreenCapture::Capture(GrayImage& frame) {
+    int width = GetSystemMetrics(SM_CXSCREEN);
+    int height = GetSystemMetrics(SM_CYSCREEN);
+    if (width <= 0 || height <= 0) return false;
+
+    // Le DC de l'écran est rendu à chaque capture (ReleaseDC doit venir du
+    // même thread) ; le reste est gardé tant que la résolution ne change pas
+    HDC screen = GetDC(nullptr);
+    if (!screen) return false;
+    if (width != m_width || height != m_height || !m_bitmap) {
+        Release();
+        m_memory = CreateCompatibleDC(screen);
+        m_bitmap = CreateCompatibleBitmap(screen, width, height);
+        if (!m_memory || !m_bitmap) {
+            Release();
+            ReleaseDC(nullptr, screen);
+            return false;
+        }
+        m_previous = SelectObject(m_memory, m_bitmap);
+        m_width = width;
+        m_height = height;
+        m_pixels.resize((size_t)width * height * 4);
+    }
+
+    bool copied = BitBlt(m_memory, 0, 0, width, height, screen, 0, 0, SRCCOPY) != FALSE;
+    ReleaseDC(nullptr, screen);
+    if (!copied) {
+        // Bureau changé (verrouillage, UAC) : bitmap recréé à la prochaine capture
+        Release();
+        return false;
+    }
+
+    // Pixels BGRA, lignes de haut en bas (hauteur négative). Le bitmap doit
+    // être désélectionné du contexte pendant GetDIBits.
+    BITMAPINFO info;
+    ZeroMemory(&info, sizeof(info));
+    info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    info.bmiHeader.biWidth = width;
+    info.bmiHeader.biHeight = -height;
+    info.bmiHeader.biPlanes = 1;
+    info.bmiHeader.biBitCount = 32;
+    info.bmiHeader.biCompression = BI_RGB;
+
+    SelectObject(m_memory, m_previous);
+    bool ok = GetDIBits(m_memory, m_bitmap, 0, height, m_pixels.data(), &info, DIB_RGB_COLORS) == height;
+    SelectObject(m_memory, m_bitmap);
+    if (!ok) return false;
+
+    frame.Resize(width, height);
+    const uint8_t* src = m_pixels.data();
+    for (size_t i = 0; i < frame.pixels.size(); i++, src += 4) {
+        frame.pixels[i] = GrayImage::Luma(src[2], src[1], src[0]);
+    }
+    return true;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "FrameSource.h"
+#include <windows.h>
+#include <cstdint>
+#include <vector>
+
+// Capture de l'écran principal par GDI (BitBlt), convertie en niveaux de gris
+// pour la détection d'image. Contextes, bitmap et tampon BGRA sont gardés d'une
+// capture à l'autre et recréés seulement si la résolution change.
+class Win32ScreenCapture : public FrameSource {
+public:
+    Win32ScreenCapture();
+    ~Win32ScreenCapture();
+
+    Win32ScreenCapture(const Win32ScreenCapture&) = delete;
+    Win32ScreenCapture& operator=(const Win32ScreenCapture&) = delete;
+
+    // false si la capture a échoué (session verrouillée, bureau sécurisé...)
+    bool Capture(GrayImage& frame) override;
+
+private:
+    void Release();
+
+    HDC m_memory;
+    HBITMAP m_bitmap;
+    HGDIOBJ m_previous;
+    int m_width;
+    int m_height;
+    std::vector<uint8_t> m_pixels;
+};
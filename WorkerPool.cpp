@@ -0,0 +1,67 @@
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(size_t initialThreads, size_t maxThreads)
+    : m_idleThreads(0)
+    , m_maxThreads(maxThreads < initialThreads ? initialThreads : maxThreads)
+    , m_shutdown(false)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (size_t i = 0; i < initialThreads; i++) {
+        SpawnWorker();
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_wake.notify_all();
+
+    // Les tâches déjà en file sont terminées avant de rendre la main
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::Submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+
+        // Tous les workers sont pris (macros en boucle, par exemple) : en ajouter un
+        if (m_tasks.size() > m_idleThreads && m_threads.size() < m_maxThreads) {
+            SpawnWorker();
+        }
+    }
+    m_wake.notify_one();
+}
+
+size_t WorkerPool::ThreadCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_threads.size();
+}
+
+void WorkerPool::SpawnWorker() {
+    // Appelé avec m_mutex verrouillé
+    m_idleThreads++;
+    m_threads.emplace_back(&WorkerPool::WorkerLoop, this);
+}
+
+void WorkerPool::WorkerLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_wake.wait(lock, [this]() { return m_shutdown || !m_tasks.empty(); });
+        if (m_tasks.empty()) break; // Arrêt demandé et plus rien à faire
+
+        std::function<void()> task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+        m_idleThreads--;
+
+        lock.unlock();
+        task();
+        lock.lock();
+
+        m_idleThreads++;
+    }
+}
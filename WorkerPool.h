@@ -0,0 +1,36 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool de threads persistants pour l'exécution des macros.
+// Les threads sont créés à l'avance : un déclenchement ne crée pas de thread,
+// sauf si toutes les exécutions simultanées occupent déjà chaque worker.
+class WorkerPool {
+public:
+    WorkerPool(size_t initialThreads, size_t maxThreads);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Ajouter une tâche à exécuter
+    void Submit(std::function<void()> task);
+
+    size_t ThreadCount() const;
+
+private:
+    void SpawnWorker();
+    void WorkerLoop();
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<std::function<void()>> m_tasks;
+    std::vector<std::thread> m_threads;
+    size_t m_idleThreads;
+    size_t m_maxThreads;
+    bool m_shutdown;
+};
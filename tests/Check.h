@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdio>
+
+// Vérifications des tests : un échec est signalé avec sa ligne, le test
+// continue. main() retourne TestResult() (0 si tout a réussi).
+inline int& TestFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+inline int TestResult() {
+    if (TestFailures() > 0) fprintf(stderr, "%d vérification(s) en échec\n", TestFailures());
+    return TestFailures() > 0 ? 1 : 0;
+}
+
+#define CHECK(condition)                                                            \
+    do {                                                                            \
+        if (!(condition)) {                                                         \
+            fprintf(stderr, "%s:%d: échec : %s\n", __FILE__, __LINE__, #condition); \
+            TestFailures()++;                                                       \
+        }                                                                           \
+    } while (0)
+
+// Valeurs entières comparées et affichées en cas d'échec
+#define CHECK_EQ(actual, expected)                                                          \
+    do {                                                                                    \
+        long long actualValue = (long long)(actual), expectedValue = (long long)(expected); \
+        if (actualValue != expectedValue) {                                                 \
+            fprintf(stderr, "%s:%d: échec : %s vaut %lld, attendu %lld\n", __FILE__,        \
+                    __LINE__, #actual, actualValue, expectedValue);                         \
+            TestFailures()++;                                                               \
+        }                                                                                   \
+    } while (0)
@@ -0,0 +1,88 @@
+#include "Check.h"
+#include "FramePipeline.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+// Une image publiée juste avant Stop() et jamais prise ne doit pas être
+// cherchée au Start() suivant : l'écran qu'elle montre n'est plus affiché.
+
+namespace {
+
+// Donne `available` images, puis plus rien (source indisponible)
+class CountedSource : public FrameSource {
+public:
+    explicit CountedSource(int available) : m_available(available), m_captured(0) {}
+
+    bool Capture(GrayImage& frame) override {
+        if (m_captured.load() >= m_available) return false;
+        frame.Resize(4, 4);
+        m_captured++;
+        return true;
+    }
+
+    int Captured() const { return m_captured.load(); }
+
+private:
+    const int m_available;
+    std::atomic<int> m_captured;
+};
+
+void WaitFor(const std::function<bool()>& condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void TestStaleFrameDroppedOnRestart() {
+    FramePipeline pipeline;
+
+    // Premier monitoring : la recherche est occupée sur l'image 1 quand
+    // l'image 2 est publiée, puis le monitoring s'arrête
+    CountedSource first(2);
+    std::atomic<bool> inCallback(false);
+    std::atomic<int> firstFrames(0);
+    CHECK(pipeline.Start(first, 0, [&](const CapturedFrame&) {
+        inCallback = true;
+        firstFrames++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }));
+    WaitFor([&]() { return inCallback.load() && first.Captured() == 2; });
+    pipeline.Stop();
+    CHECK_EQ(firstFrames.load(), 1);
+    CHECK_EQ(pipeline.GetStats().skipped, 1);
+
+    // Second monitoring sans nouvelle image : rien à chercher
+    CountedSource second(0);
+    std::atomic<int> secondFrames(0);
+    CHECK(pipeline.Start(second, 0, [&](const CapturedFrame&) { secondFrames++; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    pipeline.Stop();
+    CHECK_EQ(secondFrames.load(), 0);
+}
+
+// Arrêt puis reprise : les images suivantes sont bien traitées
+void TestRestartProcessesNewFrames() {
+    FramePipeline pipeline;
+    CountedSource first(1);
+    std::atomic<int> frames(0);
+    CHECK(pipeline.Start(first, 0, [&](const CapturedFrame&) { frames++; }));
+    WaitFor([&]() { return frames.load() == 1; });
+    pipeline.Stop();
+
+    CountedSource second(1);
+    CHECK(pipeline.Start(second, 0, [&](const CapturedFrame&) { frames++; }));
+    WaitFor([&]() { return frames.load() == 2; });
+    pipeline.Stop();
+    CHECK_EQ(frames.load(), 2);
+}
+
+} // namespace
+
+int main() {
+    TestStaleFrameDroppedOnRestart();
+    TestRestartProcessesNewFrames();
+    return TestResult();
+}
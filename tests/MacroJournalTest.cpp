@@ -0,0 +1,170 @@
+#include "Check.h"
+#include "MacroJournal.h"
+#include "MacroManager.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+// Rejeu du journal après un arrêt brutal : le journal n'est jamais fermé
+// proprement, on recharge macros.json puis on rouvre le journal comme au
+// démarrage de l'application.
+
+namespace {
+
+const wchar_t* JSON_PATH = L"MacroJournalTest.json";
+const wchar_t* JOURNAL_PATH = L"MacroJournalTest.journal";
+
+void RemoveFiles() {
+    std::remove("MacroJournalTest.json");
+    std::remove("MacroJournalTest.journal");
+}
+
+BasicMacro Macro(const std::wstring& name) {
+    BasicMacro m = {};
+    m.name = name;
+    m.hotkey = L"F1";
+    m.actions.push_back(L"Press Q");
+    m.enabled = true;
+    m.overloadPolicy = OverloadPolicy::DropNew;
+    m.queueLimit = 1;
+    return m;
+}
+
+// État relu au redémarrage : JSON puis journal
+MacroManager Restart(size_t& replayed) {
+    MacroManager macros;
+    macros.LoadFromFile(JSON_PATH);
+    MacroJournal journal;
+    replayed = journal.Open(JOURNAL_PATH, macros);
+    return macros;
+}
+
+// Arrêt avant toute compaction : tout le journal est rejoué
+void TestReplayAfterCrash() {
+    RemoveFiles();
+    MacroManager macros;
+    macros.basicMacros.push_back(Macro(L"A"));
+    CHECK(macros.SaveToFile(JSON_PATH));
+    {
+        MacroJournal journal;
+        CHECK_EQ(journal.Open(JOURNAL_PATH, macros), 0);
+        CHECK(journal.AppendAdd(Macro(L"B")));
+        CHECK(journal.AppendSetEnabled(MacroKind::Basic, 0, false));
+        CHECK(journal.AppendAdd(Macro(L"C")));
+        CHECK(journal.AppendDelete(MacroKind::Basic, 1));
+    }
+
+    size_t replayed = 0;
+    MacroManager reloaded = Restart(replayed);
+    CHECK_EQ(replayed, 4);
+    CHECK_EQ(reloaded.basicMacros.size(), 2);
+    if (reloaded.basicMacros.size() == 2) {
+        CHECK(reloaded.basicMacros[0].name == L"A");
+        CHECK(!reloaded.basicMacros[0].enabled);
+        CHECK(reloaded.basicMacros[1].name == L"C");
+    }
+
+    // Un second redémarrage retrouve le même état
+    reloaded = Restart(replayed);
+    CHECK_EQ(replayed, 4);
+    CHECK_EQ(reloaded.basicMacros.size(), 2);
+}
+
+// Arrêt entre l'écriture du JSON compacté et Rebase : les enregistrements
+// déjà inclus dans le JSON ne sont pas rejoués une seconde fois
+void TestCrashBeforeRebase() {
+    RemoveFiles();
+    MacroManager macros;
+    CHECK(macros.SaveToFile(JSON_PATH));
+    {
+        MacroJournal journal;
+        journal.Open(JOURNAL_PATH, macros);
+        CHECK(journal.AppendAdd(Macro(L"A")));
+        CHECK(journal.AppendAdd(Macro(L"B")));
+        CHECK(journal.AppendAdd(Macro(L"C")));
+
+        // JSON à jour jusqu'à la séquence 2, journal laissé tel quel
+        MacroManager compacted;
+        compacted.basicMacros.push_back(Macro(L"A"));
+        compacted.basicMacros.push_back(Macro(L"B"));
+        compacted.journalSequence = 2;
+        CHECK(compacted.SaveToFile(JSON_PATH));
+    }
+
+    size_t replayed = 0;
+    MacroManager reloaded = Restart(replayed);
+    CHECK_EQ(reloaded.journalSequence, 2);
+    CHECK_EQ(replayed, 1);
+    CHECK_EQ(reloaded.basicMacros.size(), 3);
+    if (reloaded.basicMacros.size() == 3) CHECK(reloaded.basicMacros[2].name == L"C");
+
+    // Le journal réécrit ne garde que la séquence 3, et continue après elle
+    MacroJournal journal;
+    MacroManager again;
+    again.LoadFromFile(JSON_PATH);
+    CHECK_EQ(journal.Open(JOURNAL_PATH, again), 1);
+    CHECK_EQ(journal.RecordCount(), 1);
+    CHECK(journal.AppendAdd(Macro(L"D")));
+    CHECK_EQ(journal.LastSequence(), 4);
+}
+
+// Fin de fichier tronquée au milieu d'un enregistrement : ignorée
+void TestTruncatedTail() {
+    RemoveFiles();
+    MacroManager macros;
+    CHECK(macros.SaveToFile(JSON_PATH));
+    {
+        MacroJournal journal;
+        journal.Open(JOURNAL_PATH, macros);
+        CHECK(journal.AppendAdd(Macro(L"A")));
+        CHECK(journal.AppendAdd(Macro(L"B")));
+    }
+
+    std::string bytes;
+    {
+        std::ifstream in("MacroJournalTest.journal", std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    CHECK(bytes.size() > 5);
+    {
+        std::ofstream out("MacroJournalTest.journal", std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), (std::streamsize)(bytes.size() - 5));
+    }
+
+    size_t replayed = 0;
+    MacroManager reloaded = Restart(replayed);
+    CHECK_EQ(replayed, 1);
+    CHECK_EQ(reloaded.basicMacros.size(), 1);
+}
+
+// JSON plus ancien que le journal (séquences manquantes) : rien n'est rejoué
+// plutôt que d'appliquer des modifications à des index qui ne correspondent plus
+void TestGapStopsReplay() {
+    RemoveFiles();
+    MacroManager macros;
+    CHECK(macros.SaveToFile(JSON_PATH));
+    {
+        MacroJournal journal;
+        journal.Open(JOURNAL_PATH, macros);
+        CHECK(journal.AppendAdd(Macro(L"A")));
+        CHECK(journal.AppendAdd(Macro(L"B")));
+        CHECK(journal.Rebase(2));   // Compaction faite, JSON de la séquence 2 perdu
+        CHECK(journal.AppendSetEnabled(MacroKind::Basic, 1, false));
+    }
+
+    size_t replayed = 0;
+    MacroManager reloaded = Restart(replayed);
+    CHECK_EQ(replayed, 0);
+    CHECK_EQ(reloaded.basicMacros.size(), 0);
+}
+
+} // namespace
+
+int main() {
+    TestReplayAfterCrash();
+    TestCrashBeforeRebase();
+    TestTruncatedTail();
+    TestGapStopsReplay();
+    RemoveFiles();
+    return TestResult();
+}
@@ -0,0 +1,80 @@
+#include "Check.h"
+#include "MacroManager.h"
+#include <climits>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+// Chargement de macros.json : un JSON valide qui ne suit pas le schéma (édité
+// à la main) est lu sans planter, ce qui est reconnu est gardé.
+
+namespace {
+
+const char* PATH = "MacroManagerTest.json";
+
+bool Load(const std::string& json, MacroManager& macros) {
+    {
+        std::ofstream out(PATH, std::ios::binary | std::ios::trunc);
+        out << json;
+    }
+    return macros.LoadFromFile(L"MacroManagerTest.json");
+}
+
+// Tableau à la place d'une macro, dans une section qui suit une autre section
+void TestArrayInsteadOfMacro() {
+    const char* inputs[] = {
+        "{\"basicMacros\":[{\"queueLimit\":1}],\"comboMacros\":[[7]]}",
+        "{\"basicMacros\":[{\"enabled\":true}],\"imageMacros\":[[true]]}",
+        "{\"basicMacros\":[{\"name\":\"A\"}],\"comboMacros\":[[\"x\",[\"y\"]]]}",
+        "{\"basicMacros\":[{\"actions\":[\"Press Q\"]}],\"comboMacros\":[[[\"Press W\"]]]}",
+        "{\"imageMacros\":[[{\"confidence\":50}]],\"comboMacros\":[7,\"x\",true]}",
+    };
+    for (const char* input : inputs) {
+        MacroManager macros;
+        Load(input, macros);
+        CHECK(macros.basicMacros.size() <= 1);
+        CHECK(macros.imageMacros.empty());
+        CHECK(macros.comboMacros.empty());
+    }
+
+    MacroManager macros;
+    Load("{\"basicMacros\":[{\"queueLimit\":3}],\"comboMacros\":[[7],{\"queueLimit\":2}]}", macros);
+    CHECK_EQ(macros.basicMacros.size(), 1);
+    CHECK_EQ(macros.comboMacros.size(), 1);
+    if (macros.basicMacros.size() == 1) CHECK_EQ(macros.basicMacros[0].queueLimit, 3);
+    if (macros.comboMacros.size() == 1) CHECK_EQ(macros.comboMacros[0].queueLimit, 2);
+}
+
+// Nombres hors des bornes d'un int : ramenés dans les bornes
+void TestOutOfRangeNumbers() {
+    MacroManager macros;
+    Load("{\"journalSequence\":1e300,\"basicMacros\":[{\"queueLimit\":1e300}],"
+         "\"comboMacros\":[{\"delayBetween\":-1e300}]}", macros);
+    CHECK_EQ(macros.journalSequence, 0);
+    CHECK_EQ(macros.basicMacros.size(), 1);
+    CHECK_EQ(macros.comboMacros.size(), 1);
+    if (macros.basicMacros.size() == 1) CHECK_EQ(macros.basicMacros[0].queueLimit, INT_MAX);
+    if (macros.comboMacros.size() == 1) CHECK_EQ(macros.comboMacros[0].delayBetween, INT_MIN);
+}
+
+// Tableau imbriqué dans une liste d'actions : la liste continue après lui
+void TestNestedArrayInList() {
+    MacroManager macros;
+    Load("{\"basicMacros\":[{\"actions\":[\"Press Q\",[\"x\",[1]],\"Press W\"],\"name\":\"A\"}]}", macros);
+    CHECK_EQ(macros.basicMacros.size(), 1);
+    if (macros.basicMacros.size() == 1) {
+        CHECK_EQ(macros.basicMacros[0].actions.size(), 2);
+        if (macros.basicMacros[0].actions.size() == 2) CHECK(macros.basicMacros[0].actions[1] == L"Press W");
+        CHECK(macros.basicMacros[0].name == L"A");
+    }
+}
+
+} // namespace
+
+int main() {
+    TestArrayInsteadOfMacro();
+    TestOutOfRangeNumbers();
+    TestNestedArrayInList();
+    std::remove(PATH);
+    return TestResult();
+}
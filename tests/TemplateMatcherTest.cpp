@@ -0,0 +1,182 @@
+#include "Check.h"
+#include "GrayImage.h"
+#include "TemplateMatcher.h"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Les noyaux SSE2 et AVX2 doivent donner exactement les scores du noyau
+// scalaire (calcul entier), pour toutes les largeurs de modèle : fins de ligne
+// hors des blocs SIMD, petits modèles corrélés par blocs de positions.
+
+namespace {
+
+typedef TemplateMatcher::Kernel Kernel;
+
+uint32_t g_seed = 12345;
+
+uint8_t NextByte() {
+    g_seed = g_seed * 1664525u + 1013904223u;
+    return (uint8_t)(g_seed >> 24);
+}
+
+// Bruit lissé horizontalement : des zones de contraste variable, pas seulement du bruit pur
+GrayImage RandomImage(int width, int height) {
+    GrayImage image;
+    image.Resize(width, height);
+    for (int y = 0; y < height; y++) {
+        uint8_t* row = image.Row(y);
+        int value = NextByte();
+        for (int x = 0; x < width; x++) {
+            value = (value * 3 + NextByte()) / 4;
+            row[x] = (uint8_t)value;
+        }
+    }
+    return image;
+}
+
+GrayImage Crop(const GrayImage& image, int x, int y, int width, int height) {
+    GrayImage crop;
+    crop.Resize(width, height);
+    for (int row = 0; row < height; row++) {
+        for (int column = 0; column < width; column++) crop.Row(row)[column] = image.Row(y + row)[x + column];
+    }
+    return crop;
+}
+
+// NCC de référence, en double, sur les pixels bruts
+double ReferenceScore(const GrayImage& image, const GrayImage& pattern, int x, int y) {
+    const double count = (double)pattern.width * pattern.height;
+    double sumI = 0, sumT = 0;
+    for (int row = 0; row < pattern.height; row++) {
+        for (int column = 0; column < pattern.width; column++) {
+            sumI += image.Row(y + row)[x + column];
+            sumT += pattern.Row(row)[column];
+        }
+    }
+    const double meanI = sumI / count, meanT = sumT / count;
+    double cov = 0, varI = 0, varT = 0;
+    for (int row = 0; row < pattern.height; row++) {
+        for (int column = 0; column < pattern.width; column++) {
+            const double i = image.Row(y + row)[x + column] - meanI;
+            const double t = pattern.Row(row)[column] - meanT;
+            cov += i * t;
+            varI += i * i;
+            varT += t * t;
+        }
+    }
+    return cov / std::sqrt(varI * varT);
+}
+
+std::vector<Kernel> SupportedKernels() {
+    std::vector<Kernel> kernels;
+    const Kernel all[] = { Kernel::Scalar, Kernel::Sse2, Kernel::Avx2 };
+    for (Kernel kernel : all) {
+        if (TemplateMatcher::IsSupported(kernel)) kernels.push_back(kernel);
+    }
+    return kernels;
+}
+
+bool SameResult(const MatchResult& a, const MatchResult& b) {
+    return a.found == b.found && (!a.found || (a.x == b.x && a.y == b.y && a.score == b.score));
+}
+
+// Scores à un ensemble de positions : identiques d'un noyau à l'autre,
+// avec ou sans tables de sommes, et proches de la référence en double
+void TestScoreParity(const GrayImage& image) {
+    const int widths[] = { 1, 3, 7, 8, 15, 16, 17, 24, 31, 32, 33, 40, 47, 64, 65 };
+    const int heights[] = { 2, 9, 24 };
+    const std::vector<Kernel> kernels = SupportedKernels();
+
+    MatchFrame frame, untabled;
+    frame.Prepare(image);
+    untabled.Prepare(image, false);
+
+    for (int width : widths) {
+        for (int height : heights) {
+            GrayImage pattern = Crop(image, 37, 21, width, height);
+            TemplateMatcher scalar;
+            if (!scalar.SetTemplate(pattern)) continue;     // Modèle uniforme
+
+            for (int y = 0; y + height <= image.height; y += 7) {
+                for (int x = 0; x + width <= image.width; x += 5) {
+                    const float expected = scalar.ScoreAt(frame, x, y);
+                    CHECK(scalar.ScoreAt(untabled, x, y) == expected);
+                    if (expected > -1.0f) CHECK(std::fabs(expected - ReferenceScore(image, pattern, x, y)) < 0.01);
+
+                    for (Kernel kernel : kernels) {
+                        TemplateMatcher matcher;
+                        matcher.SetTemplate(pattern);
+                        matcher.SetKernel(kernel);
+                        if (matcher.ScoreAt(frame, x, y) != expected) {
+                            fprintf(stderr, "%s %dx%d en (%d, %d) : %.7f au lieu de %.7f\n",
+                                    TemplateMatcher::KernelName(kernel), width, height, x, y,
+                                    matcher.ScoreAt(frame, x, y), expected);
+                            TestFailures()++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Recherches complètes (abandon anticipé, blocs de positions) : même résultat
+// pour tous les noyaux, modèle présent ou non
+void TestSearchParity(const GrayImage& image) {
+    const std::vector<Kernel> kernels = SupportedKernels();
+    MatchFrame frame;
+    frame.Prepare(image);
+
+    GrayImage other = RandomImage(80, 60);
+    struct Case { GrayImage pattern; int x, y; };
+    const Case cases[] = {
+        { Crop(image, 101, 57, 5, 4), 101, 57 },
+        { Crop(image, 12, 80, 17, 11), 12, 80 },
+        { Crop(image, 150, 30, 33, 24), 150, 30 },
+        { Crop(image, 200, 100, 64, 40), 200, 100 },
+        { Crop(other, 10, 10, 24, 24), -1, -1 },        // Absent
+    };
+    const float thresholds[] = { 0.5f, 0.85f, 0.99f };
+
+    for (const Case& test : cases) {
+        for (float minScore : thresholds) {
+            TemplateMatcher scalar;
+            CHECK(scalar.SetTemplate(test.pattern));
+            const MatchResult expected = scalar.FindBest(frame, minScore);
+            if (test.x >= 0) {
+                CHECK(expected.found);
+                CHECK_EQ(expected.x, test.x);
+                CHECK_EQ(expected.y, test.y);
+            }
+
+            std::vector<MatchCandidate> expectedCandidates;
+            const MatchRect all = { 0, 0, image.width, image.height };
+            scalar.FindCandidates(frame, all, minScore, 8, expectedCandidates);
+
+            for (Kernel kernel : kernels) {
+                TemplateMatcher matcher;
+                matcher.SetTemplate(test.pattern);
+                matcher.SetKernel(kernel);
+                CHECK(SameResult(matcher.FindBest(frame, minScore), expected));
+
+                std::vector<MatchCandidate> candidates;
+                matcher.FindCandidates(frame, all, minScore, 8, candidates);
+                CHECK_EQ(candidates.size(), expectedCandidates.size());
+                for (size_t i = 0; i < candidates.size() && i < expectedCandidates.size(); i++) {
+                    CHECK(candidates[i].x == expectedCandidates[i].x && candidates[i].y == expectedCandidates[i].y &&
+                          candidates[i].score == expectedCandidates[i].score);
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    const GrayImage image = RandomImage(320, 180);
+    TestScoreParity(image);
+    TestSearchParity(image);
+    return TestResult();
+}
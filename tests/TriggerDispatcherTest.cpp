@@ -0,0 +1,224 @@
+#include "Check.h"
+#include "MacroClock.h"
+#include "MacroExecutor.h"
+#include "MacroManager.h"
+#include "MacroStore.h"
+#include "RecordingInputSink.h"
+#include "TriggerDispatcher.h"
+#include <memory>
+
+// Politiques de surcharge du dispatcher sous horloge de simulation : chaque
+// scénario appuie sur la touche d'une macro "Press Q, Wait 100, Press W" à des
+// instants simulés exacts. Un Q envoyé marque une exécution démarrée, un W une
+// exécution allée jusqu'au bout ; une exécution dure 300 ms (appuis de 50 ms et
+// délais entre actions compris).
+
+namespace {
+
+const uint16_t VK_Q = 0x51;
+const uint16_t VK_W = 0x57;
+
+MacroManager OneMacro(OverloadPolicy policy, int queueLimit = 1) {
+    MacroManager macros;
+    BasicMacro m = {};
+    m.name = L"Surcharge";
+    m.hotkey = L"F1";
+    m.actions.push_back(L"Press Q");
+    m.actions.push_back(L"Wait 100");
+    m.actions.push_back(L"Press W");
+    m.enabled = true;
+    m.overloadPolicy = policy;
+    m.queueLimit = queueLimit;
+    macros.basicMacros.push_back(m);
+    macros.CompileMacros();
+    macros.AssignIds();
+    return macros;
+}
+
+// Même macro (même identifiant), nouvelle politique
+MacroManager Republished(const MacroManager& macros, OverloadPolicy policy, int queueLimit = 1) {
+    MacroManager next = macros;
+    next.basicMacros[0].overloadPolicy = policy;
+    next.basicMacros[0].queueLimit = queueLimit;
+    return next;
+}
+
+class Scenario {
+public:
+    explicit Scenario(const MacroManager& macros)
+        : m_sink(&m_clock)
+        , m_executor(&m_sink, &m_clock)
+        , m_dispatcher(m_executor)
+        , m_start(m_clock.Now())
+    {
+        Publish(macros);
+        m_binding.macroId = macros.basicMacros[0].id;
+        m_binding.holdMode = false;
+        m_dispatcher.Start();
+        m_clock.Attach();
+    }
+
+    void Publish(const MacroManager& macros) { m_dispatcher.Publish(MacroStore::Build(macros)); }
+
+    void At(int ms) { m_clock.SleepUntil(m_start + std::chrono::milliseconds(ms)); }
+
+    void Press(int ms) {
+        At(ms);
+        m_dispatcher.Post(m_binding, true);
+        m_dispatcher.Post(m_binding, false);
+    }
+
+    // Laisser tout se terminer, puis arrêter (pilote détaché, voir VirtualClock)
+    void Finish() {
+        At(10000);
+        m_clock.Detach();
+        m_dispatcher.Stop();
+    }
+
+    size_t KeyDowns(uint16_t vk) const {
+        size_t count = 0;
+        for (const auto& batch : m_sink.GetBatches()) {
+            for (const InputEvent& event : batch.events) {
+                if (event.type == InputEvent::Type::KeyDown && event.vk == vk) count++;
+            }
+        }
+        return count;
+    }
+
+    size_t Started() const { return KeyDowns(VK_Q); }
+    size_t Completed() const { return KeyDowns(VK_W); }
+    TriggerDispatcher::MacroCounters Counters() const { return m_dispatcher.GetMacroCounters(m_binding.macroId); }
+
+private:
+    VirtualClock m_clock;
+    RecordingInputSink m_sink;
+    MacroExecutor m_executor;
+    TriggerDispatcher m_dispatcher;
+    MacroClock::TimePoint m_start;
+    HotkeyBinding m_binding;
+};
+
+void TestDropNew() {
+    Scenario s(OneMacro(OverloadPolicy::DropNew));
+    s.Press(0);
+    s.Press(10);
+    s.Press(20);
+    s.Press(1000);
+    s.Finish();
+    CHECK_EQ(s.Started(), 2);
+    CHECK_EQ(s.Completed(), 2);
+    CHECK_EQ(s.Counters().triggers, 4);
+    CHECK_EQ(s.Counters().dropped, 2);
+}
+
+void TestQueue() {
+    Scenario s(OneMacro(OverloadPolicy::Queue, 2));
+    s.Press(0);
+    s.Press(10);
+    s.Press(20);
+    s.Press(30);     // File pleine
+    s.Finish();
+    CHECK_EQ(s.Started(), 3);
+    CHECK_EQ(s.Completed(), 3);
+    CHECK_EQ(s.Counters().dropped, 1);
+}
+
+void TestCoalesce() {
+    Scenario s(OneMacro(OverloadPolicy::Coalesce));
+    s.Press(0);
+    s.Press(10);
+    s.Press(20);
+    s.Press(30);
+    s.Finish();
+    CHECK_EQ(s.Started(), 2);
+    CHECK_EQ(s.Completed(), 2);
+    CHECK_EQ(s.Counters().coalesced, 2);
+}
+
+void TestRestart() {
+    Scenario s(OneMacro(OverloadPolicy::Restart));
+    s.Press(0);
+    s.Press(50);     // Interrompt la première exécution avant son W
+    s.Finish();
+    CHECK_EQ(s.Started(), 2);
+    CHECK_EQ(s.Completed(), 1);
+    CHECK_EQ(s.Counters().restarted, 1);
+}
+
+// Exécution démarrée en DropNew, macro republiée en Queue pendant qu'elle
+// tourne : l'attente doit partir à sa fin, et la macro rester déclenchable
+void TestDropNewToQueueMidRun() {
+    MacroManager macros = OneMacro(OverloadPolicy::DropNew);
+    Scenario s(macros);
+    s.Press(0);
+    s.At(10);
+    s.Publish(Republished(macros, OverloadPolicy::Queue, 1));
+    s.Press(20);
+    s.At(800);
+    CHECK_EQ(s.Started(), 2);
+    s.Press(1000);
+    s.Finish();
+    CHECK_EQ(s.Started(), 3);
+    CHECK_EQ(s.Completed(), 3);
+    CHECK_EQ(s.Counters().dropped, 0);
+}
+
+// Même chose vers Coalesce et Restart
+void TestDropNewToOthersMidRun() {
+    const OverloadPolicy policies[] = { OverloadPolicy::Coalesce, OverloadPolicy::Restart };
+    for (OverloadPolicy policy : policies) {
+        MacroManager macros = OneMacro(OverloadPolicy::DropNew);
+        Scenario s(macros);
+        s.Press(0);
+        s.At(10);
+        s.Publish(Republished(macros, policy));
+        s.Press(20);
+        s.Press(1000);
+        s.Finish();
+        CHECK_EQ(s.Started(), 3);
+    }
+}
+
+// Queue republiée en DropNew avec une attente : elle part quand même
+void TestQueueToDropNewKeepsPending() {
+    MacroManager macros = OneMacro(OverloadPolicy::Queue, 1);
+    Scenario s(macros);
+    s.Press(0);
+    s.Press(10);
+    s.At(20);
+    s.Publish(Republished(macros, OverloadPolicy::DropNew));
+    s.Press(30);     // Ignoré
+    s.Press(1000);
+    s.Finish();
+    CHECK_EQ(s.Started(), 3);
+    CHECK_EQ(s.Counters().dropped, 1);
+}
+
+// Macro désactivée pendant qu'elle tourne : exécution arrêtée, attente oubliée
+void TestDisabledMidRun() {
+    MacroManager macros = OneMacro(OverloadPolicy::Queue, 1);
+    Scenario s(macros);
+    s.Press(0);
+    s.Press(10);
+    s.At(20);
+    MacroManager disabled = macros;
+    disabled.basicMacros[0].enabled = false;
+    s.Publish(disabled);
+    s.Finish();
+    CHECK_EQ(s.Started(), 1);
+    CHECK_EQ(s.Completed(), 0);
+}
+
+} // namespace
+
+int main() {
+    TestDropNew();
+    TestQueue();
+    TestCoalesce();
+    TestRestart();
+    TestDropNewToQueueMidRun();
+    TestDropNewToOthersMidRun();
+    TestQueueToDropNewKeepsPending();
+    TestDisabledMidRun();
+    return TestResult();
+}